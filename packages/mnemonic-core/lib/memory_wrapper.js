@@ -2,6 +2,9 @@ const path = require('path');
 const fs = require('fs');
 const yaml = require('js-yaml');
 
+// How often lookup hit counts are logged while the write-ahead log is open
+const USE_COUNT_FLUSH_INTERVAL_MS = 30 * 1000;
+
 /**
  * High-level wrapper for the Brains Memory Engine
  * Provides compatibility with existing JavaScript implementation
@@ -19,6 +22,8 @@ class MemoryWrapper {
     }
     
     this.initialized = false;
+    this.memoryLoaded = false;
+    this.walEnabled = false;
     this.errorCategories = {};
   }
 
@@ -82,53 +87,37 @@ class MemoryWrapper {
 
   /**
    * Load memory data from YAML files
+   * The binary snapshot is mapped first. YAML files newer than it are
+   * imported on top, since stores compacted into the snapshot exist nowhere
+   * else, and a fresh snapshot is written. Finally the write-ahead log is
+   * replayed and opened, after which stores are no longer written to YAML
    * @param {string} projectFile - Path to structured_memory.yaml
    * @param {string} globalFile - Path to global_structured_memory.yaml
+   * @param {string} snapshotFile - Path to the engine snapshot
+   * @param {string} walFile - Path to the engine write-ahead log
    * @returns {boolean} Success status
    */
-  async loadMemoryFromFiles(projectFile = './structured_memory.yaml', globalFile = './global_structured_memory.yaml') {
+  async loadMemoryFromFiles(projectFile = './structured_memory.yaml', globalFile = './global_structured_memory.yaml',
+                            snapshotFile = './structured_memory.snapshot', walFile = './structured_memory.wal') {
     if (!this.initialized) {
       throw new Error('Engine not initialized');
     }
 
     try {
-      let loaded = false;
-
-      // Load project memory
-      if (fs.existsSync(projectFile)) {
-        const projectData = yaml.load(fs.readFileSync(projectFile, 'utf8'));
-        if (projectData && projectData.lessons_learned) {
-          for (const [category, problems] of Object.entries(projectData.lessons_learned)) {
-            const solutions = {};
-            for (const [problem, data] of Object.entries(problems)) {
-              if (data && data.solution) {
-                solutions[problem] = data.solution;
-              }
-            }
-            if (Object.keys(solutions).length > 0) {
-              this.engine.loadSolutions(category, solutions, false);
-              loaded = true;
-            }
-          }
+      let loaded = fs.existsSync(snapshotFile) && this.engine.loadSnapshot(snapshotFile);
+
+      if (!loaded || !this.isSnapshotCurrent(snapshotFile, [projectFile, globalFile])) {
+        const imported = this.importYAML(projectFile, globalFile);
+        if (imported && !this.engine.saveSnapshot(snapshotFile)) {
+          console.warn('Failed to write memory snapshot:', snapshotFile);
         }
+        loaded = loaded || imported;
       }
 
-      // Load global memory
-      if (fs.existsSync(globalFile)) {
-        const globalData = yaml.load(fs.readFileSync(globalFile, 'utf8'));
-        if (globalData && globalData.lessons_learned) {
-          for (const [category, problems] of Object.entries(globalData.lessons_learned)) {
-            const solutions = {};
-            for (const [problem, data] of Object.entries(problems)) {
-              if (data && data.solution) {
-                solutions[problem] = data.solution;
-              }
-            }
-            if (Object.keys(solutions).length > 0) {
-              this.engine.loadSolutions(category, solutions, true);
-              loaded = true;
-            }
-          }
+      if (!this.walEnabled) {
+        this.walEnabled = this.engine.openWriteAheadLog(walFile, snapshotFile);
+        if (this.walEnabled) {
+          this.scheduleUseCountFlush();
         }
       }
 
@@ -139,9 +128,89 @@ class MemoryWrapper {
     }
   }
 
+  /**
+   * Log lookup hit counts periodically and once more on exit
+   * Hits are only counted in memory until flushed, so without this a CLI
+   * run would lose every count it raised
+   */
+  scheduleUseCountFlush() {
+    const flush = () => this.engine.flushUseCounts();
+    this.useCountTimer = setInterval(flush, USE_COUNT_FLUSH_INTERVAL_MS);
+    this.useCountTimer.unref();
+    process.once('exit', flush);
+  }
+
+  /**
+   * Import YAML memory files into the engine
+   * Files are parsed natively when the C++ engine is available, which keeps
+   * created dates and use counts; otherwise they are read with js-yaml.
+   * Solutions the engine already holds are skipped
+   * @param {string} projectFile - Path to structured_memory.yaml
+   * @param {string} globalFile - Path to global_structured_memory.yaml
+   * @returns {boolean} True if any solutions were loaded
+   */
+  importYAML(projectFile, globalFile) {
+    let loaded = false;
+
+    for (const [file, isGlobal] of [[projectFile, false], [globalFile, true]]) {
+      if (!fs.existsSync(file)) {
+        continue;
+      }
+
+      const count = this.engine.loadFromFile(file, isGlobal);
+      loaded = (count === false ? this.importYAMLFile(file, isGlobal) : count > 0) || loaded;
+    }
+
+    return loaded;
+  }
+
+  /**
+   * Import one YAML memory file through js-yaml
+   * @param {string} file - Memory file path
+   * @param {boolean} isGlobal - Whether its solutions are global
+   * @returns {boolean} True if any solutions were loaded
+   */
+  importYAMLFile(file, isGlobal) {
+    let loaded = false;
+
+    const data = yaml.load(fs.readFileSync(file, 'utf8'));
+    if (data && data.lessons_learned) {
+      for (const [category, problems] of Object.entries(data.lessons_learned)) {
+        const solutions = {};
+        for (const [problem, entry] of Object.entries(problems || {})) {
+          if (entry && entry.solution) {
+            solutions[problem] = entry.solution;
+          }
+        }
+        if (Object.keys(solutions).length > 0) {
+          this.engine.loadSolutions(category, solutions, isGlobal);
+          loaded = true;
+        }
+      }
+    }
+
+    return loaded;
+  }
+
+  /**
+   * Check whether a snapshot was written after every source file changed
+   * @param {string} snapshotFile - Path to the engine snapshot
+   * @param {string[]} sourceFiles - YAML files the snapshot was built from
+   * @returns {boolean} True if the snapshot exists and is newer than all sources
+   */
+  isSnapshotCurrent(snapshotFile, sourceFiles) {
+    if (!fs.existsSync(snapshotFile)) {
+      return false;
+    }
+
+    const snapshotTime = fs.statSync(snapshotFile).mtimeMs;
+    return sourceFiles.every(file => !fs.existsSync(file) || fs.statSync(file).mtimeMs < snapshotTime);
+  }
+
   /**
    * Find solution with enhanced API compatible with existing code
-   * Auto-reloads from YAML files to ensure fresh data
+   * Loads YAML memory on first use; near matches are resolved by the engine's
+   * similarity index, so later lookups never touch the disk
    * @param {string} problem - Problem description
    * @param {string} category - Optional category hint
    * @returns {Object|null} Solution result in compatible format for layered retrieval
@@ -152,43 +221,34 @@ class MemoryWrapper {
       this.initializeWithDefaults();
     }
 
-    // Reload memory from files to get latest data
-    this.loadMemoryFromFiles().catch(err => {
-      console.warn('Failed to reload memory files:', err.message);
-    });
-
-    // Try direct YAML search first (more reliable)
-    const yamlResult = this.searchInYAMLFiles(problem, category);
-    if (yamlResult) {
-      // Convert to format expected by layered retrieval
-      return {
-        category: yamlResult.category,
-        solutions: [{
-          problem: problem,
-          solution: yamlResult.solution.content || yamlResult.solution,
-          use_count: yamlResult.solution.use_count || 1,
-          created_date: yamlResult.solution.created_date,
-          source: yamlResult.source
-        }],
-        found: true,
-        confidence: this.calculateMemoryConfidence(yamlResult, yamlResult.matchScore || 1.0)
-      };
+    if (!this.memoryLoaded) {
+      this.memoryLoaded = true;
+      this.loadMemoryFromFiles().catch(err => {
+        console.warn('Failed to load memory files:', err.message);
+      });
     }
 
-    // Try memory engine as fallback
-    const result = this.engine.findSolution(problem, category);
+    const result = this.engine.findSimilarSolution(problem, category);
     if (result) {
+      const solution = {
+        content: result.solution.content || result.solution,
+        created_date: this.toISODate(result.solution.created_date),
+        use_count: result.solution.use_count || 1,
+        source: result.solution.source || 'memory'
+      };
+
+      // Convert to format expected by layered retrieval
       return {
-        category: category || this.categorizeError(problem),
+        category: result.category,
         solutions: [{
-          problem: problem,
-          solution: result.solution.content || result.solution,
-          use_count: 1,
-          created_date: new Date().toISOString(),
-          source: result.solution.source || 'memory'
+          problem: result.problem,
+          solution: solution.content,
+          use_count: solution.use_count,
+          created_date: solution.created_date,
+          source: solution.source
         }],
         found: true,
-        confidence: 0.5
+        confidence: this.calculateMemoryConfidence({ solution, query: problem }, result.score)
       };
     }
 
@@ -200,9 +260,19 @@ class MemoryWrapper {
     };
   }
 
+  /**
+   * Normalise an engine timestamp (epoch seconds or date string) to ISO 8601
+   * @param {string|number} createdDate - Timestamp reported by the engine
+   * @returns {string} ISO date, or the input unchanged if it cannot be parsed
+   */
+  toISODate(createdDate) {
+    const date = /^\d+$/.test(String(createdDate)) ? new Date(Number(createdDate) * 1000) : new Date(createdDate);
+    return isNaN(date.getTime()) ? createdDate : date.toISOString();
+  }
+
   /**
    * Calculate confidence score for memory results with production-grade reliability
-   * @param {Object} yamlResult - YAML search result
+   * @param {Object} yamlResult - Matched solution ({ solution, query })
    * @param {number} matchScore - Match quality score (0.0-1.0, default 1.0 for exact matches)
    * @returns {number} Confidence score (0.5-1.0)
    */
@@ -262,104 +332,9 @@ class MemoryWrapper {
   }
 
   /**
-   * Search directly in YAML files for solutions
-   * @param {string} problem - Problem description
-   * @param {string} category - Optional category hint
-   * @returns {Object|null} Solution result
-   */
-  searchInYAMLFiles(problem, category = '') {
-    const files = ['./structured_memory.yaml', './global_structured_memory.yaml'];
-    
-    for (const fileName of files) {
-      if (!fs.existsSync(fileName)) continue;
-      
-      try {
-        const data = yaml.load(fs.readFileSync(fileName, 'utf8'));
-        if (!data || !data.lessons_learned) continue;
-        
-        // Search in specified category or all categories
-        const categoriesToSearch = category ? [category] : Object.keys(data.lessons_learned);
-        
-        for (const cat of categoriesToSearch) {
-          if (!data.lessons_learned[cat]) continue;
-          
-          for (const [prob, solutionData] of Object.entries(data.lessons_learned[cat])) {
-            // Fuzzy match: get match score instead of boolean
-            const matchScore = this.isMatch(problem, prob);
-            if (matchScore > 0) {
-              return {
-                category: cat,
-                solution: {
-                  content: solutionData.solution,
-                  created_date: solutionData.created_date,
-                  use_count: solutionData.use_count,
-                  source: fileName.includes('global') ? 'global' : 'project'
-                },
-                found: true,
-                source: fileName.includes('global') ? 'global' : 'project',
-                matchScore: matchScore, // Pass match score for confidence calculation
-                query: problem // Include query for debugging
-              };
-            }
-          }
-        }
-      } catch (error) {
-        console.warn(`Failed to search in ${fileName}:`, error.message);
-      }
-    }
-    
-    return null;
-  }
-
-  /**
-   * Calculate match score between search problem and stored problem (fuzzy matching with scoring)
-   * @param {string} searchTerm - What user is searching for
-   * @param {string} storedProblem - Problem stored in memory
-   * @returns {number} Match score (0.0 = no match, 1.0 = exact match, 0.5-0.9 = fuzzy match)
-   */
-  isMatch(searchTerm, storedProblem) {
-    const searchLower = searchTerm.toLowerCase().trim();
-    const storedLower = storedProblem.toLowerCase().trim();
-    
-    // Exact match gets perfect score
-    if (searchLower === storedLower) return 1.0;
-    
-    // Direct substring match gets high score
-    if (searchLower.includes(storedLower) || storedLower.includes(searchLower)) {
-      const longer = Math.max(searchLower.length, storedLower.length);
-      const shorter = Math.min(searchLower.length, storedLower.length);
-      return 0.8 + 0.1 * (shorter / longer); // 0.8-0.9 based on length similarity
-    }
-    
-    // Word overlap scoring (more sophisticated fuzzy matching)
-    const searchWords = searchLower.split(/\s+/).filter(w => w.length > 2);
-    const storedWords = storedLower.split(/\s+/).filter(w => w.length > 2);
-    
-    if (searchWords.length === 0 || storedWords.length === 0) return 0.0;
-    
-    let exactWordMatches = 0;
-    let partialWordMatches = 0;
-    
-    for (const searchWord of searchWords) {
-      if (storedWords.includes(searchWord)) {
-        exactWordMatches++;
-      } else if (storedWords.some(stored => stored.includes(searchWord) || searchWord.includes(stored))) {
-        partialWordMatches++;
-      }
-    }
-    
-    const totalWords = Math.min(searchWords.length, storedWords.length);
-    const wordMatchRatio = (exactWordMatches + partialWordMatches * 0.5) / totalWords;
-    
-    // Require at least 50% word overlap for any match
-    if (wordMatchRatio < 0.5) return 0.0;
-    
-    // Scale word match ratio to fuzzy match score (0.5-0.7 range)
-    return 0.5 + wordMatchRatio * 0.2;
-  }
-
-  /**
-   * Store solution with enhanced metadata and persist to YAML
+   * Store solution with enhanced metadata and persist it
+   * Once the engine's write-ahead log is open the engine owns durability;
+   * until then the solution is written to YAML
    * @param {string} problem - Problem description
    * @param {string} category - Problem category
    * @param {string} solution - Solution content
@@ -374,7 +349,7 @@ class MemoryWrapper {
     // Store in memory engine
     const success = this.engine.storeSolution(problem, category, solution, isGlobal);
     
-    if (success) {
+    if (success && !this.walEnabled) {
       // Persist to YAML file
       this.persistSolutionToYAML(problem, category, solution, isGlobal);
     }
@@ -527,6 +502,7 @@ class MemoryWrapper {
   clear() {
     if (this.initialized) {
       this.engine.clear();
+      this.memoryLoaded = false;
     }
   }
 
@@ -277,7 +277,7 @@ class ApiServer {
         });
       }
 
-      const results = this.bridge.searchMemories(query, {
+      const results = await this.bridge.searchMemoriesAsync(query, {
         category,
         maxResults: maxResults || 10
       });
@@ -365,7 +365,7 @@ class ApiServer {
         });
       }
 
-      const solution = this.bridge.findSolution(problem, category);
+      const solution = await this.bridge.findSolutionAsync(problem, category);
 
       if (!solution) {
         return res.status(404).json({
@@ -420,7 +420,7 @@ class ApiServer {
         });
       }
 
-      const solution = this.bridge.findSolution(problem);
+      const solution = await this.bridge.findSolutionAsync(problem);
 
       if (!solution) {
         return res.status(404).json({
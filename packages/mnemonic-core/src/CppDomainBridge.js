@@ -140,6 +140,36 @@ class CppDomainBridge {
     }
   }
 
+  // Runs the native search on a worker thread so callers on the event loop
+  // are not blocked; falls back to the synchronous call when unavailable
+  async searchMemoriesAsync(query, options = {}) {
+    if (!this.ensureInitialized()) return [];
+    
+    try {
+      const {
+        category = '',
+        maxResults = 10
+      } = options;
+      
+      const resultsJson = typeof this.nativeEngine.searchMemoriesAsync === 'function'
+        ? await this.nativeEngine.searchMemoriesAsync(query, category, maxResults)
+        : this.nativeEngine.searchMemories(query, category, maxResults);
+      const results = JSON.parse(resultsJson);
+      
+      this.emitEvent('SearchCompleted', {
+        query: query.substring(0, 100) + '...',
+        resultsCount: Array.isArray(results) ? results.length : 0,
+        category,
+        timestamp: new Date().toISOString()
+      });
+      
+      return results;
+    } catch (error) {
+      console.error('[CppDomainBridge] Error searching memories:', error);
+      return [];
+    }
+  }
+
   getMemoryEntry(entryId) {
     if (!this.ensureInitialized()) return null;
     
@@ -175,6 +205,20 @@ class CppDomainBridge {
     }
   }
 
+  async findSolutionAsync(problem, category = '') {
+    if (!this.ensureInitialized()) return null;
+    
+    try {
+      const resultJson = typeof this.nativeEngine.findSolutionAsync === 'function'
+        ? await this.nativeEngine.findSolutionAsync(problem, category)
+        : this.nativeEngine.findSolution(problem, category);
+      return JSON.parse(resultJson);
+    } catch (error) {
+      console.error('[CppDomainBridge] Error finding solution:', error);
+      return null;
+    }
+  }
+
   getStatistics() {
     if (!this.ensureInitialized()) return {};
     
@@ -2,6 +2,8 @@
 #include <node_object_wrap.h>
 #include "memory_engine.h"
 #include <v8.h>
+#include <uv.h>
+#include <functional>
 
 namespace brains_addon {
 
@@ -20,6 +22,404 @@ using v8::Value;
 using v8::Boolean;
 using v8::Array;
 using v8::Exception;
+using v8::Global;
+using v8::HandleScope;
+using v8::Promise;
+using v8::NewStringType;
+
+/**
+ * Creates a JS string from text that need not be NUL-terminated, such as an
+ * interned solution view.
+ */
+static Local<String> NewString(Isolate* isolate, std::string_view text) {
+    return String::NewFromUtf8(isolate, text.data(), NewStringType::kNormal,
+                               static_cast<int>(text.size())).ToLocalChecked();
+}
+
+/**
+ * Overrides the thresholds of policy named in a JS object of the form
+ * { recentProjectThresholdDays, ageDifferenceThresholdDays,
+ *   popularityRatioThreshold, globalMaxAgeDays }; absent keys and NaN keep
+ * their value. A popularityRatioThreshold of Infinity switches that rule off.
+ */
+static brains::ConflictPolicy ParseConflictPolicy(Isolate* isolate,
+                                                  Local<Context> context,
+                                                  Local<Value> value,
+                                                  brains::ConflictPolicy policy) {
+    if (!value->IsObject()) return policy;
+    Local<Object> policy_obj = value.As<Object>();
+
+    auto read_days = [&](const char* name, uint32_t& days) {
+        Local<Value> days_val = policy_obj->Get(context,
+            String::NewFromUtf8(isolate, name).ToLocalChecked()).ToLocalChecked();
+        if (days_val->IsNumber()) {
+            double number = days_val->NumberValue(context).FromJust();
+            if (number == number) {
+                days = static_cast<uint32_t>(std::min<double>(std::max(number, 0.0), UINT32_MAX));
+            }
+        }
+    };
+    read_days("recentProjectThresholdDays", policy.recent_project_days);
+    read_days("ageDifferenceThresholdDays", policy.age_difference_days);
+    read_days("globalMaxAgeDays", policy.global_max_age_days);
+
+    Local<Value> ratio = policy_obj->Get(context,
+        String::NewFromUtf8(isolate, "popularityRatioThreshold").ToLocalChecked()).ToLocalChecked();
+    if (ratio->IsNumber()) {
+        double number = ratio->NumberValue(context).FromJust();
+        if (number == number) {
+            policy.popularity_ratio = number;
+        }
+    }
+    return policy;
+}
+
+/**
+ * Builds the ordered category table from a JS object, keeping property order.
+ * Each value is a pattern array, a single pattern string, or an object of the
+ * form { patterns: [...], priority: n, historyCapacity: n, conflictPolicy: {...} }.
+ * A category's conflictPolicy overrides default_policy key by key.
+ */
+static std::vector<brains::CategoryDefinition> ParseCategories(Isolate* isolate,
+                                                              Local<Context> context,
+                                                              Local<Object> categories_obj,
+                                                              const brains::ConflictPolicy& default_policy) {
+    std::vector<brains::CategoryDefinition> categories;
+    Local<Array> category_names = categories_obj->GetPropertyNames(context).ToLocalChecked();
+
+    auto append_patterns = [&](Local<Value> value, std::vector<std::string>& patterns) {
+        if (value->IsString()) {
+            patterns.push_back(*String::Utf8Value(isolate, value));
+        } else if (value->IsArray()) {
+            Local<Array> patterns_array = Local<Array>::Cast(value);
+            for (uint32_t j = 0; j < patterns_array->Length(); j++) {
+                Local<Value> pattern_val = patterns_array->Get(context, j).ToLocalChecked();
+                if (pattern_val->IsString()) {
+                    patterns.push_back(*String::Utf8Value(isolate, pattern_val));
+                }
+            }
+        }
+    };
+
+    for (uint32_t i = 0; i < category_names->Length(); i++) {
+        Local<Value> key = category_names->Get(context, i).ToLocalChecked();
+        Local<Value> value = categories_obj->Get(context, key).ToLocalChecked();
+
+        if (!key->IsString()) continue;
+
+        brains::CategoryDefinition definition;
+        definition.name = *String::Utf8Value(isolate, key);
+
+        if (value->IsObject() && !value->IsArray()) {
+            Local<Object> definition_obj = value.As<Object>();
+            append_patterns(definition_obj->Get(context,
+                String::NewFromUtf8(isolate, "patterns").ToLocalChecked()).ToLocalChecked(), definition.patterns);
+            Local<Value> priority = definition_obj->Get(context,
+                String::NewFromUtf8(isolate, "priority").ToLocalChecked()).ToLocalChecked();
+            if (priority->IsNumber()) {
+                definition.priority = priority->Int32Value(context).FromJust();
+            }
+            Local<Value> history_capacity = definition_obj->Get(context,
+                String::NewFromUtf8(isolate, "historyCapacity").ToLocalChecked()).ToLocalChecked();
+            if (history_capacity->IsNumber()) {
+                definition.history_capacity = history_capacity->Uint32Value(context).FromJust();
+            }
+            Local<Value> conflict_policy = definition_obj->Get(context,
+                String::NewFromUtf8(isolate, "conflictPolicy").ToLocalChecked()).ToLocalChecked();
+            if (conflict_policy->IsObject()) {
+                definition.conflict_policy = ParseConflictPolicy(isolate, context, conflict_policy, default_policy);
+            }
+        } else {
+            append_patterns(value, definition.patterns);
+        }
+
+        categories.push_back(std::move(definition));
+    }
+
+    return categories;
+}
+
+/**
+ * Async lookups convert their results after the worker's EpochGuard has
+ * ended, so the results take their own copy of the solution text.
+ */
+static std::optional<brains::ConflictResult> Detached(std::optional<brains::ConflictResult> result) {
+    if (result) result->detach();
+    return result;
+}
+
+static std::vector<std::optional<brains::ConflictResult>> Detached(
+    std::vector<std::optional<brains::ConflictResult>> results) {
+    for (auto& result : results) {
+        if (result) result->detach();
+    }
+    return results;
+}
+
+static std::unique_ptr<brains::SimilarProblemMatch> Detached(std::unique_ptr<brains::SimilarProblemMatch> match) {
+    if (match) match->result.detach();
+    return match;
+}
+
+/**
+ * Converts a resolved solution into { solution, conflict_resolution, reason }.
+ */
+static Local<Object> ConflictResultToObject(Isolate* isolate,
+                                            Local<Context> context,
+                                            const brains::ConflictResult& result) {
+    Local<Object> result_obj = Object::New(isolate);
+    
+    // Solution object
+    Local<Object> solution_obj = Object::New(isolate);
+    solution_obj->Set(context, String::NewFromUtf8(isolate, "content").ToLocalChecked(),
+                     NewString(isolate, result.solution.content)).FromJust();
+    solution_obj->Set(context, String::NewFromUtf8(isolate, "created_date").ToLocalChecked(),
+                     String::NewFromUtf8(isolate, std::to_string(result.solution.created).c_str()).ToLocalChecked()).FromJust();
+    solution_obj->Set(context, String::NewFromUtf8(isolate, "use_count").ToLocalChecked(),
+                     Number::New(isolate, result.solution.use_count)).FromJust();
+    solution_obj->Set(context, String::NewFromUtf8(isolate, "source").ToLocalChecked(),
+                     String::NewFromUtf8(isolate, brains::sourceName(result.solution.source)).ToLocalChecked()).FromJust();
+
+    result_obj->Set(context, String::NewFromUtf8(isolate, "solution").ToLocalChecked(), solution_obj).FromJust();
+    
+    // Strategy enum to string
+    const char* strategy_name = "";
+    switch (result.strategy) {
+        case brains::ConflictStrategy::RECENT_PROJECT_PRIORITY:
+            strategy_name = "recent_project_priority";
+            break;
+        case brains::ConflictStrategy::NEWER_SOLUTION:
+            strategy_name = "newer_solution";
+            break;
+        case brains::ConflictStrategy::POPULARITY_BASED:
+            strategy_name = "popularity_based";
+            break;
+        case brains::ConflictStrategy::DEFAULT_LOCAL_PREFERENCE:
+            strategy_name = "default_local_preference";
+            break;
+    }
+
+    result_obj->Set(context, String::NewFromUtf8(isolate, "conflict_resolution").ToLocalChecked(),
+                   String::NewFromUtf8(isolate, strategy_name).ToLocalChecked()).FromJust();
+    result_obj->Set(context, String::NewFromUtf8(isolate, "reason").ToLocalChecked(),
+                   String::NewFromUtf8(isolate, result.reason().c_str()).ToLocalChecked()).FromJust();
+
+    return result_obj;
+}
+
+/**
+ * Parses (category, { problem: solution }[, isGlobal]) into engine types.
+ * Throws a JS TypeError and returns false on invalid arguments.
+ */
+static bool ParseLoadSolutionsArgs(const FunctionCallbackInfo<Value>& args,
+                                   Local<Context> context,
+                                   std::string& category,
+                                   std::unordered_map<std::string, std::string>& solutions,
+                                   bool& is_global) {
+    Isolate* isolate = args.GetIsolate();
+
+    if (args.Length() < 2) {
+        isolate->ThrowException(Exception::TypeError(
+            String::NewFromUtf8(isolate, "Expected (category, solutions[, isGlobal])").ToLocalChecked()));
+        return false;
+    }
+
+    category = *String::Utf8Value(isolate, args[0]);
+    is_global = args.Length() > 2 ? args[2]->BooleanValue(isolate) : false;
+
+    if (!args[1]->IsObject()) {
+        isolate->ThrowException(Exception::TypeError(
+            String::NewFromUtf8(isolate, "Solutions must be an object").ToLocalChecked()));
+        return false;
+    }
+
+    Local<Object> solutions_obj = args[1]->ToObject(context).ToLocalChecked();
+    Local<Array> problem_keys = solutions_obj->GetPropertyNames(context).ToLocalChecked();
+
+    for (uint32_t i = 0; i < problem_keys->Length(); i++) {
+        Local<Value> key = problem_keys->Get(context, i).ToLocalChecked();
+        Local<Value> value = solutions_obj->Get(context, key).ToLocalChecked();
+
+        if (!key->IsString() || !value->IsString()) continue;
+
+        solutions[*String::Utf8Value(isolate, key)] = *String::Utf8Value(isolate, value);
+    }
+
+    return true;
+}
+
+/**
+ * Parses (problems[, categories]) for batch lookups. categories may be an
+ * array aligned with problems or one category applied to every problem.
+ * Throws a JS TypeError and returns false on invalid arguments.
+ */
+static bool ParseFindSolutionsArgs(const FunctionCallbackInfo<Value>& args,
+                                   Local<Context> context,
+                                   std::vector<std::string>& problems,
+                                   std::vector<std::string>& categories) {
+    Isolate* isolate = args.GetIsolate();
+
+    if (args.Length() < 1 || !args[0]->IsArray()) {
+        isolate->ThrowException(Exception::TypeError(
+            String::NewFromUtf8(isolate, "Expected (problems[, categories])").ToLocalChecked()));
+        return false;
+    }
+
+    Local<Array> problem_array = args[0].As<Array>();
+    problems.reserve(problem_array->Length());
+    for (uint32_t i = 0; i < problem_array->Length(); i++) {
+        Local<Value> problem = problem_array->Get(context, i).ToLocalChecked();
+        problems.push_back(*String::Utf8Value(isolate, problem));
+    }
+
+    if (args.Length() > 1 && args[1]->IsArray()) {
+        Local<Array> category_array = args[1].As<Array>();
+        categories.reserve(category_array->Length());
+        for (uint32_t i = 0; i < category_array->Length(); i++) {
+            Local<Value> category = category_array->Get(context, i).ToLocalChecked();
+            categories.push_back(category->IsString() ? *String::Utf8Value(isolate, category) : "");
+        }
+    } else if (args.Length() > 1 && args[1]->IsString()) {
+        categories.assign(problems.size(), *String::Utf8Value(isolate, args[1]));
+    }
+
+    return true;
+}
+
+/**
+ * Converts batch lookup results into an array aligned with the input
+ * problems, holding a resolved solution object or null per entry.
+ */
+static Local<Array> ConflictResultsToArray(Isolate* isolate,
+                                           Local<Context> context,
+                                           const std::vector<std::optional<brains::ConflictResult>>& results) {
+    Local<Array> result_array = Array::New(isolate, static_cast<int>(results.size()));
+    for (uint32_t i = 0; i < results.size(); i++) {
+        Local<Value> value = results[i] ? Local<Value>(ConflictResultToObject(isolate, context, *results[i]))
+                                        : Local<Value>(v8::Null(isolate));
+        result_array->Set(context, i, value).FromJust();
+    }
+    return result_array;
+}
+
+/**
+ * Converts a similar-problem match into a resolved solution object extended
+ * with { category, problem, score }.
+ */
+static Local<Object> SimilarMatchToObject(Isolate* isolate,
+                                          Local<Context> context,
+                                          const brains::SimilarProblemMatch& match) {
+    Local<Object> result_obj = ConflictResultToObject(isolate, context, match.result);
+    result_obj->Set(context, String::NewFromUtf8(isolate, "category").ToLocalChecked(),
+                   String::NewFromUtf8(isolate, match.category.c_str()).ToLocalChecked()).FromJust();
+    result_obj->Set(context, String::NewFromUtf8(isolate, "problem").ToLocalChecked(),
+                   String::NewFromUtf8(isolate, match.problem.c_str()).ToLocalChecked()).FromJust();
+    result_obj->Set(context, String::NewFromUtf8(isolate, "score").ToLocalChecked(),
+                   Number::New(isolate, match.score)).FromJust();
+    return result_obj;
+}
+
+/**
+ * Converts an enhanced-engine lookup into { found, solution: { content, source } }.
+ */
+static Local<Object> EnhancedResultToObject(Isolate* isolate,
+                                            Local<Context> context,
+                                            const brains::ConflictResult* result) {
+    Local<Object> result_obj = Object::New(isolate);
+
+    if (result) {
+        Local<Object> solution_obj = Object::New(isolate);
+        
+        solution_obj->Set(context, String::NewFromUtf8(isolate, "content").ToLocalChecked(),
+                         NewString(isolate, result->solution.content)).FromJust();
+        solution_obj->Set(context, String::NewFromUtf8(isolate, "source").ToLocalChecked(),
+                         String::NewFromUtf8(isolate, brains::sourceName(result->solution.source)).ToLocalChecked()).FromJust();
+        
+        result_obj->Set(context, String::NewFromUtf8(isolate, "solution").ToLocalChecked(), solution_obj).FromJust();
+    }
+    result_obj->Set(context, String::NewFromUtf8(isolate, "found").ToLocalChecked(),
+                   Boolean::New(isolate, result != nullptr)).FromJust();
+
+    return result_obj;
+}
+
+/**
+ * Runs engine work on the libuv thread pool and settles a Promise with the
+ * converted result back on the JS thread. The work function must not touch
+ * V8; the wrapper object is kept alive until the Promise settles.
+ */
+template<typename Result>
+class AsyncTask {
+public:
+    using Work = std::function<Result()>;
+    using Convert = std::function<Local<Value>(Isolate*, Local<Context>, Result&)>;
+
+    static Local<Promise> Queue(const FunctionCallbackInfo<Value>& args, Work work, Convert convert) {
+        Isolate* isolate = args.GetIsolate();
+        Local<Context> context = isolate->GetCurrentContext();
+        Local<Promise::Resolver> resolver = Promise::Resolver::New(context).ToLocalChecked();
+
+        auto* task = new AsyncTask(isolate, context, resolver, args.Holder(), std::move(work), std::move(convert));
+        uv_queue_work(node::GetCurrentEventLoop(isolate), &task->request, Execute, Complete);
+        return resolver->GetPromise();
+    }
+
+private:
+    uv_work_t request;
+    Isolate* isolate;
+    Global<Context> context;
+    Global<Promise::Resolver> resolver;
+    Global<Object> holder;
+    node::async_context async_context;
+    Work work;
+    Convert convert;
+    Result result{};
+    std::string error;
+
+    AsyncTask(Isolate* isolate, Local<Context> context, Local<Promise::Resolver> resolver,
+              Local<Object> holder, Work work, Convert convert)
+        : isolate(isolate), context(isolate, context), resolver(isolate, resolver), holder(isolate, holder),
+          async_context(node::EmitAsyncInit(isolate, holder, "BrainsMemoryEngineTask")),
+          work(std::move(work)), convert(std::move(convert)) {
+        request.data = this;
+    }
+
+    static void Execute(uv_work_t* request) {
+        auto* task = static_cast<AsyncTask*>(request->data);
+        try {
+            task->result = task->work();
+        } catch (const std::exception& e) {
+            task->error = e.what();
+        }
+    }
+
+    static void Complete(uv_work_t* request, int status) {
+        std::unique_ptr<AsyncTask> task(static_cast<AsyncTask*>(request->data));
+        Isolate* isolate = task->isolate;
+        HandleScope scope(isolate);
+        Local<Context> context = task->context.Get(isolate);
+        Context::Scope context_scope(context);
+        Local<Object> holder = task->holder.Get(isolate);
+
+        {
+            // Drains microtasks on exit so awaiting callers resume promptly
+            node::CallbackScope callback_scope(isolate, holder, task->async_context);
+            Local<Promise::Resolver> resolver = task->resolver.Get(isolate);
+
+            if (status == UV_ECANCELED) {
+                task->error = "Operation cancelled";
+            }
+            if (!task->error.empty()) {
+                resolver->Reject(context, Exception::Error(
+                    String::NewFromUtf8(isolate, task->error.c_str()).ToLocalChecked())).FromJust();
+            } else {
+                resolver->Resolve(context, task->convert(isolate, context, task->result)).FromJust();
+            }
+        }
+
+        node::EmitAsyncDestroy(isolate, task->async_context);
+    }
+};
 
 class MemoryEngineWrapper : public node::ObjectWrap {
 public:
@@ -33,10 +433,25 @@ private:
     static void Initialize(const FunctionCallbackInfo<Value>& args);
     static void StoreSolution(const FunctionCallbackInfo<Value>& args);
     static void FindSolution(const FunctionCallbackInfo<Value>& args);
+    static void FindSolutions(const FunctionCallbackInfo<Value>& args);
+    static void FindSimilarSolution(const FunctionCallbackInfo<Value>& args);
     static void CategorizeError(const FunctionCallbackInfo<Value>& args);
     static void GetStatistics(const FunctionCallbackInfo<Value>& args);
     static void Clear(const FunctionCallbackInfo<Value>& args);
     static void LoadSolutions(const FunctionCallbackInfo<Value>& args);
+    static void SaveSnapshot(const FunctionCallbackInfo<Value>& args);
+    static void LoadSnapshot(const FunctionCallbackInfo<Value>& args);
+    static void OpenWriteAheadLog(const FunctionCallbackInfo<Value>& args);
+    static void Compact(const FunctionCallbackInfo<Value>& args);
+    static void FlushUseCounts(const FunctionCallbackInfo<Value>& args);
+    static void LoadFromFile(const FunctionCallbackInfo<Value>& args);
+
+    // Promise-returning variants that run on the libuv thread pool
+    static void StoreSolutionAsync(const FunctionCallbackInfo<Value>& args);
+    static void FindSolutionAsync(const FunctionCallbackInfo<Value>& args);
+    static void FindSolutionsAsync(const FunctionCallbackInfo<Value>& args);
+    static void FindSimilarSolutionAsync(const FunctionCallbackInfo<Value>& args);
+    static void LoadSolutionsAsync(const FunctionCallbackInfo<Value>& args);
 
     static Persistent<Function> constructor;
     brains::MemoryEngine* engine_;
@@ -60,6 +475,10 @@ private:
     static void GetStatistics(const FunctionCallbackInfo<Value>& args);
     static void Clear(const FunctionCallbackInfo<Value>& args);
 
+    // Promise-returning variants that run on the libuv thread pool
+    static void StoreSolutionAsync(const FunctionCallbackInfo<Value>& args);
+    static void FindSolutionAsync(const FunctionCallbackInfo<Value>& args);
+
     static Persistent<Function> constructor;
     brains::EnhancedMemoryEngine* engine_;
 };
@@ -86,10 +505,23 @@ void MemoryEngineWrapper::Init(Local<Object> exports) {
     NODE_SET_PROTOTYPE_METHOD(tpl, "initialize", Initialize);
     NODE_SET_PROTOTYPE_METHOD(tpl, "storeSolution", StoreSolution);
     NODE_SET_PROTOTYPE_METHOD(tpl, "findSolution", FindSolution);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "findSolutions", FindSolutions);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "findSimilarSolution", FindSimilarSolution);
     NODE_SET_PROTOTYPE_METHOD(tpl, "categorizeError", CategorizeError);
     NODE_SET_PROTOTYPE_METHOD(tpl, "getStatistics", GetStatistics);
     NODE_SET_PROTOTYPE_METHOD(tpl, "clear", Clear);
     NODE_SET_PROTOTYPE_METHOD(tpl, "loadSolutions", LoadSolutions);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "saveSnapshot", SaveSnapshot);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "loadSnapshot", LoadSnapshot);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "openWriteAheadLog", OpenWriteAheadLog);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "compact", Compact);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "flushUseCounts", FlushUseCounts);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "loadFromFile", LoadFromFile);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "storeSolutionAsync", StoreSolutionAsync);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "findSolutionAsync", FindSolutionAsync);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "findSolutionsAsync", FindSolutionsAsync);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "findSimilarSolutionAsync", FindSimilarSolutionAsync);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "loadSolutionsAsync", LoadSolutionsAsync);
 
     Local<Function> constructor_local = tpl->GetFunction(context).ToLocalChecked();
     constructor.Reset(isolate, constructor_local);
@@ -126,32 +558,18 @@ void MemoryEngineWrapper::Initialize(const FunctionCallbackInfo<Value>& args) {
         return;
     }
 
-    Local<Object> categories_obj = args[0]->ToObject(context).ToLocalChecked();
-    Local<Array> category_names = categories_obj->GetPropertyNames(context).ToLocalChecked();
-
-    std::unordered_map<std::string, std::vector<std::string>> categories;
-
-    for (uint32_t i = 0; i < category_names->Length(); i++) {
-        Local<Value> key = category_names->Get(context, i).ToLocalChecked();
-        Local<Value> value = categories_obj->Get(context, key).ToLocalChecked();
-
-        if (!key->IsString() || !value->IsArray()) continue;
-
-        std::string category_name = *String::Utf8Value(isolate, key);
-        Local<Array> patterns_array = Local<Array>::Cast(value);
-
-        std::vector<std::string> patterns;
-        for (uint32_t j = 0; j < patterns_array->Length(); j++) {
-            Local<Value> pattern_val = patterns_array->Get(context, j).ToLocalChecked();
-            if (pattern_val->IsString()) {
-                patterns.push_back(*String::Utf8Value(isolate, pattern_val));
-            }
-        }
-
-        categories[category_name] = patterns;
+    // Optional second argument: { conflictPolicy: {...} } applying to every category
+    brains::ConflictPolicy default_policy;
+    if (args.Length() > 1 && args[1]->IsObject()) {
+        Local<Value> conflict_policy = args[1].As<Object>()->Get(context,
+            String::NewFromUtf8(isolate, "conflictPolicy").ToLocalChecked()).ToLocalChecked();
+        default_policy = ParseConflictPolicy(isolate, context, conflict_policy, default_policy);
     }
 
-    bool success = obj->engine_->initialize(categories);
+    Local<Object> categories_obj = args[0]->ToObject(context).ToLocalChecked();
+    auto categories = ParseCategories(isolate, context, categories_obj, default_policy);
+
+    bool success = obj->engine_->initialize(categories, default_policy);
     args.GetReturnValue().Set(Boolean::New(isolate, success));
 }
 
@@ -190,6 +608,7 @@ void MemoryEngineWrapper::FindSolution(const FunctionCallbackInfo<Value>& args)
     std::string problem = *String::Utf8Value(isolate, args[0]);
     std::string category = args.Length() > 1 ? *String::Utf8Value(isolate, args[1]) : "";
 
+    brains::EpochGuard guard; // Keeps the result text alive until it is converted
     auto result = obj->engine_->findSolution(problem, category);
 
     if (!result) {
@@ -197,44 +616,51 @@ void MemoryEngineWrapper::FindSolution(const FunctionCallbackInfo<Value>& args)
         return;
     }
 
-    Local<Object> result_obj = Object::New(isolate);
-    
-    // Solution object
-    Local<Object> solution_obj = Object::New(isolate);
-    solution_obj->Set(context, String::NewFromUtf8(isolate, "content").ToLocalChecked(),
-                     String::NewFromUtf8(isolate, result->solution.content.c_str()).ToLocalChecked()).FromJust();
-    solution_obj->Set(context, String::NewFromUtf8(isolate, "created_date").ToLocalChecked(),
-                     String::NewFromUtf8(isolate, result->solution.created_date.c_str()).ToLocalChecked()).FromJust();
-    solution_obj->Set(context, String::NewFromUtf8(isolate, "use_count").ToLocalChecked(),
-                     Number::New(isolate, result->solution.use_count)).FromJust();
-    solution_obj->Set(context, String::NewFromUtf8(isolate, "source").ToLocalChecked(),
-                     String::NewFromUtf8(isolate, result->solution.source.c_str()).ToLocalChecked()).FromJust();
+    args.GetReturnValue().Set(ConflictResultToObject(isolate, context, *result));
+}
 
-    result_obj->Set(context, String::NewFromUtf8(isolate, "solution").ToLocalChecked(), solution_obj).FromJust();
-    
-    // Strategy enum to string
-    std::string strategy_name;
-    switch (result->strategy) {
-        case brains::ConflictStrategy::RECENT_PROJECT_PRIORITY:
-            strategy_name = "recent_project_priority";
-            break;
-        case brains::ConflictStrategy::NEWER_SOLUTION:
-            strategy_name = "newer_solution";
-            break;
-        case brains::ConflictStrategy::POPULARITY_BASED:
-            strategy_name = "popularity_based";
-            break;
-        case brains::ConflictStrategy::DEFAULT_LOCAL_PREFERENCE:
-            strategy_name = "default_local_preference";
-            break;
+void MemoryEngineWrapper::FindSolutions(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
+    Local<Context> context = isolate->GetCurrentContext();
+
+    MemoryEngineWrapper* obj = ObjectWrap::Unwrap<MemoryEngineWrapper>(args.Holder());
+
+    std::vector<std::string> problems;
+    std::vector<std::string> categories;
+    if (!ParseFindSolutionsArgs(args, context, problems, categories)) {
+        return;
     }
 
-    result_obj->Set(context, String::NewFromUtf8(isolate, "conflict_resolution").ToLocalChecked(),
-                   String::NewFromUtf8(isolate, strategy_name.c_str()).ToLocalChecked()).FromJust();
-    result_obj->Set(context, String::NewFromUtf8(isolate, "reason").ToLocalChecked(),
-                   String::NewFromUtf8(isolate, result->reason.c_str()).ToLocalChecked()).FromJust();
+    brains::EpochGuard guard; // Keeps the result text alive until it is converted
+    auto results = obj->engine_->findSolutions(problems, categories);
+    args.GetReturnValue().Set(ConflictResultsToArray(isolate, context, results));
+}
+
+void MemoryEngineWrapper::FindSimilarSolution(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
+    Local<Context> context = isolate->GetCurrentContext();
+
+    MemoryEngineWrapper* obj = ObjectWrap::Unwrap<MemoryEngineWrapper>(args.Holder());
 
-    args.GetReturnValue().Set(result_obj);
+    if (args.Length() < 1) {
+        isolate->ThrowException(Exception::TypeError(
+            String::NewFromUtf8(isolate, "Expected (problem[, category[, minScore]])").ToLocalChecked()));
+        return;
+    }
+
+    std::string problem = *String::Utf8Value(isolate, args[0]);
+    std::string category = args.Length() > 1 && args[1]->IsString() ? *String::Utf8Value(isolate, args[1]) : "";
+    double min_score = args.Length() > 2 && args[2]->IsNumber() ? args[2]->NumberValue(context).FromJust() : 0.5;
+
+    brains::EpochGuard guard; // Keeps the result text alive until it is converted
+    auto match = obj->engine_->findSimilarSolution(problem, category, min_score);
+
+    if (!match) {
+        args.GetReturnValue().Set(v8::Null(isolate));
+        return;
+    }
+
+    args.GetReturnValue().Set(SimilarMatchToObject(isolate, context, *match));
 }
 
 void MemoryEngineWrapper::CategorizeError(const FunctionCallbackInfo<Value>& args) {
@@ -274,39 +700,242 @@ void MemoryEngineWrapper::LoadSolutions(const FunctionCallbackInfo<Value>& args)
 
     MemoryEngineWrapper* obj = ObjectWrap::Unwrap<MemoryEngineWrapper>(args.Holder());
 
-    if (args.Length() < 2) {
+    std::string category;
+    std::unordered_map<std::string, std::string> solutions;
+    bool is_global;
+    if (!ParseLoadSolutionsArgs(args, context, category, solutions, is_global)) {
+        return;
+    }
+
+    obj->engine_->loadSolutions(category, solutions, is_global);
+}
+
+void MemoryEngineWrapper::SaveSnapshot(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
+
+    MemoryEngineWrapper* obj = ObjectWrap::Unwrap<MemoryEngineWrapper>(args.Holder());
+
+    if (args.Length() < 1 || !args[0]->IsString()) {
         isolate->ThrowException(Exception::TypeError(
-            String::NewFromUtf8(isolate, "Expected (category, solutions[, isGlobal])").ToLocalChecked()));
+            String::NewFromUtf8(isolate, "Expected (path)").ToLocalChecked()));
         return;
     }
 
-    std::string category = *String::Utf8Value(isolate, args[0]);
-    bool is_global = args.Length() > 2 ? args[2]->BooleanValue(isolate) : false;
+    std::string path = *String::Utf8Value(isolate, args[0]);
+    args.GetReturnValue().Set(Boolean::New(isolate, obj->engine_->saveSnapshot(path)));
+}
 
-    if (!args[1]->IsObject()) {
+void MemoryEngineWrapper::LoadSnapshot(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
+
+    MemoryEngineWrapper* obj = ObjectWrap::Unwrap<MemoryEngineWrapper>(args.Holder());
+
+    if (args.Length() < 1 || !args[0]->IsString()) {
         isolate->ThrowException(Exception::TypeError(
-            String::NewFromUtf8(isolate, "Solutions must be an object").ToLocalChecked()));
+            String::NewFromUtf8(isolate, "Expected (path)").ToLocalChecked()));
         return;
     }
 
-    Local<Object> solutions_obj = args[1]->ToObject(context).ToLocalChecked();
-    Local<Array> problem_keys = solutions_obj->GetPropertyNames(context).ToLocalChecked();
+    std::string path = *String::Utf8Value(isolate, args[0]);
+    args.GetReturnValue().Set(Boolean::New(isolate, obj->engine_->loadSnapshot(path)));
+}
+
+void MemoryEngineWrapper::OpenWriteAheadLog(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
+    Local<Context> context = isolate->GetCurrentContext();
 
-    std::unordered_map<std::string, brains::Solution> solutions;
+    MemoryEngineWrapper* obj = ObjectWrap::Unwrap<MemoryEngineWrapper>(args.Holder());
 
-    for (uint32_t i = 0; i < problem_keys->Length(); i++) {
-        Local<Value> key = problem_keys->Get(context, i).ToLocalChecked();
-        Local<Value> value = solutions_obj->Get(context, key).ToLocalChecked();
+    if (args.Length() < 2 || !args[0]->IsString() || !args[1]->IsString()) {
+        isolate->ThrowException(Exception::TypeError(
+            String::NewFromUtf8(isolate, "Expected (walPath, snapshotPath[, options])").ToLocalChecked()));
+        return;
+    }
 
-        if (!key->IsString() || !value->IsString()) continue;
+    std::string wal_path = *String::Utf8Value(isolate, args[0]);
+    std::string snapshot_path = *String::Utf8Value(isolate, args[1]);
+
+    brains::WalOptions options;
+    if (args.Length() > 2 && args[2]->IsObject()) {
+        Local<Object> options_obj = args[2].As<Object>();
+        auto option = [&](const char* name) {
+            return options_obj->Get(context, String::NewFromUtf8(isolate, name).ToLocalChecked()).ToLocalChecked();
+        };
+
+        Local<Value> sync_commit = option("syncCommit");
+        if (sync_commit->IsBoolean()) {
+            options.sync_commit = sync_commit->BooleanValue(isolate);
+        }
+        Local<Value> flush_interval = option("flushIntervalMs");
+        if (flush_interval->IsNumber()) {
+            options.flush_interval_ms = flush_interval->Uint32Value(context).FromJust();
+        }
+        Local<Value> compact_bytes = option("compactBytes");
+        if (compact_bytes->IsNumber()) {
+            double bytes = compact_bytes->NumberValue(context).FromJust();
+            options.compact_bytes = bytes > 0 ? static_cast<uint64_t>(bytes) : 0;
+        }
+    }
 
-        std::string problem = *String::Utf8Value(isolate, key);
-        std::string solution_content = *String::Utf8Value(isolate, value);
+    args.GetReturnValue().Set(Boolean::New(isolate, obj->engine_->openWriteAheadLog(wal_path, snapshot_path, options)));
+}
+
+void MemoryEngineWrapper::Compact(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
 
-        solutions[problem] = brains::Solution(solution_content, is_global ? "global" : "project");
+    MemoryEngineWrapper* obj = ObjectWrap::Unwrap<MemoryEngineWrapper>(args.Holder());
+    args.GetReturnValue().Set(Boolean::New(isolate, obj->engine_->compact()));
+}
+
+void MemoryEngineWrapper::FlushUseCounts(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
+
+    MemoryEngineWrapper* obj = ObjectWrap::Unwrap<MemoryEngineWrapper>(args.Holder());
+    args.GetReturnValue().Set(Number::New(isolate, static_cast<double>(obj->engine_->flushUseCounts())));
+}
+
+void MemoryEngineWrapper::LoadFromFile(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
+
+    MemoryEngineWrapper* obj = ObjectWrap::Unwrap<MemoryEngineWrapper>(args.Holder());
+
+    if (args.Length() < 1 || !args[0]->IsString()) {
+        isolate->ThrowException(Exception::TypeError(
+            String::NewFromUtf8(isolate, "Expected (path[, isGlobal])").ToLocalChecked()));
+        return;
     }
 
-    obj->engine_->loadSolutions(category, solutions, is_global);
+    std::string path = *String::Utf8Value(isolate, args[0]);
+    bool is_global = args.Length() > 1 ? args[1]->BooleanValue(isolate) : false;
+
+    size_t loaded = 0;
+    std::string error;
+    if (!obj->engine_->loadFromFile(path, is_global, &loaded, &error)) {
+        isolate->ThrowException(Exception::Error(
+            String::NewFromUtf8(isolate, error.c_str()).ToLocalChecked()));
+        return;
+    }
+    args.GetReturnValue().Set(Number::New(isolate, static_cast<double>(loaded)));
+}
+
+void MemoryEngineWrapper::StoreSolutionAsync(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
+
+    MemoryEngineWrapper* obj = ObjectWrap::Unwrap<MemoryEngineWrapper>(args.Holder());
+
+    if (args.Length() < 3) {
+        isolate->ThrowException(Exception::TypeError(
+            String::NewFromUtf8(isolate, "Expected (problem, category, solution[, isGlobal])").ToLocalChecked()));
+        return;
+    }
+
+    std::string problem = *String::Utf8Value(isolate, args[0]);
+    std::string category = *String::Utf8Value(isolate, args[1]);
+    std::string solution = *String::Utf8Value(isolate, args[2]);
+    bool is_global = args.Length() > 3 ? args[3]->BooleanValue(isolate) : false;
+    brains::MemoryEngine* engine = obj->engine_;
+
+    args.GetReturnValue().Set(AsyncTask<bool>::Queue(args,
+        [=] { return engine->storeSolution(problem, category, solution, is_global); },
+        [](Isolate* isolate, Local<Context>, bool& success) -> Local<Value> {
+            return Boolean::New(isolate, success);
+        }));
+}
+
+void MemoryEngineWrapper::FindSolutionAsync(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
+
+    MemoryEngineWrapper* obj = ObjectWrap::Unwrap<MemoryEngineWrapper>(args.Holder());
+
+    if (args.Length() < 1) {
+        isolate->ThrowException(Exception::TypeError(
+            String::NewFromUtf8(isolate, "Expected (problem[, category])").ToLocalChecked()));
+        return;
+    }
+
+    std::string problem = *String::Utf8Value(isolate, args[0]);
+    std::string category = args.Length() > 1 ? *String::Utf8Value(isolate, args[1]) : "";
+    brains::MemoryEngine* engine = obj->engine_;
+
+    using Result = std::optional<brains::ConflictResult>;
+    args.GetReturnValue().Set(AsyncTask<Result>::Queue(args,
+        [=] { return Detached(engine->findSolution(problem, category)); },
+        [](Isolate* isolate, Local<Context> context, Result& result) -> Local<Value> {
+            if (!result) return v8::Null(isolate);
+            return ConflictResultToObject(isolate, context, *result);
+        }));
+}
+
+void MemoryEngineWrapper::FindSolutionsAsync(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
+    Local<Context> context = isolate->GetCurrentContext();
+
+    MemoryEngineWrapper* obj = ObjectWrap::Unwrap<MemoryEngineWrapper>(args.Holder());
+
+    auto problems = std::make_shared<std::vector<std::string>>();
+    auto categories = std::make_shared<std::vector<std::string>>();
+    if (!ParseFindSolutionsArgs(args, context, *problems, *categories)) {
+        return;
+    }
+    brains::MemoryEngine* engine = obj->engine_;
+
+    using Result = std::vector<std::optional<brains::ConflictResult>>;
+    args.GetReturnValue().Set(AsyncTask<Result>::Queue(args,
+        [=] { return Detached(engine->findSolutions(*problems, *categories)); },
+        [](Isolate* isolate, Local<Context> context, Result& results) -> Local<Value> {
+            return ConflictResultsToArray(isolate, context, results);
+        }));
+}
+
+void MemoryEngineWrapper::FindSimilarSolutionAsync(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
+    Local<Context> context = isolate->GetCurrentContext();
+
+    MemoryEngineWrapper* obj = ObjectWrap::Unwrap<MemoryEngineWrapper>(args.Holder());
+
+    if (args.Length() < 1) {
+        isolate->ThrowException(Exception::TypeError(
+            String::NewFromUtf8(isolate, "Expected (problem[, category[, minScore]])").ToLocalChecked()));
+        return;
+    }
+
+    std::string problem = *String::Utf8Value(isolate, args[0]);
+    std::string category = args.Length() > 1 && args[1]->IsString() ? *String::Utf8Value(isolate, args[1]) : "";
+    double min_score = args.Length() > 2 && args[2]->IsNumber() ? args[2]->NumberValue(context).FromJust() : 0.5;
+    brains::MemoryEngine* engine = obj->engine_;
+
+    using Result = std::unique_ptr<brains::SimilarProblemMatch>;
+    args.GetReturnValue().Set(AsyncTask<Result>::Queue(args,
+        [=] { return Detached(engine->findSimilarSolution(problem, category, min_score)); },
+        [](Isolate* isolate, Local<Context> context, Result& match) -> Local<Value> {
+            if (!match) return v8::Null(isolate);
+            return SimilarMatchToObject(isolate, context, *match);
+        }));
+}
+
+void MemoryEngineWrapper::LoadSolutionsAsync(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
+    Local<Context> context = isolate->GetCurrentContext();
+
+    MemoryEngineWrapper* obj = ObjectWrap::Unwrap<MemoryEngineWrapper>(args.Holder());
+
+    // JS values are read here; only the engine insert runs off the main thread
+    std::string category;
+    auto solutions = std::make_shared<std::unordered_map<std::string, std::string>>();
+    bool is_global;
+    if (!ParseLoadSolutionsArgs(args, context, category, *solutions, is_global)) {
+        return;
+    }
+    brains::MemoryEngine* engine = obj->engine_;
+
+    args.GetReturnValue().Set(AsyncTask<size_t>::Queue(args,
+        [=] {
+            engine->loadSolutions(category, *solutions, is_global);
+            return solutions->size();
+        },
+        [](Isolate* isolate, Local<Context>, size_t& loaded) -> Local<Value> {
+            return Number::New(isolate, static_cast<double>(loaded));
+        }));
 }
 
 // EnhancedMemoryEngineWrapper Implementation
@@ -336,6 +965,8 @@ void EnhancedMemoryEngineWrapper::Init(Local<Object> exports) {
     NODE_SET_PROTOTYPE_METHOD(tpl, "categorizeError", CategorizeError);
     NODE_SET_PROTOTYPE_METHOD(tpl, "getStatistics", GetStatistics);
     NODE_SET_PROTOTYPE_METHOD(tpl, "clear", Clear);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "storeSolutionAsync", StoreSolutionAsync);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "findSolutionAsync", FindSolutionAsync);
 
     Local<Function> constructor_func = tpl->GetFunction(context).ToLocalChecked();
     constructor.Reset(isolate, constructor_func);
@@ -369,34 +1000,18 @@ void EnhancedMemoryEngineWrapper::Initialize(const FunctionCallbackInfo<Value>&
         return;
     }
 
-    Local<Object> categories_obj = args[0]->ToObject(context).ToLocalChecked();
-    Local<Array> category_keys = categories_obj->GetPropertyNames(context).ToLocalChecked();
-
-    std::unordered_map<std::string, std::vector<std::string>> categories;
-
-    for (uint32_t i = 0; i < category_keys->Length(); i++) {
-        Local<Value> key = category_keys->Get(context, i).ToLocalChecked();
-        Local<Value> value = categories_obj->Get(context, key).ToLocalChecked();
-
-        if (!key->IsString()) continue;
-
-        std::string category_name = *String::Utf8Value(isolate, key);
-        std::vector<std::string> patterns;
-
-        if (value->IsArray()) {
-            Local<Array> patterns_array = Local<Array>::Cast(value);
-            for (uint32_t j = 0; j < patterns_array->Length(); j++) {
-                Local<Value> pattern = patterns_array->Get(context, j).ToLocalChecked();
-                if (pattern->IsString()) {
-                    patterns.push_back(*String::Utf8Value(isolate, pattern));
-                }
-            }
-        }
-
-        categories[category_name] = patterns;
+    // Optional second argument: { conflictPolicy: {...} } applying to every category
+    brains::ConflictPolicy default_policy;
+    if (args.Length() > 1 && args[1]->IsObject()) {
+        Local<Value> conflict_policy = args[1].As<Object>()->Get(context,
+            String::NewFromUtf8(isolate, "conflictPolicy").ToLocalChecked()).ToLocalChecked();
+        default_policy = ParseConflictPolicy(isolate, context, conflict_policy, default_policy);
     }
 
-    bool success = obj->engine_->initialize(categories);
+    Local<Object> categories_obj = args[0]->ToObject(context).ToLocalChecked();
+    auto categories = ParseCategories(isolate, context, categories_obj, default_policy);
+
+    bool success = obj->engine_->initialize(categories, default_policy);
     args.GetReturnValue().Set(Boolean::New(isolate, success));
 }
 
@@ -417,6 +1032,7 @@ void EnhancedMemoryEngineWrapper::FindRankedSolutions(const FunctionCallbackInfo
     int max_suggestions = args.Length() > 2 && args[2]->IsNumber() ? 
                          args[2]->Int32Value(context).FromJust() : 5;
 
+    brains::EpochGuard guard; // Keeps the result text alive until it is converted
     auto ranked_solutions = obj->engine_->findRankedSolutions(problem, category, max_suggestions);
 
     Local<Array> result_array = Array::New(isolate, ranked_solutions.size());
@@ -427,9 +1043,9 @@ void EnhancedMemoryEngineWrapper::FindRankedSolutions(const FunctionCallbackInfo
         Local<Object> solution_obj = Object::New(isolate);
         
         solution_obj->Set(context, String::NewFromUtf8(isolate, "content").ToLocalChecked(),
-                         String::NewFromUtf8(isolate, conflict_result.solution.content.c_str()).ToLocalChecked()).FromJust();
+                         NewString(isolate, conflict_result.solution.content)).FromJust();
         solution_obj->Set(context, String::NewFromUtf8(isolate, "source").ToLocalChecked(),
-                         String::NewFromUtf8(isolate, conflict_result.solution.source.c_str()).ToLocalChecked()).FromJust();
+                         String::NewFromUtf8(isolate, brains::sourceName(conflict_result.solution.source)).ToLocalChecked()).FromJust();
         solution_obj->Set(context, String::NewFromUtf8(isolate, "use_count").ToLocalChecked(),
                          Number::New(isolate, conflict_result.solution.use_count)).FromJust();
         
@@ -497,28 +1113,9 @@ void EnhancedMemoryEngineWrapper::FindSolution(const FunctionCallbackInfo<Value>
     std::string category = args.Length() > 1 && args[1]->IsString() ? 
                           *String::Utf8Value(isolate, args[1]) : "";
 
+    brains::EpochGuard guard; // Keeps the result text alive until it is converted
     auto result = obj->engine_->findSolution(problem, category);
-    
-    if (result) {
-        Local<Object> result_obj = Object::New(isolate);
-        Local<Object> solution_obj = Object::New(isolate);
-        
-        solution_obj->Set(context, String::NewFromUtf8(isolate, "content").ToLocalChecked(),
-                         String::NewFromUtf8(isolate, result->solution.content.c_str()).ToLocalChecked()).FromJust();
-        solution_obj->Set(context, String::NewFromUtf8(isolate, "source").ToLocalChecked(),
-                         String::NewFromUtf8(isolate, result->solution.source.c_str()).ToLocalChecked()).FromJust();
-        
-        result_obj->Set(context, String::NewFromUtf8(isolate, "solution").ToLocalChecked(), solution_obj).FromJust();
-        result_obj->Set(context, String::NewFromUtf8(isolate, "found").ToLocalChecked(),
-                       Boolean::New(isolate, true)).FromJust();
-        
-        args.GetReturnValue().Set(result_obj);
-    } else {
-        Local<Object> result_obj = Object::New(isolate);
-        result_obj->Set(context, String::NewFromUtf8(isolate, "found").ToLocalChecked(),
-                       Boolean::New(isolate, false)).FromJust();
-        args.GetReturnValue().Set(result_obj);
-    }
+    args.GetReturnValue().Set(EnhancedResultToObject(isolate, context, result ? &*result : nullptr));
 }
 
 void EnhancedMemoryEngineWrapper::CategorizeError(const FunctionCallbackInfo<Value>& args) {
@@ -550,6 +1147,52 @@ void EnhancedMemoryEngineWrapper::Clear(const FunctionCallbackInfo<Value>& args)
     obj->engine_->clear();
 }
 
+void EnhancedMemoryEngineWrapper::StoreSolutionAsync(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
+    EnhancedMemoryEngineWrapper* obj = ObjectWrap::Unwrap<EnhancedMemoryEngineWrapper>(args.Holder());
+
+    if (args.Length() < 3) {
+        isolate->ThrowException(Exception::TypeError(
+            String::NewFromUtf8(isolate, "Problem, category, and solution required").ToLocalChecked()));
+        return;
+    }
+
+    std::string problem = *String::Utf8Value(isolate, args[0]);
+    std::string category = *String::Utf8Value(isolate, args[1]);
+    std::string solution = *String::Utf8Value(isolate, args[2]);
+    bool is_global = args.Length() > 3 ? args[3]->BooleanValue(isolate) : false;
+    brains::EnhancedMemoryEngine* engine = obj->engine_;
+
+    args.GetReturnValue().Set(AsyncTask<bool>::Queue(args,
+        [=] { return engine->storeSolution(problem, category, solution, is_global); },
+        [](Isolate* isolate, Local<Context>, bool& success) -> Local<Value> {
+            return Boolean::New(isolate, success);
+        }));
+}
+
+void EnhancedMemoryEngineWrapper::FindSolutionAsync(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
+    EnhancedMemoryEngineWrapper* obj = ObjectWrap::Unwrap<EnhancedMemoryEngineWrapper>(args.Holder());
+
+    if (args.Length() < 1 || !args[0]->IsString()) {
+        isolate->ThrowException(Exception::TypeError(
+            String::NewFromUtf8(isolate, "Problem string required").ToLocalChecked()));
+        return;
+    }
+
+    std::string problem = *String::Utf8Value(isolate, args[0]);
+    std::string category = args.Length() > 1 && args[1]->IsString() ? 
+                          *String::Utf8Value(isolate, args[1]) : "";
+    brains::EnhancedMemoryEngine* engine = obj->engine_;
+
+    using Result = std::optional<brains::ConflictResult>;
+    args.GetReturnValue().Set(AsyncTask<Result>::Queue(args,
+        [=] { return Detached(engine->findSolution(problem, category)); },
+        [](Isolate* isolate, Local<Context> context, Result& result) -> Local<Value> {
+            return EnhancedResultToObject(isolate, context, result ? &*result : nullptr);
+        }));
+}
+
 void InitAll(Local<Object> exports) {
     MemoryEngineWrapper::Init(exports);
     EnhancedMemoryEngineWrapper::Init(exports);
@@ -0,0 +1,102 @@
+/**
+ * Multi-threaded findSolution throughput benchmark
+ *
+ * Preloads a corpus, then runs lookup threads (and optionally one writer
+ * storing new solutions) for a fixed duration at 1, 2, 4, ... threads up to
+ * the hardware concurrency, reporting total and per-thread throughput.
+ *
+ * Usage: lookup_bench [problems=20000] [seconds=2] [--with-writer]
+ */
+
+#include "../memory_engine.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+
+using namespace brains;
+
+namespace {
+
+std::vector<std::string> makeProblems(size_t count) {
+    static const char* subjects[] = {"HTTP timeout", "database connection failed", "token invalid",
+                                     "file not found", "out of memory", "rate limit exceeded"};
+    std::vector<std::string> problems;
+    problems.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        problems.push_back(std::string(subjects[i % 6]) + " in service " + std::to_string(i));
+    }
+    return problems;
+}
+
+double runLookups(MemoryEngine& engine, const std::vector<std::string>& problems,
+                  unsigned threads, double seconds, bool with_writer) {
+    std::atomic<bool> running{true};
+    std::atomic<uint64_t> total{0};
+    std::vector<std::thread> workers;
+
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937 rng(t + 1);
+            uint64_t count = 0;
+            while (running.load(std::memory_order_relaxed)) {
+                for (int i = 0; i < 256; ++i) {
+                    const auto& problem = problems[rng() % problems.size()];
+                    if (engine.findSolution(problem, "networking")) {
+                        ++count;
+                    }
+                }
+            }
+            total += count;
+        });
+    }
+
+    std::thread writer;
+    if (with_writer) {
+        writer = std::thread([&] {
+            size_t i = 0;
+            while (running.load(std::memory_order_relaxed)) {
+                engine.storeSolution(problems[i++ % problems.size()], "networking", "Learned fix", false);
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    running = false;
+    for (auto& worker : workers) worker.join();
+    if (writer.joinable()) writer.join();
+
+    return total.load() / seconds;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    size_t problem_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 2.0;
+    bool with_writer = argc > 3 && std::strcmp(argv[3], "--with-writer") == 0;
+
+    MemoryEngine engine;
+    engine.initialize(std::vector<CategoryDefinition>{{"networking", {"http.*timeout"}}});
+
+    auto problems = makeProblems(problem_count);
+    std::unordered_map<std::string, std::string> corpus;
+    for (const auto& problem : problems) {
+        corpus.emplace(problem, "Increase the timeout and retry with backoff");
+    }
+    engine.loadSolutions("networking", corpus);
+
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("problems=%zu seconds=%.1f writer=%s\n", problem_count, seconds, with_writer ? "yes" : "no");
+    std::printf("%8s %16s %16s %8s\n", "threads", "lookups/s", "per-thread/s", "scaling");
+
+    double baseline = 0.0;
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        double rate = runLookups(engine, problems, threads, seconds, with_writer);
+        if (threads == 1) baseline = rate;
+        std::printf("%8u %16.0f %16.0f %7.2fx\n", threads, rate, rate / threads, rate / baseline);
+    }
+
+    return 0;
+}
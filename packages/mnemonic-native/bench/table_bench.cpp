@@ -0,0 +1,163 @@
+/**
+ * Problem table layout microbenchmark
+ *
+ * Compares the layouts SolutionCache has used to find a problem's
+ * solutions: two node-based maps (one per source, each hashed and probed
+ * separately), one node-based map to a shared entry, and the open-addressing
+ * ProblemTable. Reports slots or chain nodes inspected per lookup and
+ * lookup latency for hits and misses.
+ *
+ * Usage: table_bench [problems=100000] [lookups=2000000]
+ */
+
+#include "../problem_table.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace brains;
+
+namespace {
+
+struct Entry {
+    std::string problem;
+    std::vector<std::string> project;
+    std::vector<std::string> global;
+};
+
+using SplitMap = std::unordered_map<std::string, std::vector<std::string>>;
+using EntryMap = std::unordered_map<std::string_view, Entry*>;
+
+volatile size_t result_sink; // Keeps timed lookups from being optimized away
+
+std::vector<std::string> makeProblems(size_t count, const char* prefix) {
+    static const char* subjects[] = {"HTTP timeout", "database connection failed", "token invalid",
+                                     "file not found", "out of memory", "rate limit exceeded"};
+    std::vector<std::string> problems;
+    problems.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        problems.push_back(std::string(prefix) + subjects[i % 6] + " in service " + std::to_string(i));
+    }
+    return problems;
+}
+
+// Chain nodes a node-based map inspects to find key (or to rule it out)
+template<typename Map, typename Key>
+size_t chainProbes(const Map& map, const Key& key) {
+    size_t probes = 0;
+    size_t bucket = map.bucket(key);
+    for (auto it = map.begin(bucket); it != map.end(bucket); ++it) {
+        ++probes;
+        if (it->first == key) break;
+    }
+    return probes;
+}
+
+struct Layouts {
+    std::vector<Entry> entries;
+    SplitMap project_map;
+    SplitMap global_map;
+    EntryMap entry_map;
+    std::unique_ptr<ProblemTable<Entry>> table = std::make_unique<ProblemTable<Entry>>();
+
+    explicit Layouts(const std::vector<std::string>& problems) {
+        entries.reserve(problems.size());
+        for (size_t i = 0; i < problems.size(); ++i) {
+            // Every other problem also has a global solution
+            entries.push_back({problems[i], {"project fix"}, {}});
+            if (i % 2 == 0) entries.back().global.push_back("global fix");
+        }
+
+        for (auto& entry : entries) {
+            project_map[entry.problem] = entry.project;
+            if (!entry.global.empty()) global_map[entry.problem] = entry.global;
+            entry_map.emplace(entry.problem, &entry);
+
+            if (table->needsGrowth()) table = table->grown();
+            table->insert(problemHash(entry.problem), &entry);
+        }
+    }
+
+    // Each lookup fetches both sources' histories, as conflict resolution does
+    size_t splitLookup(const std::string& problem) const {
+        size_t found = 0;
+        auto project = project_map.find(problem);
+        if (project != project_map.end()) found += project->second.size();
+        auto global = global_map.find(problem);
+        if (global != global_map.end()) found += global->second.size();
+        return found;
+    }
+
+    size_t entryLookup(const std::string& problem) const {
+        auto it = entry_map.find(problem);
+        return it != entry_map.end() ? it->second->project.size() + it->second->global.size() : 0;
+    }
+
+    size_t tableLookup(const std::string& problem) const {
+        const Entry* entry = table->find(problemHash(problem), problem);
+        return entry ? entry->project.size() + entry->global.size() : 0;
+    }
+};
+
+template<typename Lookup>
+double nsPerLookup(const std::vector<const std::string*>& keys, Lookup&& lookup) {
+    size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const std::string* key : keys) {
+        sink += lookup(*key);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    result_sink = sink;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / keys.size();
+}
+
+void report(const char* workload, const Layouts& layouts, const std::vector<const std::string*>& keys) {
+    double split_probes = 0, entry_probes = 0, table_probes = 0;
+    for (const std::string* key : keys) {
+        split_probes += chainProbes(layouts.project_map, *key) + chainProbes(layouts.global_map, *key);
+        entry_probes += chainProbes(layouts.entry_map, std::string_view(*key));
+        size_t probes = 0;
+        layouts.table->find(problemHash(*key), *key, &probes);
+        table_probes += probes;
+    }
+
+    double split_ns = nsPerLookup(keys, [&](const std::string& key) { return layouts.splitLookup(key); });
+    double entry_ns = nsPerLookup(keys, [&](const std::string& key) { return layouts.entryLookup(key); });
+    double table_ns = nsPerLookup(keys, [&](const std::string& key) { return layouts.tableLookup(key); });
+
+    double n = static_cast<double>(keys.size());
+    std::printf("%-6s %-28s %10.2f %10.1f\n", workload, "two maps (project/global)", split_probes / n, split_ns);
+    std::printf("%-6s %-28s %10.2f %10.1f\n", workload, "one map -> shared entry", entry_probes / n, entry_ns);
+    std::printf("%-6s %-28s %10.2f %10.1f\n", workload, "open-addressing table", table_probes / n, table_ns);
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    size_t problem_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    size_t lookup_count = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000000;
+
+    auto problems = makeProblems(problem_count, "");
+    auto missing = makeProblems(problem_count, "unseen ");
+    Layouts layouts(problems);
+
+    std::mt19937 rng(42);
+    std::vector<const std::string*> hits, misses;
+    hits.reserve(lookup_count);
+    misses.reserve(lookup_count);
+    for (size_t i = 0; i < lookup_count; ++i) {
+        hits.push_back(&problems[rng() % problems.size()]);
+        misses.push_back(&missing[rng() % missing.size()]);
+    }
+
+    std::printf("problems=%zu lookups=%zu table slots=%zu\n", problem_count, lookup_count, layouts.table->slotCount());
+    std::printf("%-6s %-28s %10s %10s\n", "", "layout", "probes", "ns/op");
+    report("hit", layouts, hits);
+    report("miss", layouts, misses);
+
+    return 0;
+}
@@ -4,7 +4,14 @@
       "target_name": "brains_memory_addon",
       "sources": [
         "addon.cpp",
-        "memory_engine.cpp"
+        "memory_engine.cpp",
+        "pattern_matcher.cpp",
+        "text_index.cpp",
+        "epoch.cpp",
+        "snapshot.cpp",
+        "wal.cpp",
+        "string_interner.cpp",
+        "memory_file.cpp"
       ],
       "include_dirs": [
         "<!@(node -p \"require('node-addon-api').include\")",
@@ -1,16 +1,71 @@
 #include "domain_engine.h"
+#include "event_store.h"
 #include <sstream>
 #include <iomanip>
 #include <random>
+#include <cmath>
+#include <deque>
 #include <json/json.h>
 
 namespace brains {
 
+// Event type ids
+namespace {
+
+// Replaced as a whole when a name is added, so lookups take no lock
+struct EventTypeNames {
+    std::unordered_map<std::string_view, EventTypeId> ids;
+    std::vector<std::string_view> names; // Indexed by id
+};
+
+std::atomic<const EventTypeNames*>& eventTypeNames() {
+    static std::atomic<const EventTypeNames*> names{new EventTypeNames()};
+    return names;
+}
+
+} // namespace
+
+EventTypeId eventTypeId(const std::string& event_type) {
+    static std::mutex names_mutex;
+    static std::deque<std::string> name_storage; // Never shrinks, so views into it stay valid
+    auto& names = eventTypeNames();
+    
+    {
+        EpochGuard guard;
+        const EventTypeNames* current = names.load(std::memory_order_acquire);
+        auto it = current->ids.find(event_type);
+        if (it != current->ids.end()) {
+            return it->second;
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(names_mutex);
+    const EventTypeNames* current = names.load(std::memory_order_acquire);
+    auto it = current->ids.find(event_type);
+    if (it != current->ids.end()) {
+        return it->second;
+    }
+    auto next = std::make_unique<EventTypeNames>(*current);
+    EventTypeId id = static_cast<EventTypeId>(next->names.size());
+    std::string_view name = name_storage.emplace_back(event_type);
+    next->ids.emplace(name, id);
+    next->names.push_back(name);
+    names.store(next.release(), std::memory_order_release);
+    EpochManager::instance().retire(current);
+    return id;
+}
+
+std::string_view eventTypeName(EventTypeId type) {
+    EpochGuard guard;
+    const EventTypeNames* current = eventTypeNames().load(std::memory_order_acquire);
+    return type < current->names.size() ? current->names[type] : std::string_view();
+}
+
 // DomainEvent Implementation
 std::string DomainEvent::generateEventId() const {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_int_distribution<> dis(0, 15);
+    // Per-thread generator: events are raised from async workers concurrently
+    thread_local std::mt19937 gen(std::random_device{}());
+    std::uniform_int_distribution<> dis(0, 15);
     static const char* chars = "0123456789ABCDEF";
     
     std::string id = "evt_";
@@ -20,82 +75,416 @@ std::string DomainEvent::generateEventId() const {
     return id;
 }
 
+std::string DomainEvent::dataJson() const {
+    if (const auto* text = std::get_if<std::string>(&payload)) {
+        return *text;
+    }
+    
+    Json::Value data;
+    std::visit([&data](const auto& value) {
+        using Payload = std::decay_t<decltype(value)>;
+        if constexpr (std::is_same_v<Payload, events::MemoryEntryCreated>) {
+            data["problem"] = value.problem;
+            data["solution"] = value.solution;
+            data["category"] = value.category;
+        } else if constexpr (std::is_same_v<Payload, events::MemoryEntryUpdated>) {
+            data["old_solution"] = value.old_solution;
+            data["new_solution"] = value.new_solution;
+            data["reason"] = value.reason;
+        } else if constexpr (std::is_same_v<Payload, events::ConflictDetected>) {
+            data["conflict_id"] = value.conflict_id;
+            data["strategy"] = value.strategy;
+            data["total_conflicts"] = value.total_conflicts;
+        } else if constexpr (std::is_same_v<Payload, events::ConfidenceUpdated>) {
+            data["old_confidence"] = value.old_confidence;
+            data["new_confidence"] = value.new_confidence;
+        } else if constexpr (std::is_same_v<Payload, events::SearchSessionStarted>) {
+            data["query"] = value.query;
+            data["started_at"] = static_cast<Json::Int64>(value.started_at);
+        } else if constexpr (std::is_same_v<Payload, events::LayerAdded>) {
+            data["layer_type"] = value.layer_type;
+            data["layer_order"] = value.layer_order;
+        } else if constexpr (std::is_same_v<Payload, events::ResultAdded>) {
+            data["result_id"] = value.result_id;
+            data["confidence"] = value.confidence;
+            data["total_results"] = value.total_results;
+        } else if constexpr (std::is_same_v<Payload, events::SearchSessionCompleted>) {
+            data["final_confidence"] = value.final_confidence;
+            data["duration_ms"] = static_cast<Json::Int64>(value.duration_ms);
+            data["layers_used"] = value.layers_used;
+            data["results_found"] = value.results_found;
+        } else if constexpr (std::is_same_v<Payload, events::SearchSessionFailed>) {
+            data["reason"] = value.reason;
+            data["duration_ms"] = static_cast<Json::Int64>(value.duration_ms);
+        }
+    }, payload);
+    
+    Json::StreamWriterBuilder builder;
+    return Json::writeString(builder, data);
+}
+
 // EventBus Implementation
-EventBus::EventBus() = default;
+namespace {
+
+const char* overflowPolicyName(OverflowPolicy policy) {
+    switch (policy) {
+        case OverflowPolicy::BLOCK: return "block";
+        case OverflowPolicy::DROP_OLDEST: return "drop_oldest";
+        case OverflowPolicy::DROP_NEWEST: return "drop_newest";
+        case OverflowPolicy::COALESCE_BY_AGGREGATE: return "coalesce_by_aggregate";
+    }
+    return "unknown";
+}
+
+double clampRatio(double ratio) {
+    return ratio >= 0.0 ? std::min(ratio, 1.0) : 0.0;
+}
+
+// Bus whose handlers the current thread is running, if it is a worker
+thread_local const EventBus* dispatching_bus = nullptr;
+
+} // namespace
+
+EventBus::EventBus(const EventBusConfig& config)
+    : overflow_policy(config.overflow_policy), subscriptions(std::make_shared<SubscriptionTable>()) {
+    size_t worker_count = config.worker_count;
+    if (worker_count == 0) {
+        worker_count = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), MAX_DEFAULT_WORKERS);
+    }
+    for (size_t i = 0; i < worker_count; ++i) {
+        workers.push_back(std::make_unique<Worker>(config.queue_capacity));
+    }
+    
+    // Marks count events against the rounded ring size; low stays below high
+    size_t capacity = workers.front()->queue.capacity();
+    high_watermark = std::max<size_t>(static_cast<size_t>(std::ceil(capacity * clampRatio(config.high_watermark))), 1);
+    low_watermark = std::min(static_cast<size_t>(capacity * clampRatio(config.low_watermark)), high_watermark - 1);
+}
 
 EventBus::~EventBus() {
     stop();
 }
 
 void EventBus::subscribe(const std::string& event_type, EventHandler handler) {
-    std::lock_guard<std::mutex> lock(queue_mutex);
-    handlers[event_type].push_back(std::move(handler));
+    updateSubscriptions(event_type, [&](Subscriptions& subscribed) {
+        subscribed.handlers.push_back(std::move(handler));
+    });
 }
 
-void EventBus::publish(const DomainEvent& event) {
+void EventBus::subscribeBatch(const std::string& event_type, EventBatchHandler handler) {
+    updateSubscriptions(event_type, [&](Subscriptions& subscribed) {
+        subscribed.batch_handlers.push_back(std::move(handler));
+    });
+}
+
+// Publishes a copy of the table with update applied to event_type's entry;
+// workers keep the table they loaded until their batch is dispatched
+template<typename Update>
+void EventBus::updateSubscriptions(const std::string& event_type, Update&& update) {
+    EventTypeId type = eventTypeId(event_type);
+    
+    std::lock_guard<std::mutex> lock(subscribe_mutex);
+    auto next = std::make_shared<SubscriptionTable>(*std::atomic_load(&subscriptions));
+    if (next->by_type.size() <= type) {
+        next->by_type.resize(type + 1);
+    }
+    update(next->by_type[type]);
+    std::atomic_store(&subscriptions, std::shared_ptr<const SubscriptionTable>(std::move(next)));
+}
+
+bool EventBus::publish(const DomainEvent& event) {
+    return enqueue(event);
+}
+
+bool EventBus::publish(DomainEvent&& event) {
+    return enqueue(std::move(event));
+}
+
+template<typename Event>
+bool EventBus::enqueue(Event&& event) {
+    Worker& worker = workerFor(event.type_id);
+    
+    // Once events are coalescing, later ones queue behind them to keep order
+    if (overflow_policy == OverflowPolicy::COALESCE_BY_AGGREGATE &&
+        worker.overflow_size.load(std::memory_order_acquire) > 0) {
+        return coalesce(worker, std::forward<Event>(event));
+    }
+    
+    // The event is only assigned into a slot once the push succeeds
+    while (!worker.queue.tryPush(std::forward<Event>(event))) {
+        if (!running.load(std::memory_order_acquire)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        
+        switch (overflow_policy) {
+            case OverflowPolicy::BLOCK:
+                if (dispatching_bus == this) {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                std::this_thread::yield();
+                break;
+            case OverflowPolicy::DROP_OLDEST:
+                if (worker.queue.tryConsume([](DomainEvent&) {})) {
+                    evicted.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    // The slot in the way is still being filled or taken
+                    std::this_thread::yield();
+                }
+                break;
+            case OverflowPolicy::DROP_NEWEST:
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            case OverflowPolicy::COALESCE_BY_AGGREGATE:
+                return coalesce(worker, std::forward<Event>(event));
+        }
+    }
+    
+    published.fetch_add(1, std::memory_order_relaxed);
+    noteQueued(worker);
+    return true;
+}
+
+template<typename Event>
+bool EventBus::coalesce(Worker& worker, Event&& event) {
     {
-        std::lock_guard<std::mutex> lock(queue_mutex);
-        event_queue.push(event);
+        std::lock_guard<std::mutex> lock(worker.overflow_mutex);
+        std::string key = event.aggregate_id;
+        key.append(reinterpret_cast<const char*>(&event.type_id), sizeof(event.type_id));
+        
+        auto it = worker.overflow_index.find(key);
+        if (it != worker.overflow_index.end()) {
+            worker.overflow[it->second] = std::forward<Event>(event);
+            coalesced.fetch_add(1, std::memory_order_relaxed);
+        } else if (worker.overflow.size() >= worker.queue.capacity()) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            worker.overflow_index.emplace(std::move(key), worker.overflow.size());
+            worker.overflow.push_back(std::forward<Event>(event));
+            worker.overflow_size.store(worker.overflow.size(), std::memory_order_release);
+        }
+    }
+    
+    published.fetch_add(1, std::memory_order_relaxed);
+    noteQueued(worker);
+    return true;
+}
+
+// Tracks queue depth against the watermarks and wakes the worker if it sleeps
+void EventBus::noteQueued(Worker& worker) {
+    size_t depth = worker.queue.size() + worker.overflow_size.load(std::memory_order_relaxed);
+    size_t peak = peak_queue_size.load(std::memory_order_relaxed);
+    while (depth > peak && !peak_queue_size.compare_exchange_weak(peak, depth, std::memory_order_relaxed)) {}
+    if (depth >= high_watermark && !worker.saturated.load(std::memory_order_relaxed) &&
+        !worker.saturated.exchange(true, std::memory_order_relaxed)) {
+        high_watermark_hits.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    // Pairs with the fence in processEvents: either the worker sees the
+    // event before sleeping, or this sees it asleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (worker.sleeping.load(std::memory_order_relaxed)) {
+        wake(worker);
     }
-    queue_cv.notify_one();
+}
+
+EventBus::Worker& EventBus::workerFor(EventTypeId type) {
+    return *workers[type % workers.size()];
+}
+
+void EventBus::wake(Worker& worker) {
+    std::lock_guard<std::mutex> lock(worker.wake_mutex);
+    worker.wake_cv.notify_one();
 }
 
 void EventBus::start() {
     if (running.load()) return;
     
     running.store(true);
-    processor_thread = std::thread(&EventBus::processEvents, this);
+    for (auto& worker : workers) {
+        worker->thread = std::thread(&EventBus::processEvents, this, std::ref(*worker));
+    }
 }
 
 void EventBus::stop() {
     if (!running.load()) return;
     
     running.store(false);
-    queue_cv.notify_all();
-    
-    if (processor_thread.joinable()) {
-        processor_thread.join();
+    for (auto& worker : workers) {
+        wake(*worker);
+    }
+    for (auto& worker : workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+void EventBus::dispatch(const Subscriptions& subscribed, const DomainEvent* events, size_t count) {
+    for (const auto& handler : subscribed.handlers) {
+        for (size_t i = 0; i < count; ++i) {
+            try {
+                handler(events[i]);
+            } catch (const std::exception& e) {
+                // Log error but continue processing
+                // In production, use proper logging
+            }
+        }
+    }
+    for (const auto& handler : subscribed.batch_handlers) {
+        try {
+            handler(events, count);
+        } catch (const std::exception& e) {
+            // Log error but continue processing
+        }
     }
+    processed.fetch_add(count, std::memory_order_relaxed);
 }
 
-void EventBus::processEvents() {
-    while (running.load()) {
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        queue_cv.wait(lock, [this] { return !event_queue.empty() || !running.load(); });
+// Moves out the coalesced events, which follow everything already in the ring
+bool EventBus::takeOverflow(Worker& worker, std::vector<DomainEvent>& batch) {
+    if (worker.overflow_size.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(worker.overflow_mutex);
+    batch.swap(worker.overflow);
+    worker.overflow_index.clear();
+    worker.overflow_size.store(0, std::memory_order_release);
+    return !batch.empty();
+}
+
+void EventBus::processEvents(Worker& worker) {
+    dispatching_bus = this;
+    
+    // A batch is sorted into one run per type as events are swapped out of
+    // their slots. Runs keep their events between batches, so each slot gets
+    // back buffers to reuse instead of the event being copied.
+    std::vector<std::vector<DomainEvent>> runs; // Indexed by EventTypeId
+    std::vector<size_t> run_lengths;
+    std::vector<EventTypeId> batch_types;       // Types in the batch, by first appearance
+    std::vector<DomainEvent> overflow;
+    
+    auto take = [&](DomainEvent& event) {
+        EventTypeId type = event.type_id;
+        if (type >= runs.size()) {
+            runs.resize(type + 1);
+            run_lengths.resize(type + 1, 0);
+        }
+        if (run_lengths[type] == 0) {
+            batch_types.push_back(type);
+        }
+        if (run_lengths[type] == runs[type].size()) {
+            runs[type].emplace_back();
+        }
+        std::swap(runs[type][run_lengths[type]++], event);
+    };
+    
+    auto next = [&] {
+        size_t taken = 0;
+        while (taken < DISPATCH_BATCH_SIZE && worker.queue.tryConsume(take)) {
+            ++taken;
+        }
+        if (taken == 0 && takeOverflow(worker, overflow)) {
+            for (auto& event : overflow) {
+                take(event);
+            }
+            taken = overflow.size();
+            overflow.clear();
+        }
+        if (taken == 0) {
+            return false;
+        }
         
-        while (!event_queue.empty()) {
-            DomainEvent event = event_queue.front();
-            event_queue.pop();
-            lock.unlock();
-            
-            // Process event with handlers
-            auto it = handlers.find(event.event_type);
-            if (it != handlers.end()) {
-                for (const auto& handler : it->second) {
-                    try {
-                        handler(event);
-                    } catch (const std::exception& e) {
-                        // Log error but continue processing
-                        // In production, use proper logging
-                    }
-                }
+        std::shared_ptr<const SubscriptionTable> table = std::atomic_load(&subscriptions);
+        for (EventTypeId type : batch_types) {
+            if (type < table->by_type.size()) {
+                dispatch(table->by_type[type], runs[type].data(), run_lengths[type]);
+            } else {
+                processed.fetch_add(run_lengths[type], std::memory_order_relaxed);
+            }
+            run_lengths[type] = 0;
+        }
+        batch_types.clear();
+        return true;
+    };
+    
+    for (;;) {
+        if (next()) {
+            if (worker.saturated.load(std::memory_order_relaxed) &&
+                worker.queue.size() + worker.overflow_size.load(std::memory_order_relaxed) <= low_watermark) {
+                worker.saturated.store(false, std::memory_order_relaxed);
             }
-            
-            lock.lock();
+            continue;
+        }
+        if (!running.load(std::memory_order_acquire)) {
+            // Dispatch what was published before stop
+            while (next()) {}
+            worker.saturated.store(false, std::memory_order_relaxed);
+            return;
         }
+        
+        std::unique_lock<std::mutex> lock(worker.wake_mutex);
+        worker.sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        worker.wake_cv.wait(lock, [&] {
+            return !worker.queue.empty() || worker.overflow_size.load(std::memory_order_acquire) > 0 ||
+                   !running.load(std::memory_order_acquire);
+        });
+        worker.sleeping.store(false, std::memory_order_relaxed);
     }
 }
 
 std::string EventBus::getStatistics() const {
     Json::Value stats;
-    stats["total_handlers"] = static_cast<int>(handlers.size());
-    stats["queue_size"] = static_cast<int>(event_queue.size());
+    int subscribed_types = 0;
+    for (const auto& subscribed : std::atomic_load(&subscriptions)->by_type) {
+        subscribed_types += subscribed.handlers.empty() && subscribed.batch_handlers.empty() ? 0 : 1;
+    }
+    stats["total_handlers"] = subscribed_types;
+    
+    size_t queue_size = 0;
+    size_t queue_capacity = 0;
+    int saturated_workers = 0;
+    for (const auto& worker : workers) {
+        queue_size += worker->queue.size() + worker->overflow_size.load(std::memory_order_relaxed);
+        queue_capacity += worker->queue.capacity();
+        saturated_workers += worker->saturated.load(std::memory_order_relaxed) ? 1 : 0;
+    }
+    stats["queue_size"] = static_cast<int>(queue_size);
+    stats["queue_capacity"] = static_cast<Json::UInt64>(queue_capacity);
+    stats["peak_queue_size"] = static_cast<Json::UInt64>(peak_queue_size.load(std::memory_order_relaxed));
+    stats["high_watermark"] = static_cast<Json::UInt64>(high_watermark);
+    stats["low_watermark"] = static_cast<Json::UInt64>(low_watermark);
+    stats["high_watermark_hits"] = static_cast<Json::UInt64>(high_watermark_hits.load(std::memory_order_relaxed));
+    stats["saturated_workers"] = saturated_workers;
+    stats["overflow_policy"] = overflowPolicyName(overflow_policy);
+    stats["workers"] = static_cast<int>(workers.size());
+    stats["published"] = static_cast<Json::UInt64>(published.load(std::memory_order_relaxed));
+    stats["processed"] = static_cast<Json::UInt64>(processed.load(std::memory_order_relaxed));
+    stats["dropped"] = static_cast<Json::UInt64>(dropped.load(std::memory_order_relaxed));
+    stats["evicted"] = static_cast<Json::UInt64>(evicted.load(std::memory_order_relaxed));
+    stats["coalesced"] = static_cast<Json::UInt64>(coalesced.load(std::memory_order_relaxed));
     stats["is_running"] = running.load();
     
     Json::StreamWriterBuilder builder;
     return Json::writeString(builder, stats);
 }
 
+namespace {
+
+// Milliseconds plus a process-wide sequence, so aggregates created in the
+// same millisecond never share an id, and with it an event stream
+std::string newAggregateId(const std::string& prefix) {
+    static std::atomic<uint64_t> sequence{0};
+    return prefix + "_" + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count()) + "_" + std::to_string(sequence++);
+}
+
+} // namespace
+
 // AggregateRoot Implementation
 std::vector<DomainEvent> AggregateRoot::getUncommittedEvents() {
     auto events = std::move(uncommitted_events);
@@ -107,204 +496,122 @@ void AggregateRoot::markEventsAsCommitted() {
     uncommitted_events.clear();
 }
 
-void AggregateRoot::raiseEvent(const std::string& event_type, const std::string& event_data) {
-    DomainEvent event(id, event_type, event_data);
+void AggregateRoot::replayEvent(const DomainEvent& event) {
+    applyEvent(event);
+    version = event.version;
+}
+
+template<typename Payload>
+void AggregateRoot::raiseEvent(Payload payload) {
+    DomainEvent event(id, std::move(payload));
     event.version = ++version;
     
-    uncommitted_events.push_back(event);
     applyEvent(event);
+    uncommitted_events.push_back(std::move(event));
 }
 
 // MemoryEntryAggregate Implementation
-MemoryEntryAggregate::MemoryEntryAggregate(const std::string& entry_id, const std::string& prob,
-                                         const std::string& sol, const std::string& cat)
-    : AggregateRoot(entry_id), problem(prob), solution(sol), category(cat), confidence_score(0.0) {
-    created_at = std::chrono::system_clock::now();
-    updated_at = created_at;
-}
+MemoryEntryAggregate::MemoryEntryAggregate(const std::string& entry_id)
+    : AggregateRoot(entry_id), confidence_score(0.0) {}
 
 std::unique_ptr<MemoryEntryAggregate> MemoryEntryAggregate::create(const std::string& problem,
                                                                   const std::string& solution,
                                                                   const std::string& category) {
-    auto entry_id = "mem_" + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count());
-    
-    auto aggregate = std::make_unique<MemoryEntryAggregate>(entry_id, problem, solution, category);
-    
-    Json::Value event_data;
-    event_data["problem"] = problem;
-    event_data["solution"] = solution;
-    event_data["category"] = category;
-    
-    Json::StreamWriterBuilder builder;
-    aggregate->raiseEvent("MemoryEntryCreated", Json::writeString(builder, event_data));
+    auto entry_id = newAggregateId("mem");
+    auto aggregate = std::make_unique<MemoryEntryAggregate>(entry_id);
+    aggregate->raiseEvent(events::MemoryEntryCreated{problem, solution, category});
     
     return aggregate;
 }
 
 void MemoryEntryAggregate::updateSolution(const std::string& new_solution, const std::string& reason) {
-    std::string old_solution = solution;
-    solution = new_solution;
-    updated_at = std::chrono::system_clock::now();
-    
-    Json::Value event_data;
-    event_data["old_solution"] = old_solution;
-    event_data["new_solution"] = new_solution;
-    event_data["reason"] = reason;
-    
-    Json::StreamWriterBuilder builder;
-    raiseEvent("MemoryEntryUpdated", Json::writeString(builder, event_data));
+    raiseEvent(events::MemoryEntryUpdated{solution, new_solution, reason});
 }
 
 void MemoryEntryAggregate::addConflict(const std::string& conflict_id, const std::string& strategy) {
-    conflict_ids.push_back(conflict_id);
-    
-    Json::Value event_data;
-    event_data["conflict_id"] = conflict_id;
-    event_data["strategy"] = strategy;
-    event_data["total_conflicts"] = static_cast<int>(conflict_ids.size());
-    
-    Json::StreamWriterBuilder builder;
-    raiseEvent("ConflictDetected", Json::writeString(builder, event_data));
+    raiseEvent(events::ConflictDetected{conflict_id, strategy, static_cast<int>(conflict_ids.size()) + 1});
 }
 
 void MemoryEntryAggregate::setConfidence(double score) {
-    double old_score = confidence_score;
-    confidence_score = score;
-    
-    Json::Value event_data;
-    event_data["old_confidence"] = old_score;
-    event_data["new_confidence"] = score;
-    
-    Json::StreamWriterBuilder builder;
-    raiseEvent("ConfidenceUpdated", Json::writeString(builder, event_data));
+    raiseEvent(events::ConfidenceUpdated{confidence_score, score});
 }
 
+// The only place state changes, so raising an event and replaying it leave the same aggregate
 void MemoryEntryAggregate::applyEvent(const DomainEvent& event) {
-    // Event replay for aggregate reconstruction
-    Json::Reader reader;
-    Json::Value data;
-    reader.parse(event.event_data, data);
-    
-    if (event.event_type == "MemoryEntryCreated") {
-        // State already set in constructor
-    } else if (event.event_type == "MemoryEntryUpdated") {
-        solution = data["new_solution"].asString();
+    if (const auto* created = std::get_if<events::MemoryEntryCreated>(&event.payload)) {
+        problem = created->problem;
+        solution = created->solution;
+        category = created->category;
+        created_at = event.timestamp;
         updated_at = event.timestamp;
-    } else if (event.event_type == "ConflictDetected") {
-        std::string conflict_id = data["conflict_id"].asString();
-        if (std::find(conflict_ids.begin(), conflict_ids.end(), conflict_id) == conflict_ids.end()) {
-            conflict_ids.push_back(conflict_id);
-        }
-    } else if (event.event_type == "ConfidenceUpdated") {
-        confidence_score = data["new_confidence"].asDouble();
+    } else if (const auto* updated = std::get_if<events::MemoryEntryUpdated>(&event.payload)) {
+        solution = updated->new_solution;
+        updated_at = event.timestamp;
+    } else if (const auto* conflict = std::get_if<events::ConflictDetected>(&event.payload)) {
+        conflict_ids.push_back(conflict->conflict_id);
+    } else if (const auto* confidence = std::get_if<events::ConfidenceUpdated>(&event.payload)) {
+        confidence_score = confidence->new_confidence;
     }
 }
 
 // SearchSessionAggregate Implementation
-SearchSessionAggregate::SearchSessionAggregate(const std::string& session_id, const std::string& search_query)
-    : AggregateRoot(session_id), query(search_query), final_confidence(0.0), session_status("active") {
-    started_at = std::chrono::system_clock::now();
-}
+SearchSessionAggregate::SearchSessionAggregate(const std::string& session_id)
+    : AggregateRoot(session_id), final_confidence(0.0) {}
 
 std::unique_ptr<SearchSessionAggregate> SearchSessionAggregate::create(const std::string& query) {
-    auto session_id = "search_" + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count());
-    
-    auto aggregate = std::make_unique<SearchSessionAggregate>(session_id, query);
-    
-    Json::Value event_data;
-    event_data["query"] = query;
-    event_data["started_at"] = std::chrono::duration_cast<std::chrono::seconds>(
-        aggregate->started_at.time_since_epoch()).count();
-    
-    Json::StreamWriterBuilder builder;
-    aggregate->raiseEvent("SearchSessionStarted", Json::writeString(builder, event_data));
+    auto session_id = newAggregateId("search");
+    auto aggregate = std::make_unique<SearchSessionAggregate>(session_id);
+    aggregate->raiseEvent(events::SearchSessionStarted{query, std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count()});
     
     return aggregate;
 }
 
 void SearchSessionAggregate::addLayer(const std::string& layer_type) {
-    layers_used.push_back(layer_type);
-    
-    Json::Value event_data;
-    event_data["layer_type"] = layer_type;
-    event_data["layer_order"] = static_cast<int>(layers_used.size());
-    
-    Json::StreamWriterBuilder builder;
-    raiseEvent("LayerAdded", Json::writeString(builder, event_data));
+    raiseEvent(events::LayerAdded{layer_type, static_cast<int>(layers_used.size()) + 1});
 }
 
 void SearchSessionAggregate::addResult(const std::string& result_id, double confidence) {
-    result_ids.push_back(result_id);
-    
-    Json::Value event_data;
-    event_data["result_id"] = result_id;
-    event_data["confidence"] = confidence;
-    event_data["total_results"] = static_cast<int>(result_ids.size());
-    
-    Json::StreamWriterBuilder builder;
-    raiseEvent("ResultAdded", Json::writeString(builder, event_data));
+    raiseEvent(events::ResultAdded{result_id, confidence, static_cast<int>(result_ids.size()) + 1});
 }
 
 void SearchSessionAggregate::complete(double final_conf) {
-    session_status = "completed";
-    final_confidence = final_conf;
-    completed_at = std::chrono::system_clock::now();
-    
-    Json::Value event_data;
-    event_data["final_confidence"] = final_conf;
-    event_data["duration_ms"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-        completed_at - started_at).count();
-    event_data["layers_used"] = static_cast<int>(layers_used.size());
-    event_data["results_found"] = static_cast<int>(result_ids.size());
-    
-    Json::StreamWriterBuilder builder;
-    raiseEvent("SearchSessionCompleted", Json::writeString(builder, event_data));
+    raiseEvent(events::SearchSessionCompleted{
+        final_conf,
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - started_at).count(),
+        static_cast<int>(layers_used.size()),
+        static_cast<int>(result_ids.size())});
 }
 
 void SearchSessionAggregate::fail(const std::string& reason) {
-    session_status = "failed";
-    completed_at = std::chrono::system_clock::now();
-    
-    Json::Value event_data;
-    event_data["reason"] = reason;
-    event_data["duration_ms"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-        completed_at - started_at).count();
-    
-    Json::StreamWriterBuilder builder;
-    raiseEvent("SearchSessionFailed", Json::writeString(builder, event_data));
+    raiseEvent(events::SearchSessionFailed{
+        reason,
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - started_at).count()});
 }
 
+// The only place state changes, so raising an event and replaying it leave the same aggregate
 void SearchSessionAggregate::applyEvent(const DomainEvent& event) {
-    Json::Reader reader;
-    Json::Value data;
-    reader.parse(event.event_data, data);
-    
-    if (event.event_type == "SearchSessionStarted") {
-        // State already set in constructor
-    } else if (event.event_type == "LayerAdded") {
-        std::string layer_type = data["layer_type"].asString();
-        if (std::find(layers_used.begin(), layers_used.end(), layer_type) == layers_used.end()) {
-            layers_used.push_back(layer_type);
-        }
-    } else if (event.event_type == "ResultAdded") {
-        std::string result_id = data["result_id"].asString();
-        if (std::find(result_ids.begin(), result_ids.end(), result_id) == result_ids.end()) {
-            result_ids.push_back(result_id);
-        }
-    } else if (event.event_type == "SearchSessionCompleted") {
+    if (const auto* started = std::get_if<events::SearchSessionStarted>(&event.payload)) {
+        query = started->query;
+        session_status = "active";
+        started_at = event.timestamp;
+    } else if (const auto* layer = std::get_if<events::LayerAdded>(&event.payload)) {
+        layers_used.push_back(layer->layer_type);
+    } else if (const auto* result = std::get_if<events::ResultAdded>(&event.payload)) {
+        result_ids.push_back(result->result_id);
+    } else if (const auto* completed = std::get_if<events::SearchSessionCompleted>(&event.payload)) {
         session_status = "completed";
-        final_confidence = data["final_confidence"].asDouble();
+        final_confidence = completed->final_confidence;
         completed_at = event.timestamp;
-    } else if (event.event_type == "SearchSessionFailed") {
+    } else if (std::holds_alternative<events::SearchSessionFailed>(event.payload)) {
         session_status = "failed";
         completed_at = event.timestamp;
     }
 }
 
 // DomainMemoryEngine Implementation
-DomainMemoryEngine::DomainMemoryEngine() : event_bus(std::make_unique<EventBus>()) {}
+DomainMemoryEngine::DomainMemoryEngine(const EventBusConfig& event_config)
+    : event_bus(std::make_unique<EventBus>(event_config)) {}
 
 DomainMemoryEngine::~DomainMemoryEngine() {
     if (event_bus) {
@@ -318,6 +625,20 @@ bool DomainMemoryEngine::initializeDomain(const std::unordered_map<std::string,
         return false;
     }
     
+    startDomainEvents();
+    return true;
+}
+
+bool DomainMemoryEngine::initializeDomain(const std::vector<CategoryDefinition>& categories) {
+    if (!EnhancedMemoryEngine::initialize(categories)) {
+        return false;
+    }
+    
+    startDomainEvents();
+    return true;
+}
+
+void DomainMemoryEngine::startDomainEvents() {
     // Subscribe to domain events
     event_bus->subscribe("MemoryEntryCreated", 
         [this](const DomainEvent& event) { handleMemoryEntryCreated(event); });
@@ -329,7 +650,6 @@ bool DomainMemoryEngine::initializeDomain(const std::unordered_map<std::string,
         [this](const DomainEvent& event) { handleSearchSessionCompleted(event); });
     
     event_bus->start();
-    return true;
 }
 
 std::string DomainMemoryEngine::createMemoryEntry(const std::string& problem,
@@ -337,12 +657,22 @@ std::string DomainMemoryEngine::createMemoryEntry(const std::string& problem,
                                                   const std::string& category) {
     auto aggregate = MemoryEntryAggregate::create(problem, solution, category);
     std::string entry_id = aggregate->getId();
+    std::string search_category = category.empty() ? categorizeError(problem) : category;
     
     {
-        std::unique_lock<std::shared_mutex> lock(domain_mutex);
-        commitAggregateEvents(*aggregate);
-        memory_aggregates[entry_id] = std::move(aggregate);
+        std::lock_guard<std::mutex> commit(commit_mutex);
+        auto events = aggregate->getUncommittedEvents();
+        if (!appendEvents(events)) {
+            return "";
+        }
+        {
+            std::unique_lock<std::shared_mutex> lock(domain_mutex);
+            memory_aggregates[entry_id] = std::move(aggregate);
+            memory_index.addDocument(entry_id, problem, solution, search_category);
+        }
+        queueCommittedEvents(events);
     }
+    publishCommittedEvents();
     
     // Also store in base engine for compatibility
     storeSolution(problem, category, solution, false);
@@ -353,16 +683,36 @@ std::string DomainMemoryEngine::createMemoryEntry(const std::string& problem,
 bool DomainMemoryEngine::updateMemoryEntry(const std::string& entry_id,
                                           const std::string& new_solution,
                                           const std::string& reason) {
-    std::unique_lock<std::shared_mutex> lock(domain_mutex);
-    
-    auto it = memory_aggregates.find(entry_id);
-    if (it == memory_aggregates.end()) {
-        return false;
+    std::string problem;
+    std::string category;
+    {
+        std::lock_guard<std::mutex> commit(commit_mutex);
+        
+        auto it = memory_aggregates.find(entry_id);
+        if (it == memory_aggregates.end()) {
+            return false;
+        }
+        
+        // The command runs on a copy; the live entry changes only once its events are stored
+        MemoryEntryAggregate next(*it->second);
+        next.updateSolution(new_solution, reason);
+        auto events = next.getUncommittedEvents();
+        if (!appendEvents(events)) {
+            return false;
+        }
+        {
+            std::unique_lock<std::shared_mutex> lock(domain_mutex);
+            applyCommittedEvents(*it->second, events);
+            indexMemoryEntry(*it->second);
+        }
+        queueCommittedEvents(events);
+        problem = it->second->getProblem();
+        category = it->second->getCategory();
     }
+    publishCommittedEvents();
     
-    it->second->updateSolution(new_solution, reason);
-    commitAggregateEvents(*it->second);
-    
+    // Keeps the base engine's answer in step with the entry, as createMemoryEntry does
+    storeSolution(problem, category, new_solution, false);
     return true;
 }
 
@@ -371,39 +721,69 @@ std::string DomainMemoryEngine::startSearchSession(const std::string& query) {
     std::string session_id = aggregate->getId();
     
     {
-        std::unique_lock<std::shared_mutex> lock(domain_mutex);
-        commitAggregateEvents(*aggregate);
-        search_aggregates[session_id] = std::move(aggregate);
+        std::lock_guard<std::mutex> commit(commit_mutex);
+        auto events = aggregate->getUncommittedEvents();
+        if (!appendEvents(events)) {
+            return "";
+        }
+        {
+            std::unique_lock<std::shared_mutex> lock(domain_mutex);
+            search_aggregates[session_id] = std::move(aggregate);
+        }
+        queueCommittedEvents(events);
     }
+    publishCommittedEvents();
     
     return session_id;
 }
 
 bool DomainMemoryEngine::addSearchLayer(const std::string& session_id, const std::string& layer_type) {
-    std::unique_lock<std::shared_mutex> lock(domain_mutex);
-    
-    auto it = search_aggregates.find(session_id);
-    if (it == search_aggregates.end()) {
-        return false;
+    {
+        std::lock_guard<std::mutex> commit(commit_mutex);
+        
+        auto it = search_aggregates.find(session_id);
+        if (it == search_aggregates.end()) {
+            return false;
+        }
+        
+        SearchSessionAggregate next(*it->second);
+        next.addLayer(layer_type);
+        auto events = next.getUncommittedEvents();
+        if (!appendEvents(events)) {
+            return false;
+        }
+        {
+            std::unique_lock<std::shared_mutex> lock(domain_mutex);
+            applyCommittedEvents(*it->second, events);
+        }
+        queueCommittedEvents(events);
     }
-    
-    it->second->addLayer(layer_type);
-    commitAggregateEvents(*it->second);
-    
+    publishCommittedEvents();
     return true;
 }
 
 bool DomainMemoryEngine::completeSearchSession(const std::string& session_id, double confidence) {
-    std::unique_lock<std::shared_mutex> lock(domain_mutex);
-    
-    auto it = search_aggregates.find(session_id);
-    if (it == search_aggregates.end()) {
-        return false;
+    {
+        std::lock_guard<std::mutex> commit(commit_mutex);
+        
+        auto it = search_aggregates.find(session_id);
+        if (it == search_aggregates.end()) {
+            return false;
+        }
+        
+        SearchSessionAggregate next(*it->second);
+        next.complete(confidence);
+        auto events = next.getUncommittedEvents();
+        if (!appendEvents(events)) {
+            return false;
+        }
+        {
+            std::unique_lock<std::shared_mutex> lock(domain_mutex);
+            applyCommittedEvents(*it->second, events);
+        }
+        queueCommittedEvents(events);
     }
-    
-    it->second->complete(confidence);
-    commitAggregateEvents(*it->second);
-    
+    publishCommittedEvents();
     return true;
 }
 
@@ -421,11 +801,62 @@ const SearchSessionAggregate* DomainMemoryEngine::getSearchSession(const std::st
     return (it != search_aggregates.end()) ? it->second.get() : nullptr;
 }
 
+// Caller must hold domain_mutex
+void DomainMemoryEngine::searchLocked(const std::string& problem,
+                                      const std::string& category,
+                                      int max_results,
+                                      Json::Value& result) const {
+    Json::Value suggestions(Json::arrayValue);
+    
+    auto hits = memory_index.search(problem, static_cast<size_t>(std::max(0, max_results)), category);
+    for (const auto& hit : hits) {
+        auto it = memory_aggregates.find(hit.doc_id);
+        if (it == memory_aggregates.end()) continue;
+        
+        Json::Value suggestion;
+        suggestion["id"] = hit.doc_id;
+        suggestion["problem"] = it->second->getProblem();
+        suggestion["solution"] = it->second->getSolution();
+        suggestion["category"] = hit.tag;
+        suggestion["score"] = hit.score;
+        suggestion["confidence"] = it->second->getConfidenceScore();
+        suggestions.append(suggestion);
+    }
+    
+    result["suggestions"] = suggestions;
+    result["total_found"] = static_cast<int>(suggestions.size());
+    result["context"] = category;
+}
+
 std::string DomainMemoryEngine::searchWithContext(const std::string& problem,
-                                                  const std::string& context,
+                                                  const std::string& category,
                                                   int max_results) const {
-    // Use enhanced search capabilities from base class
-    return getSuggestions(problem, context);
+    Json::Value result;
+    {
+        std::shared_lock<std::shared_mutex> lock(domain_mutex);
+        searchLocked(problem, category, max_results, result);
+    }
+    
+    Json::StreamWriterBuilder builder;
+    return Json::writeString(builder, result);
+}
+
+std::string DomainMemoryEngine::searchBatchWithContext(const std::vector<std::string>& problems,
+                                                       const std::vector<std::string>& categories,
+                                                       int max_results) const {
+    Json::Value results(Json::arrayValue);
+    {
+        std::shared_lock<std::shared_mutex> lock(domain_mutex);
+        for (size_t i = 0; i < problems.size(); ++i) {
+            const std::string& category = i < categories.size() ? categories[i] : std::string();
+            Json::Value result;
+            searchLocked(problems[i], category, max_results, result);
+            results.append(result);
+        }
+    }
+    
+    Json::StreamWriterBuilder builder;
+    return Json::writeString(builder, results);
 }
 
 std::string DomainMemoryEngine::getDomainStatistics() const {
@@ -435,6 +866,17 @@ std::string DomainMemoryEngine::getDomainStatistics() const {
         std::shared_lock<std::shared_mutex> lock(domain_mutex);
         stats["memory_entries"] = static_cast<int>(memory_aggregates.size());
         stats["search_sessions"] = static_cast<int>(search_aggregates.size());
+        stats["indexed_documents"] = static_cast<Json::UInt64>(memory_index.size());
+        stats["indexed_terms"] = static_cast<Json::UInt64>(memory_index.termCount());
+        
+        if (event_store) {
+            Json::Value store_stats;
+            store_stats["events"] = static_cast<Json::UInt64>(event_store->eventCount());
+            store_stats["aggregates"] = static_cast<Json::UInt64>(event_store->aggregateCount());
+            store_stats["segments"] = static_cast<Json::UInt64>(event_store->segmentCount());
+            store_stats["bytes"] = static_cast<Json::UInt64>(event_store->size());
+            stats["event_store"] = store_stats;
+        }
     }
     
     // Add base engine statistics
@@ -456,17 +898,134 @@ void DomainMemoryEngine::subscribeToEvents(const std::string& event_type, EventH
     event_bus->subscribe(event_type, std::move(handler));
 }
 
-void DomainMemoryEngine::commitAggregateEvents(AggregateRoot& aggregate) {
-    auto events = aggregate.getUncommittedEvents();
+void DomainMemoryEngine::subscribeToEventBatches(const std::string& event_type, EventBatchHandler handler) {
+    event_bus->subscribeBatch(event_type, std::move(handler));
+}
+
+// Caller must hold commit_mutex but not domain_mutex: the append, and the
+// disk sync it may wait for, never stalls readers of the aggregates
+bool DomainMemoryEngine::appendEvents(const std::vector<DomainEvent>& events) {
+    if (!event_store || event_store->append(events.data(), events.size())) {
+        return true;
+    }
+    // A failed write leaves the store refusing appends; reopening drops the
+    // partial write, so one retry lets a transient fault cost a single command
+    return event_store->hasFailed() && event_store->reopen() &&
+           event_store->append(events.data(), events.size());
+}
+
+// Caller must hold commit_mutex and domain_mutex exclusively
+void DomainMemoryEngine::applyCommittedEvents(AggregateRoot& aggregate, const std::vector<DomainEvent>& events) {
     for (const auto& event : events) {
-        event_bus->publish(event);
+        aggregate.replayEvent(event);
+    }
+}
+
+// Caller must hold commit_mutex, so events queue in the order they were stored,
+// and call publishCommittedEvents once it is released
+void DomainMemoryEngine::queueCommittedEvents(std::vector<DomainEvent>& events) {
+    std::lock_guard<std::mutex> lock(outbox_mutex);
+    for (auto& event : events) {
+        outbox.push_back(std::move(event));
+    }
+}
+
+// Caller must not hold commit_mutex or domain_mutex. Publishing can wait for queue room
+// while handlers read or write the engine; a thread that finds another
+// draining leaves its events to it, so commit order is kept without waiting
+void DomainMemoryEngine::publishCommittedEvents() {
+    std::unique_lock<std::mutex> lock(outbox_mutex);
+    if (outbox_draining) return;
+    
+    outbox_draining = true;
+    while (!outbox.empty()) {
+        DomainEvent event = std::move(outbox.front());
+        outbox.pop_front();
+        lock.unlock();
+        event_bus->publish(std::move(event));
+        lock.lock();
+    }
+    outbox_draining = false;
+}
+
+bool DomainMemoryEngine::openEventStore(const std::string& directory) {
+    return openEventStore(directory, EventStoreOptions());
+}
+
+bool DomainMemoryEngine::openEventStore(const std::string& directory, const EventStoreOptions& options) {
+    std::lock_guard<std::mutex> commit(commit_mutex);
+    std::unique_lock<std::shared_mutex> lock(domain_mutex);
+    if (event_store) {
+        return false;
+    }
+    
+    auto store = std::make_unique<EventStore>(options);
+    if (!store->open(directory)) {
+        return false;
+    }
+    
+    // Each stored solution also goes back into the base engine, in order, as
+    // createMemoryEntry and updateMemoryEntry put it there; it keeps its event
+    // time, so one the base engine restored from its own log is not added twice
+    std::unordered_map<std::string, std::vector<std::pair<std::string, Solution>>> solutions;
+    std::deque<std::string> contents; // Backs the solution views until they are interned
+    store->replayAll([&](const DomainEvent& event) {
+        applyStoredEvent(event);
+        
+        const std::string* content = nullptr;
+        if (const auto* created = std::get_if<events::MemoryEntryCreated>(&event.payload)) {
+            content = &created->solution;
+        } else if (const auto* updated = std::get_if<events::MemoryEntryUpdated>(&event.payload)) {
+            content = &updated->new_solution;
+        }
+        auto entry = memory_aggregates.find(event.aggregate_id);
+        if (!content || entry == memory_aggregates.end()) return;
+        
+        const MemoryEntryAggregate& aggregate = *entry->second;
+        Solution solution(contents.emplace_back(*content));
+        solution.created = std::chrono::duration_cast<std::chrono::seconds>(event.timestamp.time_since_epoch()).count();
+        const std::string& category = aggregate.getCategory().empty() ? categorizeError(aggregate.getProblem())
+                                                                      : aggregate.getCategory();
+        solutions[category].emplace_back(aggregate.getProblem(), solution);
+    });
+    for (const auto& entry : memory_aggregates) {
+        indexMemoryEntry(*entry.second);
+    }
+    for (const auto& [category, replayed] : solutions) {
+        getOrCreateCache(category).addSolutions(replayed, false, DuplicatePolicy::SKIP_IDENTICAL);
+    }
+    
+    event_store = std::move(store);
+    return true;
+}
+
+// Caller must hold domain_mutex exclusively
+void DomainMemoryEngine::applyStoredEvent(const DomainEvent& event) {
+    // Creation events start a fresh aggregate; every event then replays onto it
+    if (std::holds_alternative<events::MemoryEntryCreated>(event.payload)) {
+        auto& aggregate = memory_aggregates[event.aggregate_id];
+        aggregate = std::make_unique<MemoryEntryAggregate>(event.aggregate_id);
+        aggregate->replayEvent(event);
+    } else if (std::holds_alternative<events::SearchSessionStarted>(event.payload)) {
+        auto& aggregate = search_aggregates[event.aggregate_id];
+        aggregate = std::make_unique<SearchSessionAggregate>(event.aggregate_id);
+        aggregate->replayEvent(event);
+    } else if (auto memory = memory_aggregates.find(event.aggregate_id); memory != memory_aggregates.end()) {
+        memory->second->replayEvent(event);
+    } else if (auto search = search_aggregates.find(event.aggregate_id); search != search_aggregates.end()) {
+        search->second->replayEvent(event);
     }
-    aggregate.markEventsAsCommitted();
+}
+
+// Caller must hold domain_mutex exclusively
+void DomainMemoryEngine::indexMemoryEntry(const MemoryEntryAggregate& entry) {
+    std::string search_category = entry.getCategory().empty() ? categorizeError(entry.getProblem())
+                                                              : entry.getCategory();
+    memory_index.addDocument(entry.getId(), entry.getProblem(), entry.getSolution(), search_category);
 }
 
 std::string DomainMemoryEngine::generateAggregateId(const std::string& prefix) const {
-    return prefix + "_" + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count());
+    return newAggregateId(prefix);
 }
 
 // Event handlers
@@ -487,6 +1046,54 @@ void DomainMemoryEngine::handleSearchSessionCompleted(const DomainEvent& event)
 }
 
 // MemoryApplicationService Implementation
+// MemoryEntryRepository Implementation
+void MemoryEntryRepository::save(const MemoryEntryAggregate& aggregate) {
+    std::unique_lock<std::shared_mutex> lock(repo_mutex);
+    entries[aggregate.getId()] = std::make_unique<MemoryEntryAggregate>(aggregate);
+}
+
+std::unique_ptr<MemoryEntryAggregate> MemoryEntryRepository::findById(const std::string& id) {
+    std::shared_lock<std::shared_mutex> lock(repo_mutex);
+    auto it = entries.find(id);
+    return it != entries.end() ? std::make_unique<MemoryEntryAggregate>(*it->second) : nullptr;
+}
+
+std::vector<std::unique_ptr<MemoryEntryAggregate>> MemoryEntryRepository::findAll() {
+    std::shared_lock<std::shared_mutex> lock(repo_mutex);
+    std::vector<std::unique_ptr<MemoryEntryAggregate>> result;
+    for (const auto& [id, entry] : entries) {
+        result.push_back(std::make_unique<MemoryEntryAggregate>(*entry));
+    }
+    return result;
+}
+
+void MemoryEntryRepository::remove(const std::string& id) {
+    std::unique_lock<std::shared_mutex> lock(repo_mutex);
+    entries.erase(id);
+}
+
+std::vector<std::unique_ptr<MemoryEntryAggregate>> MemoryEntryRepository::findByCategory(const std::string& category) {
+    std::shared_lock<std::shared_mutex> lock(repo_mutex);
+    std::vector<std::unique_ptr<MemoryEntryAggregate>> result;
+    for (const auto& [id, entry] : entries) {
+        if (entry->getCategory() == category) {
+            result.push_back(std::make_unique<MemoryEntryAggregate>(*entry));
+        }
+    }
+    return result;
+}
+
+std::vector<std::unique_ptr<MemoryEntryAggregate>> MemoryEntryRepository::searchByProblem(const std::string& query) {
+    std::shared_lock<std::shared_mutex> lock(repo_mutex);
+    std::vector<std::unique_ptr<MemoryEntryAggregate>> result;
+    for (const auto& [id, entry] : entries) {
+        if (entry->getProblem().find(query) != std::string::npos) {
+            result.push_back(std::make_unique<MemoryEntryAggregate>(*entry));
+        }
+    }
+    return result;
+}
+
 MemoryApplicationService::MemoryApplicationService() 
     : domain_engine(std::make_unique<DomainMemoryEngine>()),
       memory_repository(std::make_unique<MemoryEntryRepository>()) {}
@@ -497,6 +1104,14 @@ bool MemoryApplicationService::initialize(const std::unordered_map<std::string,
     return domain_engine->initializeDomain(categories);
 }
 
+bool MemoryApplicationService::initialize(const std::vector<CategoryDefinition>& categories) {
+    return domain_engine->initializeDomain(categories);
+}
+
+bool MemoryApplicationService::openEventStore(const std::string& directory) {
+    return domain_engine->openEventStore(directory);
+}
+
 std::string MemoryApplicationService::createMemoryEntry(const std::string& problem,
                                                        const std::string& solution,
                                                        const std::string& category) {
@@ -515,6 +1130,12 @@ std::string MemoryApplicationService::searchMemories(const std::string& query,
     return domain_engine->searchWithContext(query, category, max_results);
 }
 
+std::string MemoryApplicationService::searchMemoriesBatch(const std::vector<std::string>& queries,
+                                                          const std::vector<std::string>& categories,
+                                                          int max_results) {
+    return domain_engine->searchBatchWithContext(queries, categories, max_results);
+}
+
 std::string MemoryApplicationService::getMemoryEntry(const std::string& entry_id) {
     const auto* entry = domain_engine->getMemoryEntry(entry_id);
     if (!entry) {
@@ -2,32 +2,171 @@
 #define DOMAIN_ENGINE_H
 
 #include "memory_engine.h"
+#include "event_ring.h"
 #include <functional>
-#include <queue>
+#include <variant>
 #include <thread>
 #include <condition_variable>
+#include <deque>
+
+namespace Json {
+class Value;
+}
 
 namespace brains {
 
+class EventStore;
+struct EventStoreOptions;
+
+/**
+ * @brief Dense process-wide id of an event type name
+ */
+using EventTypeId = uint32_t;
+
+/**
+ * @brief Id of an event type name, assigned in order of first use
+ */
+EventTypeId eventTypeId(const std::string& event_type);
+
+/**
+ * @brief Interned name of an event type id; valid for the process lifetime
+ */
+std::string_view eventTypeName(EventTypeId type);
+
+/**
+ * @brief Typed payloads of the events raised by the aggregates
+ *
+ * Each names its event type in TYPE. Payloads stay native C++ values from
+ * raiseEvent through applyEvent and dispatch; DomainEvent::dataJson()
+ * renders them only where events leave the engine.
+ */
+namespace events {
+
+struct MemoryEntryCreated {
+    static constexpr const char* TYPE = "MemoryEntryCreated";
+    std::string problem;
+    std::string solution;
+    std::string category;
+};
+
+struct MemoryEntryUpdated {
+    static constexpr const char* TYPE = "MemoryEntryUpdated";
+    std::string old_solution;
+    std::string new_solution;
+    std::string reason;
+};
+
+struct ConflictDetected {
+    static constexpr const char* TYPE = "ConflictDetected";
+    std::string conflict_id;
+    std::string strategy;
+    int total_conflicts = 0;
+};
+
+struct ConfidenceUpdated {
+    static constexpr const char* TYPE = "ConfidenceUpdated";
+    double old_confidence = 0.0;
+    double new_confidence = 0.0;
+};
+
+struct SearchSessionStarted {
+    static constexpr const char* TYPE = "SearchSessionStarted";
+    std::string query;
+    int64_t started_at = 0; // Seconds since the Unix epoch
+};
+
+struct LayerAdded {
+    static constexpr const char* TYPE = "LayerAdded";
+    std::string layer_type;
+    int layer_order = 0;
+};
+
+struct ResultAdded {
+    static constexpr const char* TYPE = "ResultAdded";
+    std::string result_id;
+    double confidence = 0.0;
+    int total_results = 0;
+};
+
+struct SearchSessionCompleted {
+    static constexpr const char* TYPE = "SearchSessionCompleted";
+    double final_confidence = 0.0;
+    int64_t duration_ms = 0;
+    int layers_used = 0;
+    int results_found = 0;
+};
+
+struct SearchSessionFailed {
+    static constexpr const char* TYPE = "SearchSessionFailed";
+    std::string reason;
+    int64_t duration_ms = 0;
+};
+
+} // namespace events
+
+/**
+ * @brief Event payload: JSON text for events published from outside the
+ *        aggregates, or one of the typed payloads
+ */
+using EventPayload = std::variant<std::string,
+                                  events::MemoryEntryCreated,
+                                  events::MemoryEntryUpdated,
+                                  events::ConflictDetected,
+                                  events::ConfidenceUpdated,
+                                  events::SearchSessionStarted,
+                                  events::LayerAdded,
+                                  events::ResultAdded,
+                                  events::SearchSessionCompleted,
+                                  events::SearchSessionFailed>;
+
 /**
  * @brief Domain Event structure for event-driven architecture
  */
 struct DomainEvent {
     std::string id;
     std::string aggregate_id;
-    std::string event_type;
-    std::string event_data;  // JSON payload
+    std::string_view event_type; // Interned by eventTypeName
+    EventPayload payload;
     std::chrono::system_clock::time_point timestamp;
     int version;
+    EventTypeId type_id;         // eventTypeId(event_type), resolved once at construction
     
     DomainEvent(const std::string& agg_id, const std::string& type, const std::string& data)
-        : aggregate_id(agg_id), event_type(type), event_data(data), version(1) {
+        : aggregate_id(agg_id), payload(data), version(1), type_id(eventTypeId(type)) {
+        event_type = eventTypeName(type_id);
+        timestamp = std::chrono::system_clock::now();
+        id = generateEventId();
+    }
+    
+    /**
+     * @brief Event carrying a typed payload; its type comes from Payload::TYPE
+     */
+    template<typename Payload>
+    DomainEvent(const std::string& agg_id, Payload data)
+        : aggregate_id(agg_id), payload(std::move(data)), version(1), type_id(payloadTypeId<Payload>()) {
+        event_type = eventTypeName(type_id);
         timestamp = std::chrono::system_clock::now();
         id = generateEventId();
     }
     
+    /**
+     * @brief Empty event, as held by pooled queue slots
+     */
+    DomainEvent() : version(0), type_id(0) {}
+    
+    /**
+     * @brief Payload as JSON text, for events crossing into JS or exported
+     */
+    std::string dataJson() const;
+    
 private:
     std::string generateEventId() const;
+    
+    template<typename Payload>
+    static EventTypeId payloadTypeId() {
+        static const EventTypeId type = eventTypeId(Payload::TYPE);
+        return type;
+    }
 };
 
 /**
@@ -35,22 +174,122 @@ private:
  */
 using EventHandler = std::function<void(const DomainEvent&)>;
 
+/**
+ * @brief Handler for a run of events of one type, in publish order
+ */
+using EventBatchHandler = std::function<void(const DomainEvent* events, size_t count)>;
+
+/**
+ * @brief What EventBus::publish does when the event's queue is full
+ */
+enum class OverflowPolicy {
+    BLOCK,                 // Wait for room while the bus is running; a handler's publish is rejected instead
+    DROP_OLDEST,           // Evict the oldest queued event of the worker
+    DROP_NEWEST,           // Reject the published event
+    COALESCE_BY_AGGREGATE  // Keep only the newest pending event per aggregate and type
+};
+
+/**
+ * @brief Sizing and overflow behaviour of an EventBus
+ */
+struct EventBusConfig {
+    size_t worker_count = 0;        // Dispatch threads; 0 picks one per core, up to 4
+    size_t queue_capacity = 4096;   // Events each worker's ring holds; rounded up to a power of two
+    OverflowPolicy overflow_policy = OverflowPolicy::BLOCK; // Engine commands publish with no engine lock held
+    double high_watermark = 0.75;   // Fill ratio at which a queue counts as saturated
+    double low_watermark = 0.25;    // Fill ratio at which a saturated queue recovers
+};
+
 /**
  * @brief High-performance event bus for domain events
+ *
+ * Events are dispatched by a pool of workers, each draining its own bounded
+ * lock-free ring. An event type always maps to the same worker, so handlers
+ * see events of one type in publish order while different types run in
+ * parallel. Publishing takes no lock and wakes the worker only if it is
+ * asleep; a full ring is handled by the configured OverflowPolicy.
+ *
+ * A worker drains up to DISPATCH_BATCH_SIZE events at a time, grouping them
+ * into one contiguous run per type, and dispatches each run through an
+ * immutable subscription table indexed by EventTypeId. subscribe() publishes
+ * a modified copy of the table, so dispatch neither locks nor hashes names.
+ *
+ * Under COALESCE_BY_AGGREGATE, events that find the ring full wait in a
+ * bounded side table, where a newer event replaces the pending one with the
+ * same aggregate and type. Later events join the table until the worker
+ * drains it, so per-type order holds apart from the replaced events.
+ *
+ * A handler publishing from a worker thread never waits under BLOCK: the
+ * ring it waits on may be one only it can drain, so a full ring rejects the
+ * event and counts it as dropped. Publishers must not hold locks that
+ * handlers take while waiting for room.
  */
 class EventBus {
+public:
+    static constexpr size_t MAX_DEFAULT_WORKERS = 4;
+    static constexpr size_t DISPATCH_BATCH_SIZE = 256;
+    
 private:
-    std::unordered_map<std::string, std::vector<EventHandler>> handlers;
-    std::queue<DomainEvent> event_queue;
-    std::mutex queue_mutex;
-    std::condition_variable queue_cv;
+    struct Subscriptions {
+        std::vector<EventHandler> handlers;
+        std::vector<EventBatchHandler> batch_handlers;
+    };
+    
+    // Replaced as a whole on subscribe; indexed by EventTypeId
+    struct SubscriptionTable {
+        std::vector<Subscriptions> by_type;
+    };
+    
+    // One dispatch worker and the ring it drains
+    struct Worker {
+        EventRing<DomainEvent> queue;
+        std::atomic<bool> sleeping{false};
+        std::atomic<bool> saturated{false}; // Above the high watermark until back at the low one
+        std::mutex wake_mutex;
+        std::condition_variable wake_cv;
+        std::thread thread;
+        
+        // Coalesced events waiting for ring room, in arrival order
+        std::mutex overflow_mutex;
+        std::vector<DomainEvent> overflow;
+        std::unordered_map<std::string, size_t> overflow_index; // Aggregate and type id to position
+        std::atomic<size_t> overflow_size{0};
+        
+        explicit Worker(size_t capacity) : queue(capacity) {}
+    };
+    
+    const OverflowPolicy overflow_policy;
+    size_t high_watermark; // In events per ring
+    size_t low_watermark;
+    std::shared_ptr<const SubscriptionTable> subscriptions; // Accessed with std::atomic_load/store
+    std::mutex subscribe_mutex;
+    std::vector<std::unique_ptr<Worker>> workers;
     std::atomic<bool> running{false};
-    std::thread processor_thread;
-    
-    void processEvents();
+    std::atomic<uint64_t> published{0};
+    std::atomic<uint64_t> processed{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> evicted{0};
+    std::atomic<uint64_t> coalesced{0};
+    std::atomic<uint64_t> high_watermark_hits{0};
+    std::atomic<size_t> peak_queue_size{0};
+    
+    Worker& workerFor(EventTypeId type);
+    void wake(Worker& worker);
+    void dispatch(const Subscriptions& subscribed, const DomainEvent* events, size_t count);
+    void processEvents(Worker& worker);
+    void noteQueued(Worker& worker);
+    bool takeOverflow(Worker& worker, std::vector<DomainEvent>& batch);
+    
+    template<typename Update>
+    void updateSubscriptions(const std::string& event_type, Update&& update);
+    
+    template<typename Event>
+    bool enqueue(Event&& event);
+    template<typename Event>
+    bool coalesce(Worker& worker, Event&& event);
     
 public:
-    EventBus();
+    explicit EventBus(const EventBusConfig& config = EventBusConfig());
     ~EventBus();
     
     /**
@@ -58,10 +297,22 @@ public:
      */
     void subscribe(const std::string& event_type, EventHandler handler);
     
+    /**
+     * @brief Subscribe to runs of domain events of one type
+     *
+     * The events stay valid only for the duration of the call.
+     */
+    void subscribeBatch(const std::string& event_type, EventBatchHandler handler);
+    
     /**
      * @brief Publish domain event
+     *
+     * A full queue on a stopped bus rejects the event under every policy.
+     * @return true if the event was queued, possibly by evicting an older
+     *         one or replacing a pending one; false if it was dropped
      */
-    void publish(const DomainEvent& event);
+    bool publish(const DomainEvent& event);
+    bool publish(DomainEvent&& event);
     
     /**
      * @brief Start event processing
@@ -69,7 +320,7 @@ public:
     void start();
     
     /**
-     * @brief Stop event processing
+     * @brief Stop event processing once the queued events are dispatched
      */
     void stop();
     
@@ -105,14 +356,24 @@ public:
      */
     void markEventsAsCommitted();
     
+    /**
+     * @brief Apply a stored event without raising it again, when rebuilding from history
+     */
+    void replayEvent(const DomainEvent& event);
+    
 protected:
     /**
-     * @brief Raise a domain event
+     * @brief Raise a domain event with a typed payload and apply it
+     *
+     * Commands validate and build the payload from the current state but
+     * never change state themselves; applyEvent does, for raised and
+     * replayed events alike.
      */
-    void raiseEvent(const std::string& event_type, const std::string& event_data);
+    template<typename Payload>
+    void raiseEvent(Payload payload);
     
     /**
-     * @brief Apply event to aggregate state
+     * @brief Apply event to aggregate state; the only mutation path
      */
     virtual void applyEvent(const DomainEvent& event) = 0;
 };
@@ -131,8 +392,10 @@ private:
     std::vector<std::string> conflict_ids;
     
 public:
-    MemoryEntryAggregate(const std::string& entry_id, const std::string& prob, 
-                        const std::string& sol, const std::string& cat);
+    /**
+     * @brief Empty entry; its state comes from applying MemoryEntryCreated
+     */
+    explicit MemoryEntryAggregate(const std::string& entry_id);
     
     /**
      * @brief Create new memory entry
@@ -184,7 +447,10 @@ private:
     std::string session_status; // active, completed, failed, timeout
     
 public:
-    SearchSessionAggregate(const std::string& session_id, const std::string& search_query);
+    /**
+     * @brief Empty session; its state comes from applying SearchSessionStarted
+     */
+    explicit SearchSessionAggregate(const std::string& session_id);
     
     /**
      * @brief Create new search session
@@ -230,10 +496,25 @@ private:
 class DomainMemoryEngine : public EnhancedMemoryEngine {
 private:
     std::unique_ptr<EventBus> event_bus;
+    std::unique_ptr<EventStore> event_store; // Set once by openEventStore
     std::unordered_map<std::string, std::unique_ptr<MemoryEntryAggregate>> memory_aggregates;
     std::unordered_map<std::string, std::unique_ptr<SearchSessionAggregate>> search_aggregates;
+    FullTextIndex memory_index; // BM25 over problem and solution text, keyed by entry id
     mutable std::shared_mutex domain_mutex;
     
+    // Serializes commands from reading an aggregate through storing its events
+    // to applying them. Aggregates and the maps change only while it is held
+    // (and domain_mutex exclusively), so commands read them under it alone and
+    // append to the event store without blocking readers. Taken before domain_mutex
+    std::mutex commit_mutex;
+    
+    // Committed events wait here in commit order until the committing thread
+    // has released its engine locks, so publishing (which may wait for queue room)
+    // never holds an engine lock that handlers need. One thread drains at a time
+    std::deque<DomainEvent> outbox; // Guarded by outbox_mutex
+    std::mutex outbox_mutex;        // Innermost lock, never held while publishing
+    bool outbox_draining = false;   // Guarded by outbox_mutex
+    
     // Event handlers
     void handleMemoryEntryCreated(const DomainEvent& event);
     void handleMemoryEntryUpdated(const DomainEvent& event);
@@ -241,7 +522,7 @@ private:
     void handleSearchSessionCompleted(const DomainEvent& event);
     
 public:
-    DomainMemoryEngine();
+    explicit DomainMemoryEngine(const EventBusConfig& event_config = EventBusConfig());
     ~DomainMemoryEngine();
     
     /**
@@ -249,8 +530,32 @@ public:
      */
     bool initializeDomain(const std::unordered_map<std::string, std::vector<std::string>>& categories);
     
+    /**
+     * @brief Initialize with an ordered category table and event handlers
+     */
+    bool initializeDomain(const std::vector<CategoryDefinition>& categories);
+    
+    /**
+     * @brief Rebuild the aggregates from an event store and persist every later event to it
+     * @param directory Segment directory of the store; created if missing
+     * @return true if the store was opened and replayed; false if already open
+     *
+     * Call after initializeDomain and before creating aggregates. Replayed
+     * events are applied to the aggregates and the search index, and each
+     * entry's solutions are stored in the base engine so findSolution
+     * answers as it did before the restart; they are not published again.
+     * From then on each command's events are appended before they are
+     * applied or published, without blocking readers. A failed write
+     * reopens the store and is retried once; a command whose events still
+     * cannot be appended fails, leaving its aggregate unchanged, and the
+     * next command tries the store again.
+     */
+    bool openEventStore(const std::string& directory);
+    bool openEventStore(const std::string& directory, const EventStoreOptions& options);
+    
     /**
      * @brief Create memory entry using domain aggregate
+     * @return Id of the new entry; empty if its events could not be stored
      */
     std::string createMemoryEntry(const std::string& problem, 
                                  const std::string& solution,
@@ -289,12 +594,27 @@ public:
     const SearchSessionAggregate* getSearchSession(const std::string& session_id) const;
     
     /**
-     * @brief Enhanced search with domain aggregates
+     * @brief Full-text search over memory entries, ranked by BM25
+     * @param problem Free-text query
+     * @param category Restrict results to this category (empty for all)
+     * @param max_results Maximum number of results to return
+     * @return JSON-formatted ranked suggestions
      */
     std::string searchWithContext(const std::string& problem,
-                                 const std::string& context = "",
+                                 const std::string& category = "",
                                  int max_results = 5) const;
     
+    /**
+     * @brief Full-text search for several queries under one lock acquisition
+     * @param problems Free-text queries
+     * @param categories Category restriction per query; missing or empty entries search all
+     * @param max_results Maximum number of results per query
+     * @return JSON array of ranked suggestions, one element per query
+     */
+    std::string searchBatchWithContext(const std::vector<std::string>& problems,
+                                      const std::vector<std::string>& categories,
+                                      int max_results = 5) const;
+    
     /**
      * @brief Get domain statistics
      */
@@ -305,8 +625,21 @@ public:
      */
     void subscribeToEvents(const std::string& event_type, EventHandler handler);
     
+    /**
+     * @brief Subscribe to runs of domain events of one type
+     */
+    void subscribeToEventBatches(const std::string& event_type, EventBatchHandler handler);
+    
 private:
-    void commitAggregateEvents(AggregateRoot& aggregate);
+    void startDomainEvents();
+    bool appendEvents(const std::vector<DomainEvent>& events);
+    void applyCommittedEvents(AggregateRoot& aggregate, const std::vector<DomainEvent>& events);
+    void queueCommittedEvents(std::vector<DomainEvent>& events);
+    void publishCommittedEvents();
+    void applyStoredEvent(const DomainEvent& event);
+    void indexMemoryEntry(const MemoryEntryAggregate& entry);
+    void searchLocked(const std::string& problem, const std::string& category, int max_results,
+                      Json::Value& result) const;
     std::string generateAggregateId(const std::string& prefix) const;
 };
 
@@ -365,6 +698,16 @@ public:
      */
     bool initialize(const std::unordered_map<std::string, std::vector<std::string>>& categories);
     
+    /**
+     * @brief Initialize service with an ordered category table
+     */
+    bool initialize(const std::vector<CategoryDefinition>& categories);
+    
+    /**
+     * @brief Persist domain events under directory and restore those stored there
+     */
+    bool openEventStore(const std::string& directory);
+    
     /**
      * @brief Create memory entry
      */
@@ -386,6 +729,13 @@ public:
                               const std::string& category = "",
                               int max_results = 10);
     
+    /**
+     * @brief Search memories for a batch of queries
+     */
+    std::string searchMemoriesBatch(const std::vector<std::string>& queries,
+                                   const std::vector<std::string>& categories = {},
+                                   int max_results = 10);
+    
     /**
      * @brief Get memory entry
      */
@@ -0,0 +1,125 @@
+#include "epoch.h"
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+namespace brains {
+
+// EpochManager Implementation
+EpochManager& EpochManager::instance() {
+    static EpochManager manager;
+    return manager;
+}
+
+EpochManager::~EpochManager() {
+    for (const auto& item : retired) {
+        item.deleter(item.object);
+    }
+}
+
+EpochManager::ThreadState& EpochManager::threadState() {
+    thread_local ThreadState state;
+    return state;
+}
+
+EpochManager::ThreadState::~ThreadState() {
+    if (slot) {
+        EpochManager::instance().releaseSlot(*slot);
+    }
+}
+
+EpochManager::ReaderSlot& EpochManager::acquireSlot() {
+    // Slots are held for the thread's lifetime; wait if every slot is taken
+    while (true) {
+        for (auto& slot : slots) {
+            bool expected = false;
+            if (!slot.claimed.load(std::memory_order_relaxed) &&
+                slot.claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return slot;
+            }
+        }
+        std::this_thread::yield();
+    }
+}
+
+void EpochManager::releaseSlot(ReaderSlot& slot) {
+    slot.epoch.store(QUIESCENT, std::memory_order_release);
+    slot.claimed.store(false, std::memory_order_release);
+}
+
+uint64_t EpochManager::oldestPinnedEpoch() const {
+    // Pairs with the fence in EpochGuard: a reader not yet visible here
+    // will observe every pointer swap made before this call
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    uint64_t oldest = std::numeric_limits<uint64_t>::max();
+    for (const auto& slot : slots) {
+        uint64_t epoch = slot.epoch.load(std::memory_order_acquire);
+        if (epoch != QUIESCENT) {
+            oldest = std::min(oldest, epoch);
+        }
+    }
+    return oldest;
+}
+
+void EpochManager::retire(void* object, void (*deleter)(void*)) {
+    // Readers pinned at or before this epoch may still hold the object
+    uint64_t epoch = global_epoch.fetch_add(1, std::memory_order_seq_cst);
+
+    bool should_reclaim;
+    {
+        std::lock_guard<std::mutex> lock(retired_mutex);
+        retired.push_back({epoch, object, deleter});
+        should_reclaim = retired.size() >= RECLAIM_THRESHOLD;
+    }
+
+    if (should_reclaim) {
+        reclaim();
+    }
+}
+
+void EpochManager::reclaim() {
+    std::vector<RetiredObject> reclaimable;
+    {
+        std::lock_guard<std::mutex> lock(retired_mutex);
+        uint64_t oldest = oldestPinnedEpoch();
+        auto split = std::partition(retired.begin(), retired.end(),
+                                    [oldest](const RetiredObject& item) { return item.epoch >= oldest; });
+        reclaimable.assign(split, retired.end());
+        retired.erase(split, retired.end());
+    }
+
+    for (const auto& item : reclaimable) {
+        item.deleter(item.object);
+    }
+}
+
+size_t EpochManager::pendingCount() const {
+    std::lock_guard<std::mutex> lock(retired_mutex);
+    return retired.size();
+}
+
+// EpochGuard Implementation
+EpochGuard::EpochGuard() {
+    auto& state = EpochManager::threadState();
+    if (state.depth++ > 0) {
+        return;
+    }
+
+    auto& manager = EpochManager::instance();
+    if (!state.slot) {
+        state.slot = &manager.acquireSlot();
+    }
+
+    state.slot->epoch.store(manager.global_epoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+EpochGuard::~EpochGuard() {
+    auto& state = EpochManager::threadState();
+    if (--state.depth == 0) {
+        state.slot->epoch.store(EpochManager::QUIESCENT, std::memory_order_release);
+    }
+}
+
+} // namespace brains
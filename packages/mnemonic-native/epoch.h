@@ -0,0 +1,100 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace brains {
+
+/**
+ * @brief Epoch-based reclamation for lock-free readers
+ *
+ * Readers pin the current epoch with an EpochGuard while they dereference
+ * published pointers; pinning touches only the calling thread's own slot.
+ * Writers swap in a replacement and retire() the old object, which is freed
+ * once every reader that could still see it has unpinned.
+ */
+class EpochManager {
+public:
+    /**
+     * @brief Process-wide manager shared by all engines
+     */
+    static EpochManager& instance();
+
+    /**
+     * @brief Defer deletion of an object until no reader can reference it
+     * @param object Object that has been unpublished by the caller
+     */
+    template<typename T>
+    void retire(const T* object) {
+        retire(const_cast<T*>(object), [](void* p) { delete static_cast<T*>(p); });
+    }
+
+    void retire(void* object, void (*deleter)(void*));
+
+    /**
+     * @brief Free retired objects that no pinned reader can still reference
+     */
+    void reclaim();
+
+    /**
+     * @brief Number of retired objects awaiting reclamation
+     */
+    size_t pendingCount() const;
+
+    ~EpochManager();
+
+private:
+    friend class EpochGuard;
+
+    static constexpr size_t MAX_READER_SLOTS = 256;
+    static constexpr size_t RECLAIM_THRESHOLD = 64;
+    static constexpr uint64_t QUIESCENT = 0;
+
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint64_t> epoch{QUIESCENT};
+        std::atomic<bool> claimed{false};
+    };
+
+    struct ThreadState {
+        ReaderSlot* slot = nullptr;
+        uint32_t depth = 0;
+        ~ThreadState();
+    };
+
+    struct RetiredObject {
+        uint64_t epoch;
+        void* object;
+        void (*deleter)(void*);
+    };
+
+    alignas(64) std::atomic<uint64_t> global_epoch{1};
+    ReaderSlot slots[MAX_READER_SLOTS];
+
+    std::vector<RetiredObject> retired;
+    mutable std::mutex retired_mutex;
+
+    EpochManager() = default;
+    ReaderSlot& acquireSlot();
+    void releaseSlot(ReaderSlot& slot);
+    static ThreadState& threadState();
+    uint64_t oldestPinnedEpoch() const;
+};
+
+/**
+ * @brief RAII read-side critical section; guards may nest
+ */
+class EpochGuard {
+public:
+    EpochGuard();
+    ~EpochGuard();
+
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+};
+
+} // namespace brains
+
+#endif // EPOCH_H
@@ -0,0 +1,137 @@
+#ifndef EVENT_RING_H
+#define EVENT_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace brains {
+
+/**
+ * @brief Bounded lock-free multi-producer multi-consumer ring of pooled slots
+ *
+ * Each slot carries a sequence number that says whose turn it is: a producer
+ * may fill slot i when its sequence equals the enqueue position, a consumer
+ * may take it when the sequence is one past. Positions are claimed with a
+ * compare-exchange, so producers and consumers never share a lock and a full
+ * or empty ring is reported instead of waited on.
+ *
+ * Slot values are constructed once and then assigned, so a value that owns
+ * buffers, such as strings, reuses their capacity from one use of the slot to
+ * the next. Consumers get the value in place and may read it or swap it out.
+ *
+ * T must be default constructible and assignable from the pushed values.
+ */
+template<typename T>
+class EventRing {
+public:
+    /**
+     * @param capacity Minimum slot count; rounded up to a power of two
+     */
+    explicit EventRing(size_t capacity = 1024) {
+        size_t slot_count = 2;
+        while (slot_count < capacity) slot_count *= 2;
+        mask = slot_count - 1;
+        slots.reset(new Slot[slot_count]);
+        for (size_t i = 0; i < slot_count; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    EventRing(const EventRing&) = delete;
+    EventRing& operator=(const EventRing&) = delete;
+
+    /**
+     * @brief Append value unless the ring is full
+     * @return false if every slot is in use
+     */
+    template<typename U>
+    bool tryPush(U&& value) {
+        size_t position = enqueue_position.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots[position & mask];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t turn = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (turn == 0) {
+                if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.value = std::forward<U>(value);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (turn < 0) {
+                return false;
+            } else {
+                position = enqueue_position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Pass the oldest value to consume, then free its slot
+     *
+     * The slot stays claimed while consume runs, so producers that wrap
+     * around to it wait for it like any other full ring.
+     * @return false if the ring is empty
+     */
+    template<typename Consume>
+    bool tryConsume(Consume&& consume) {
+        size_t position = dequeue_position.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots[position & mask];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t turn = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+            if (turn == 0) {
+                if (dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    // Frees the slot even if consume throws
+                    struct Release {
+                        Slot& slot;
+                        size_t next;
+                        ~Release() { slot.sequence.store(next, std::memory_order_release); }
+                    } release{slot, position + mask + 1};
+                    consume(slot.value);
+                    return true;
+                }
+            } else if (turn < 0) {
+                return false;
+            } else {
+                position = dequeue_position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Whether no value is ready to consume
+     */
+    bool empty() const {
+        size_t position = dequeue_position.load(std::memory_order_acquire);
+        return slots[position & mask].sequence.load(std::memory_order_acquire) != position + 1;
+    }
+
+    /**
+     * @brief Values pushed and not yet consumed; approximate under concurrency
+     */
+    size_t size() const {
+        size_t tail = dequeue_position.load(std::memory_order_relaxed);
+        size_t head = enqueue_position.load(std::memory_order_relaxed);
+        return head > tail ? head - tail : 0;
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask = 0;
+    alignas(64) std::atomic<size_t> enqueue_position{0};
+    alignas(64) std::atomic<size_t> dequeue_position{0};
+};
+
+} // namespace brains
+
+#endif // EVENT_RING_H
@@ -0,0 +1,641 @@
+#include "event_store.h"
+#include "wal.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <utility>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace brains {
+
+namespace {
+
+// Every segment starts with [magic][u32 format version][u32 byte order mark]
+constexpr char SEGMENT_MAGIC[8] = {'M', 'N', 'E', 'M', 'E', 'V', 'T', 'S'};
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr uint64_t SEGMENT_HEADER_SIZE = sizeof(SEGMENT_MAGIC) + 2 * sizeof(uint32_t);
+
+constexpr size_t FRAME_HEADER_SIZE = 8;
+constexpr uint32_t MAX_RECORD_SIZE = 64u << 20;
+constexpr size_t VERSION_OFFSET = 4;       // Past kind and reserved
+constexpr size_t AGGREGATE_ID_OFFSET = 16; // Past kind, reserved, version and timestamp
+
+template<typename T>
+void putInt(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void putString(std::string& out, const std::string& value) {
+    putInt(out, static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+
+template<typename T>
+bool getInt(const char*& cursor, const char* end, T& value) {
+    if (static_cast<size_t>(end - cursor) < sizeof(value)) return false;
+    std::memcpy(&value, cursor, sizeof(value));
+    cursor += sizeof(value);
+    return true;
+}
+
+bool getString(const char*& cursor, const char* end, std::string& value) {
+    uint32_t length;
+    if (!getInt(cursor, end, length) || static_cast<size_t>(end - cursor) < length) return false;
+    value.assign(cursor, length);
+    cursor += length;
+    return true;
+}
+
+// Stored tag of each payload type; tags are part of the format, so they are never renumbered or reused
+template<typename T>
+constexpr uint8_t storedKind() {
+    if constexpr (std::is_same_v<T, std::string>) return 0;
+    else if constexpr (std::is_same_v<T, events::MemoryEntryCreated>) return 1;
+    else if constexpr (std::is_same_v<T, events::MemoryEntryUpdated>) return 2;
+    else if constexpr (std::is_same_v<T, events::ConflictDetected>) return 3;
+    else if constexpr (std::is_same_v<T, events::ConfidenceUpdated>) return 4;
+    else if constexpr (std::is_same_v<T, events::SearchSessionStarted>) return 5;
+    else if constexpr (std::is_same_v<T, events::LayerAdded>) return 6;
+    else if constexpr (std::is_same_v<T, events::ResultAdded>) return 7;
+    else if constexpr (std::is_same_v<T, events::SearchSessionCompleted>) return 8;
+    else {
+        static_assert(std::is_same_v<T, events::SearchSessionFailed>, "payload without a stored kind");
+        return 9;
+    }
+}
+
+template<size_t... I>
+constexpr bool distinctKinds(std::index_sequence<I...>) {
+    constexpr uint8_t kinds[] = {storedKind<std::variant_alternative_t<I, EventPayload>>()...};
+    for (size_t i = 0; i < sizeof...(I); ++i) {
+        for (size_t j = i + 1; j < sizeof...(I); ++j) {
+            if (kinds[i] == kinds[j]) return false;
+        }
+    }
+    return true;
+}
+static_assert(distinctKinds(std::make_index_sequence<std::variant_size_v<EventPayload>>()),
+              "two payload types share a stored kind");
+
+// Passes each stored field of a payload to visit, in on-disk order
+template<typename Payload, typename Visit>
+void visitFields(Payload& payload, Visit&& visit) {
+    using T = std::remove_const_t<Payload>;
+    if constexpr (std::is_same_v<T, std::string>) {
+        visit(payload);
+    } else if constexpr (std::is_same_v<T, events::MemoryEntryCreated>) {
+        visit(payload.problem);
+        visit(payload.solution);
+        visit(payload.category);
+    } else if constexpr (std::is_same_v<T, events::MemoryEntryUpdated>) {
+        visit(payload.old_solution);
+        visit(payload.new_solution);
+        visit(payload.reason);
+    } else if constexpr (std::is_same_v<T, events::ConflictDetected>) {
+        visit(payload.conflict_id);
+        visit(payload.strategy);
+        visit(payload.total_conflicts);
+    } else if constexpr (std::is_same_v<T, events::ConfidenceUpdated>) {
+        visit(payload.old_confidence);
+        visit(payload.new_confidence);
+    } else if constexpr (std::is_same_v<T, events::SearchSessionStarted>) {
+        visit(payload.query);
+        visit(payload.started_at);
+    } else if constexpr (std::is_same_v<T, events::LayerAdded>) {
+        visit(payload.layer_type);
+        visit(payload.layer_order);
+    } else if constexpr (std::is_same_v<T, events::ResultAdded>) {
+        visit(payload.result_id);
+        visit(payload.confidence);
+        visit(payload.total_results);
+    } else if constexpr (std::is_same_v<T, events::SearchSessionCompleted>) {
+        visit(payload.final_confidence);
+        visit(payload.duration_ms);
+        visit(payload.layers_used);
+        visit(payload.results_found);
+    } else {
+        static_assert(std::is_same_v<T, events::SearchSessionFailed>, "payload without a stored layout");
+        visit(payload.reason);
+        visit(payload.duration_ms);
+    }
+}
+
+template<typename T>
+void putField(std::string& out, const T& value) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        putString(out, value);
+    } else {
+        putInt(out, value);
+    }
+}
+
+template<typename T>
+bool getField(const char*& cursor, const char* end, T& value) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        return getString(cursor, end, value);
+    } else {
+        return getInt(cursor, end, value);
+    }
+}
+
+// Decodes into the alternative stored as kind, reusing its buffers if the payload already holds it
+template<size_t I = 0>
+bool getPayload(uint8_t kind, const char*& cursor, const char* end, EventPayload& payload) {
+    if constexpr (I < std::variant_size_v<EventPayload>) {
+        if (kind != storedKind<std::variant_alternative_t<I, EventPayload>>()) {
+            return getPayload<I + 1>(kind, cursor, end, payload);
+        }
+        if (payload.index() != I) payload.emplace<I>();
+        bool ok = true;
+        visitFields(std::get<I>(payload), [&](auto& field) { ok = ok && getField(cursor, end, field); });
+        return ok;
+    } else {
+        return false;
+    }
+}
+
+void encode(const DomainEvent& event, std::string& out) {
+    size_t frame_start = out.size();
+    putInt(out, uint32_t(0));
+    putInt(out, uint32_t(0));
+
+    putInt(out, std::visit([](const auto& payload) { return storedKind<std::decay_t<decltype(payload)>>(); },
+                           event.payload));
+    putInt(out, static_cast<uint8_t>(0));
+    putInt(out, static_cast<uint16_t>(0));
+    putInt(out, static_cast<int32_t>(event.version));
+    putInt(out, static_cast<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        event.timestamp.time_since_epoch()).count()));
+    putString(out, event.aggregate_id);
+    putString(out, event.id);
+    putString(out, std::string(event.event_type));
+    std::visit([&](const auto& payload) {
+        visitFields(payload, [&](const auto& field) { putField(out, field); });
+    }, event.payload);
+
+    // Header is filled in place once the payload length is known
+    const char* payload = out.data() + frame_start + FRAME_HEADER_SIZE;
+    uint32_t length = static_cast<uint32_t>(out.size() - frame_start - FRAME_HEADER_SIZE);
+    uint32_t checksum = crc32(payload, length);
+    std::memcpy(&out[frame_start], &length, sizeof(length));
+    std::memcpy(&out[frame_start + sizeof(length)], &checksum, sizeof(checksum));
+}
+
+bool decode(const char* cursor, const char* end, DomainEvent& event, std::string& type_name) {
+    uint8_t kind, flags;
+    uint16_t reserved;
+    int32_t version;
+    int64_t timestamp_us;
+    if (!getInt(cursor, end, kind) || !getInt(cursor, end, flags) || !getInt(cursor, end, reserved) ||
+        !getInt(cursor, end, version) || !getInt(cursor, end, timestamp_us) ||
+        !getString(cursor, end, event.aggregate_id) || !getString(cursor, end, event.id) ||
+        !getString(cursor, end, type_name) || !getPayload(kind, cursor, end, event.payload)) {
+        return false;
+    }
+    event.version = version;
+    event.timestamp = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds(timestamp_us)));
+    if (event.event_type != type_name) {
+        event.type_id = eventTypeId(type_name);
+        event.event_type = eventTypeName(event.type_id);
+    }
+    return cursor == end;
+}
+
+// Checks the frame at cursor; on success payload and length describe its payload
+bool readFrame(const char* cursor, const char* end, const char*& payload, uint32_t& length) {
+    if (static_cast<size_t>(end - cursor) < FRAME_HEADER_SIZE) return false;
+    uint32_t checksum;
+    std::memcpy(&length, cursor, sizeof(length));
+    std::memcpy(&checksum, cursor + sizeof(length), sizeof(checksum));
+    payload = cursor + FRAME_HEADER_SIZE;
+    return length <= MAX_RECORD_SIZE && static_cast<size_t>(end - payload) >= length &&
+           crc32(payload, length) == checksum;
+}
+
+std::string segmentHeader() {
+    std::string header(SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+    putInt(header, EventStore::FORMAT_VERSION);
+    putInt(header, BYTE_ORDER_MARK);
+    return header;
+}
+
+bool validSegmentHeader(const std::vector<char>& data) {
+    uint32_t version, byte_order;
+    std::memcpy(&version, data.data() + sizeof(SEGMENT_MAGIC), sizeof(version));
+    std::memcpy(&byte_order, data.data() + sizeof(SEGMENT_MAGIC) + sizeof(version), sizeof(byte_order));
+    return std::memcmp(data.data(), SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) == 0 &&
+           version == EventStore::FORMAT_VERSION && byte_order == BYTE_ORDER_MARK;
+}
+
+// Reads the first limit bytes of a file, or all of it when limit is 0
+bool readFile(const std::string& path, uint64_t limit, std::vector<char>& data) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+    uint64_t length = static_cast<uint64_t>(in.tellg());
+    if (limit > 0 && limit < length) length = limit;
+    data.resize(static_cast<size_t>(length));
+    in.seekg(0);
+    return static_cast<bool>(in.read(data.data(), static_cast<std::streamsize>(length)));
+}
+
+bool fileExists(const std::string& path) {
+    struct stat info;
+    return ::stat(path.c_str(), &info) == 0;
+}
+
+void makeDirectory(const std::string& path) {
+#ifdef _WIN32
+    ::_mkdir(path.c_str());
+#else
+    ::mkdir(path.c_str(), 0755);
+#endif
+}
+
+int openForAppend(const std::string& path) {
+#ifdef _WIN32
+    return ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#endif
+}
+
+bool writeAll(int fd, const std::string& data) {
+    const char* cursor = data.data();
+    size_t remaining = data.size();
+    while (remaining > 0) {
+#ifdef _WIN32
+        int written = ::_write(fd, cursor, static_cast<unsigned int>(remaining));
+#else
+        ssize_t written = ::write(fd, cursor, remaining);
+#endif
+        if (written <= 0) return false;
+        cursor += written;
+        remaining -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool syncFile(int fd) {
+#ifdef _WIN32
+    return ::_commit(fd) == 0;
+#elif defined(__linux__)
+    return ::fdatasync(fd) == 0;
+#else
+    return ::fsync(fd) == 0;
+#endif
+}
+
+void closeFile(int fd) {
+#ifdef _WIN32
+    ::_close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+bool truncateFile(int fd, uint64_t length) {
+#ifdef _WIN32
+    return ::_chsize_s(fd, static_cast<__int64>(length)) == 0;
+#else
+    return ::ftruncate(fd, static_cast<off_t>(length)) == 0;
+#endif
+}
+
+void syncDirectory(const std::string& directory) {
+#ifndef _WIN32
+    int dir_fd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (dir_fd >= 0) {
+        ::fsync(dir_fd);
+        ::close(dir_fd);
+    }
+#else
+    (void)directory;
+#endif
+}
+
+} // namespace
+
+// EventStore Implementation
+EventStore::EventStore(const EventStoreOptions& options) : options(options) {}
+
+EventStore::~EventStore() {
+    close();
+}
+
+std::string EventStore::segmentPath(size_t segment) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "/events-%06zu.log", segment);
+    return directory + name;
+}
+
+bool EventStore::open(const std::string& store_directory) {
+    std::lock_guard<std::mutex> lock(store_mutex);
+    return openLocked(store_directory);
+}
+
+bool EventStore::reopen() {
+    std::lock_guard<std::mutex> lock(store_mutex);
+    if (directory.empty()) return false;
+    closeLocked();
+    return openLocked(directory);
+}
+
+// Caller must hold store_mutex
+bool EventStore::openLocked(const std::string& store_directory) {
+    if (fd >= 0) return false;
+
+    makeDirectory(store_directory);
+    directory = store_directory;
+    segment_sizes.clear();
+    index.clear();
+    event_count = 0;
+    failed = false;
+
+    // Segments are numbered from 1 without gaps, so they are probed rather than listed
+    size_t segments = 0;
+    while (fileExists(segmentPath(segments + 1))) {
+        ++segments;
+    }
+    for (size_t segment = 1; segment <= segments; ++segment) {
+        if (!scanSegment(segment)) return false;
+    }
+    if (segments == 0) {
+        return startSegment();
+    }
+
+    fd = openForAppend(segmentPath(segments));
+    if (fd < 0) return false;
+
+    // Drop a torn tail so new records are not hidden behind it; a segment
+    // cut off before its header was complete starts over
+    bool headerless = segment_sizes.back() == 0;
+    bool ready = headerless ? truncateFile(fd, 0) && writeAll(fd, segmentHeader()) && syncFile(fd)
+                            : truncateFile(fd, segment_sizes.back()) && syncFile(fd);
+    if (!ready) {
+        closeFile(fd);
+        fd = -1;
+        return false;
+    }
+    if (headerless) segment_sizes.back() = SEGMENT_HEADER_SIZE;
+    return true;
+}
+
+// Caller must hold store_mutex
+bool EventStore::scanSegment(size_t segment) {
+    std::vector<char> data;
+    if (!readFile(segmentPath(segment), 0, data)) return false;
+
+    // Only a crash while a segment was being started leaves it without a whole header
+    if (data.size() < SEGMENT_HEADER_SIZE) {
+        segment_sizes.push_back(0);
+        return true;
+    }
+    if (!validSegmentHeader(data)) return false;
+
+    const char* begin = data.data();
+    const char* end = begin + data.size();
+    const char* cursor = begin + SEGMENT_HEADER_SIZE;
+    std::string aggregate_id;
+    const char* payload;
+    uint32_t length;
+
+    // A corrupt record ends its segment; only the last one is ever appended to again
+    while (readFrame(cursor, end, payload, length)) {
+        const char* version_cursor = payload + VERSION_OFFSET;
+        const char* id_cursor = payload + AGGREGATE_ID_OFFSET;
+        int32_t version;
+        if (length < AGGREGATE_ID_OFFSET || !getInt(version_cursor, payload + length, version) ||
+            !getString(id_cursor, payload + length, aggregate_id)) {
+            break;
+        }
+
+        uint32_t frame_length = static_cast<uint32_t>(FRAME_HEADER_SIZE + length);
+        Stream& stream = index[aggregate_id];
+        stream.locations.push_back(Location{static_cast<uint32_t>(segment), frame_length,
+                                            static_cast<uint64_t>(cursor - begin)});
+        stream.last_version = version;
+        ++event_count;
+        cursor = payload + length;
+    }
+
+    segment_sizes.push_back(static_cast<uint64_t>(cursor - begin));
+    return true;
+}
+
+// Caller must hold store_mutex
+bool EventStore::startSegment() {
+    if (fd >= 0) {
+        // The sealed segment is durable before any record lands in the next one
+        bool synced = syncFile(fd);
+        closeFile(fd);
+        fd = -1;
+        if (!synced) return false;
+    }
+
+    std::string path = segmentPath(segment_sizes.size() + 1);
+    fd = openForAppend(path);
+    if (fd < 0) return false;
+    if (!truncateFile(fd, 0) || !writeAll(fd, segmentHeader())) {
+        closeFile(fd);
+        fd = -1;
+        return false;
+    }
+    syncDirectory(directory);
+    segment_sizes.push_back(SEGMENT_HEADER_SIZE);
+    return true;
+}
+
+bool EventStore::append(const DomainEvent* events, size_t count) {
+    if (count == 0) return true;
+
+    // Encoded outside the lock; offsets are relative to the batch until it is placed
+    std::string batch;
+    std::vector<Location> locations;
+    locations.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        size_t start = batch.size();
+        encode(events[i], batch);
+        locations.push_back(Location{0, static_cast<uint32_t>(batch.size() - start), start});
+    }
+
+    std::lock_guard<std::mutex> lock(store_mutex);
+    if (fd < 0 || failed || !continuesStreams(events, count)) return false;
+
+    if (segment_sizes.back() > SEGMENT_HEADER_SIZE && segment_sizes.back() + batch.size() > options.segment_bytes &&
+        !startSegment()) {
+        failed = true;
+        return false;
+    }
+
+    uint64_t base = segment_sizes.back();
+    if (!writeAll(fd, batch) || (options.sync_commit && !syncFile(fd))) {
+        // Cut off whatever part of the batch reached the file
+        truncateFile(fd, base);
+        failed = true;
+        return false;
+    }
+
+    uint32_t segment = static_cast<uint32_t>(segment_sizes.size());
+    for (size_t i = 0; i < count; ++i) {
+        locations[i].segment = segment;
+        locations[i].offset += base;
+        Stream& stream = index[events[i].aggregate_id];
+        stream.locations.push_back(locations[i]);
+        stream.last_version = events[i].version;
+    }
+    segment_sizes.back() += batch.size();
+    event_count += count;
+    return true;
+}
+
+// Caller must hold store_mutex
+bool EventStore::continuesStreams(const DomainEvent* events, size_t count) const {
+    for (size_t i = 0; i < count; ++i) {
+        // The previous version is the latest earlier event of the aggregate in this batch, or else the stored one
+        int32_t previous = 0;
+        size_t earlier = i;
+        while (earlier > 0 && events[earlier - 1].aggregate_id != events[i].aggregate_id) {
+            --earlier;
+        }
+        if (earlier > 0) {
+            previous = events[earlier - 1].version;
+        } else if (auto it = index.find(events[i].aggregate_id); it != index.end()) {
+            previous = it->second.last_version;
+        }
+        if (events[i].version != previous + 1) return false;
+    }
+    return true;
+}
+
+bool EventStore::sync() {
+    std::lock_guard<std::mutex> lock(store_mutex);
+    if (fd < 0 || failed) return false;
+    return syncFile(fd);
+}
+
+size_t EventStore::replay(const std::string& aggregate_id, const EventHandler& visit) const {
+    std::vector<Location> locations;
+    {
+        std::lock_guard<std::mutex> lock(store_mutex);
+        auto it = index.find(aggregate_id);
+        if (it == index.end()) return 0;
+        locations = it->second.locations;
+    }
+
+    std::ifstream in;
+    size_t open_segment = 0;
+    std::vector<char> frame;
+    DomainEvent event;
+    std::string type_name;
+    size_t visited = 0;
+
+    for (const auto& location : locations) {
+        if (location.segment != open_segment) {
+            in.close();
+            in.clear();
+            in.open(segmentPath(location.segment), std::ios::binary);
+            open_segment = location.segment;
+        }
+
+        frame.resize(location.length);
+        const char* payload;
+        uint32_t length;
+        if (!in.seekg(static_cast<std::streamoff>(location.offset)) ||
+            !in.read(frame.data(), static_cast<std::streamsize>(location.length)) ||
+            !readFrame(frame.data(), frame.data() + frame.size(), payload, length) ||
+            !decode(payload, payload + length, event, type_name)) {
+            break;
+        }
+
+        visit(event);
+        ++visited;
+    }
+    return visited;
+}
+
+size_t EventStore::replayAll(const EventHandler& visit) const {
+    std::vector<uint64_t> sizes;
+    {
+        std::lock_guard<std::mutex> lock(store_mutex);
+        sizes = segment_sizes;
+    }
+
+    // Each segment is read in one sequential pass and decoded from memory
+    std::vector<char> data;
+    DomainEvent event;
+    std::string type_name;
+    size_t visited = 0;
+
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        if (sizes[i] <= SEGMENT_HEADER_SIZE || !readFile(segmentPath(i + 1), sizes[i], data)) continue;
+
+        const char* cursor = data.data() + SEGMENT_HEADER_SIZE;
+        const char* end = data.data() + data.size();
+        const char* payload;
+        uint32_t length;
+        while (readFrame(cursor, end, payload, length) && decode(payload, payload + length, event, type_name)) {
+            visit(event);
+            ++visited;
+            cursor = payload + length;
+        }
+    }
+    return visited;
+}
+
+bool EventStore::hasFailed() const {
+    std::lock_guard<std::mutex> lock(store_mutex);
+    return failed;
+}
+
+uint64_t EventStore::eventCount() const {
+    std::lock_guard<std::mutex> lock(store_mutex);
+    return event_count;
+}
+
+size_t EventStore::aggregateCount() const {
+    std::lock_guard<std::mutex> lock(store_mutex);
+    return index.size();
+}
+
+size_t EventStore::segmentCount() const {
+    std::lock_guard<std::mutex> lock(store_mutex);
+    return segment_sizes.size();
+}
+
+uint64_t EventStore::size() const {
+    std::lock_guard<std::mutex> lock(store_mutex);
+    uint64_t total = 0;
+    for (uint64_t segment_size : segment_sizes) {
+        total += segment_size > SEGMENT_HEADER_SIZE ? segment_size - SEGMENT_HEADER_SIZE : 0;
+    }
+    return total;
+}
+
+void EventStore::close() {
+    std::lock_guard<std::mutex> lock(store_mutex);
+    closeLocked();
+}
+
+// Caller must hold store_mutex
+void EventStore::closeLocked() {
+    if (fd >= 0) {
+        syncFile(fd);
+        closeFile(fd);
+        fd = -1;
+    }
+    failed = false;
+}
+
+} // namespace brains
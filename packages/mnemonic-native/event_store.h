@@ -0,0 +1,150 @@
+#ifndef EVENT_STORE_H
+#define EVENT_STORE_H
+
+#include "domain_engine.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+
+namespace brains {
+
+/**
+ * @brief Event store tuning
+ */
+struct EventStoreOptions {
+    uint64_t segment_bytes = 64 << 20; // Segment size at which appends move on to a new segment file
+    bool sync_commit = true;           // append() returns only once the events are on disk
+};
+
+/**
+ * @brief Append-only, segmented, CRC-checked log of domain events
+ *
+ * Events are appended to numbered segment files (events-000001.log, ...)
+ * in a directory; once the active segment reaches segment_bytes the next
+ * append starts a new one, and sealed segments are never rewritten. Each
+ * segment starts with a header holding a magic, FORMAT_VERSION and a byte
+ * order mark. Records use the write-ahead log framing, [u32 payload
+ * length][u32 CRC-32 of payload][payload], with the payload type stored as
+ * a fixed kind tag and its fields stored one by one, so replay decodes
+ * events without parsing JSON.
+ *
+ * Each aggregate's events form a stream numbered by DomainEvent::version
+ * from 1, and an append must continue the streams it writes to, so two
+ * aggregates that happen to share an id cannot interleave their histories.
+ *
+ * An in-memory index maps each aggregate id to the offsets of its events;
+ * it is rebuilt by scanning the segments on open(), which also truncates a
+ * torn tail of the last segment. replay() reads one aggregate's records
+ * through the index, replayAll() streams every segment sequentially.
+ */
+class EventStore {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    explicit EventStore(const EventStoreOptions& options = EventStoreOptions());
+    ~EventStore();
+
+    EventStore(const EventStore&) = delete;
+    EventStore& operator=(const EventStore&) = delete;
+
+    /**
+     * @brief Index the segments in directory and open the last one for appending
+     * @param directory Segment directory; created if missing
+     * @return true if the store is ready for appends; false if already open,
+     *         or if a segment cannot be read or has another format's header
+     */
+    bool open(const std::string& directory);
+
+    /**
+     * @brief Close the store and open its directory again
+     *
+     * Clears a failed append: the rescan drops whatever part of it reached
+     * the last segment, and appends resume if the store opens.
+     * @return false if the store was never opened or cannot be opened again
+     */
+    bool reopen();
+
+    /**
+     * @brief Sync and release the active segment; open() may then be called again
+     */
+    void close();
+
+    /**
+     * @brief Append events in order with a single write
+     *
+     * The events of one call always land in the same segment.
+     * @return false if an event's version is not one past the previous
+     *         version of its aggregate (stored or earlier in this call), if
+     *         the store is closed, or if a write has failed; a failed store
+     *         refuses further appends until reopen()
+     */
+    bool append(const DomainEvent* events, size_t count);
+
+    /**
+     * @brief Make every appended event durable; needed only without sync_commit
+     */
+    bool sync();
+
+    /**
+     * @brief Whether a write has failed since the store was last opened
+     */
+    bool hasFailed() const;
+
+    /**
+     * @brief Visit the stored events of one aggregate in append order
+     * @return Number of events visited
+     */
+    size_t replay(const std::string& aggregate_id, const EventHandler& visit) const;
+
+    /**
+     * @brief Visit every stored event in append order, one segment at a time
+     * @return Number of events visited
+     */
+    size_t replayAll(const EventHandler& visit) const;
+
+    uint64_t eventCount() const;
+    size_t aggregateCount() const;
+    size_t segmentCount() const;
+
+    /**
+     * @brief Bytes of valid records across all segments, headers excluded
+     */
+    uint64_t size() const;
+
+private:
+    // Where one record's frame starts, and its length including the header
+    struct Location {
+        uint32_t segment;
+        uint32_t length;
+        uint64_t offset;
+    };
+
+    // One aggregate's records in append order
+    struct Stream {
+        std::vector<Location> locations;
+        int32_t last_version = 0;
+    };
+
+    EventStoreOptions options;
+    std::string directory;
+
+    mutable std::mutex store_mutex; // Guards everything below; never held while visiting
+    std::vector<uint64_t> segment_sizes; // Valid bytes per segment with its header, segment n at n - 1
+    std::unordered_map<std::string, Stream> index;
+    uint64_t event_count = 0;
+    int fd = -1;            // Active (last) segment
+    bool failed = false;
+
+    std::string segmentPath(size_t segment) const;
+    bool openLocked(const std::string& store_directory);
+    bool scanSegment(size_t segment);
+    bool continuesStreams(const DomainEvent* events, size_t count) const;
+    bool startSegment();
+    void closeLocked();
+};
+
+} // namespace brains
+
+#endif // EVENT_STORE_H
@@ -3,10 +3,31 @@
  * Used when C++ addon compilation fails
  */
 
+const DEFAULT_CONFLICT_POLICY = {
+  recentProjectThresholdDays: 30,
+  ageDifferenceThresholdDays: 90,
+  popularityRatioThreshold: 3,
+  globalMaxAgeDays: 180
+};
+
+// Overrides that are not numbers, or are NaN, keep the base value like the native engine;
+// Infinity switches a threshold's rule off
+function mergeConflictPolicy(base, overrides = {}) {
+  const policy = { ...base };
+  for (const [key, value] of Object.entries(overrides)) {
+    if (key in base && typeof value === 'number' && !Number.isNaN(value)) {
+      policy[key] = value;
+    }
+  }
+  return policy;
+}
+
 class JSMemoryEngine {
   constructor() {
     this.categoryIndex = new Map();
     this.errorPatterns = new Map();
+    this.conflictPolicies = new Map();
+    this.defaultConflictPolicy = DEFAULT_CONFLICT_POLICY;
     this.stats = {
       totalLookups: 0,
       cacheHits: 0,
@@ -14,11 +35,30 @@ class JSMemoryEngine {
     };
   }
 
-  initialize(categories) {
+  initialize(categories, options = {}) {
     try {
       this.errorPatterns.clear();
+      this.conflictPolicies.clear();
+      this.defaultConflictPolicy = mergeConflictPolicy(DEFAULT_CONFLICT_POLICY, options.conflictPolicy);
+
+      // Match order follows priority (lower first), then declaration order
+      const ordered = Object.entries(categories).map(([category, definition], index) => {
+        const isDefinition = definition && typeof definition === 'object' && !Array.isArray(definition);
+        return {
+          category,
+          patterns: [].concat(isDefinition ? (definition.patterns || []) : definition),
+          priority: isDefinition ? (definition.priority || 0) : 0,
+          index
+        };
+      });
+      for (const [category, definition] of Object.entries(categories)) {
+        if (definition && definition.conflictPolicy) {
+          this.conflictPolicies.set(category, mergeConflictPolicy(this.defaultConflictPolicy, definition.conflictPolicy));
+        }
+      }
+      ordered.sort((a, b) => (a.priority - b.priority) || (a.index - b.index));
       
-      for (const [category, patterns] of Object.entries(categories)) {
+      for (const { category, patterns } of ordered) {
         const compiledPatterns = [];
         for (const pattern of patterns) {
           try {
@@ -96,60 +136,147 @@ class JSMemoryEngine {
         return null;
       }
 
-      const categoryData = this.categoryIndex.get(category);
-      const projectSolution = categoryData.project.get(problem);
-      const globalSolution = categoryData.global.get(problem);
+      const result = this._resolve(this.categoryIndex.get(category), problem, this._policyFor(category));
+
+      if (result) {
+        this.stats.cacheHits++;
+        result.solution.use_count++;
+      }
 
-      let result = null;
+      const endTime = Date.now();
+      this.stats.totalLookupTimeMs += (endTime - startTime);
 
-      if (projectSolution && !globalSolution) {
+      return result;
+    } catch (error) {
+      console.error('JS fallback findSolution error:', error);
+      return null;
+    }
+  }
+
+  findSolutions(problems, categories = []) {
+    return problems.map((problem, i) => {
+      const category = Array.isArray(categories) ? categories[i] : categories;
+      return this.findSolution(problem, category || '');
+    });
+  }
+
+  _policyFor(category) {
+    return this.conflictPolicies.get(category) || this.defaultConflictPolicy;
+  }
+
+  _resolve(categoryData, problem, policy) {
+    const projectSolution = categoryData.project.get(problem);
+    const globalSolution = categoryData.global.get(problem);
+
+    let result = null;
+
+    if (projectSolution && !globalSolution) {
+      result = {
+        solution: projectSolution,
+        conflict_resolution: 'default_local_preference',
+        reason: 'Only project solution available'
+      };
+    } else if (globalSolution && !projectSolution) {
+      // Check if global solution is recent enough (6 months by default)
+      const createdDate = new Date(globalSolution.created_date);
+      const oldestRecent = new Date();
+      oldestRecent.setDate(oldestRecent.getDate() - policy.globalMaxAgeDays);
+
+      if (createdDate > oldestRecent) {
         result = {
-          solution: projectSolution,
+          solution: globalSolution,
           conflict_resolution: 'default_local_preference',
-          reason: 'Only project solution available'
+          reason: 'Only recent global solution available'
         };
-      } else if (globalSolution && !projectSolution) {
-        // Check if global solution is recent enough (6 months)
-        const createdDate = new Date(globalSolution.created_date);
-        const sixMonthsAgo = new Date();
-        sixMonthsAgo.setMonth(sixMonthsAgo.getMonth() - 6);
-
-        if (createdDate > sixMonthsAgo) {
-          result = {
-            solution: globalSolution,
-            conflict_resolution: 'default_local_preference',
-            reason: 'Only recent global solution available'
-          };
+      }
+    } else if (projectSolution && globalSolution) {
+      // Apply conflict resolution
+      result = this._resolveConflict(projectSolution, globalSolution, policy);
+    }
+
+    return result;
+  }
+
+  findSimilarSolution(problem, category = '', minScore = 0.5) {
+    try {
+      const startTime = Date.now();
+      this.stats.totalLookups++;
+
+      if (!category) {
+        category = this.categorizeError(problem);
+      }
+
+      // Prefer the expected category, then look for a better match elsewhere
+      const ordered = [...this.categoryIndex.keys()].sort((a, b) => (b === category) - (a === category));
+      let best = null;
+
+      for (const name of ordered) {
+        const categoryData = this.categoryIndex.get(name);
+        const policy = this._policyFor(name);
+        const exact = this._resolve(categoryData, problem, policy);
+        if (exact) {
+          best = { ...exact, category: name, problem, score: 1 };
+          break;
+        }
+
+        const candidates = new Set([...categoryData.project.keys(), ...categoryData.global.keys()]);
+        for (const candidate of candidates) {
+          const score = this._similarity(problem, candidate);
+          if (score < minScore || (best && score <= best.score)) continue;
+          const result = this._resolve(categoryData, candidate, policy);
+          if (result) {
+            best = { ...result, category: name, problem: candidate, score };
+          }
         }
-      } else if (projectSolution && globalSolution) {
-        // Apply conflict resolution
-        result = this._resolveConflict(projectSolution, globalSolution);
       }
 
-      if (result) {
+      if (best) {
         this.stats.cacheHits++;
       }
 
       const endTime = Date.now();
       this.stats.totalLookupTimeMs += (endTime - startTime);
 
-      return result;
+      return best;
     } catch (error) {
-      console.error('JS fallback findSolution error:', error);
+      console.error('JS fallback findSimilarSolution error:', error);
       return null;
     }
   }
 
-  _resolveConflict(projectSolution, globalSolution) {
+  // Mirrors the native ProblemMatchIndex: token Dice blended with trigram Dice
+  _similarity(a, b) {
+    const words = (text) => text.toLowerCase().split(/[^a-z0-9\u0080-\uffff]+/).filter(Boolean);
+    const tokens = (text) => new Set(words(text).filter(word => word.length >= 3));
+    const trigrams = (text) => {
+      const padded = ` ${words(text).join(' ')} `;
+      const grams = new Set();
+      for (let i = 0; i + 3 <= padded.length; i++) grams.add(padded.slice(i, i + 3));
+      return grams;
+    };
+    const dice = (x, y) => {
+      if (x.size === 0 || y.size === 0) return 0;
+      let shared = 0;
+      for (const item of x) if (y.has(item)) shared++;
+      return 2 * shared / (x.size + y.size);
+    };
+
+    const tokenScore = dice(tokens(a), tokens(b));
+    if (tokenScore === 0) return 0;
+    const trigramScore = dice(trigrams(a), trigrams(b));
+    return trigramScore === 1 ? 1 : 0.4 * tokenScore + 0.6 * trigramScore;
+  }
+
+  _resolveConflict(projectSolution, globalSolution, policy = this.defaultConflictPolicy) {
     const projectDate = new Date(projectSolution.created_date);
     const globalDate = new Date(globalSolution.created_date);
     const now = new Date();
 
     // Rule 1: Recent project solutions (< 30 days) always win
-    const thirtyDaysAgo = new Date();
-    thirtyDaysAgo.setDate(thirtyDaysAgo.getDate() - 30);
+    const recentSince = new Date();
+    recentSince.setDate(recentSince.getDate() - policy.recentProjectThresholdDays);
 
-    if (projectDate > thirtyDaysAgo) {
+    if (projectDate > recentSince) {
       return {
         solution: projectSolution,
         conflict_resolution: 'recent_project_priority',
@@ -160,7 +287,7 @@ class JSMemoryEngine {
     // Rule 2: Newer solution if age difference > 90 days
     const ageDiffDays = Math.abs(projectDate.getTime() - globalDate.getTime()) / (1000 * 60 * 60 * 24);
 
-    if (ageDiffDays > 90) {
+    if (ageDiffDays > policy.ageDifferenceThresholdDays) {
       const newerSolution = projectDate > globalDate ? projectSolution : globalSolution;
       return {
         solution: newerSolution,
@@ -173,7 +300,7 @@ class JSMemoryEngine {
     const useCountRatio = Math.max(projectSolution.use_count, globalSolution.use_count) /
                          Math.min(projectSolution.use_count, globalSolution.use_count);
 
-    if (useCountRatio > 3) {
+    if (useCountRatio > policy.popularityRatioThreshold) {
       const popularSolution = projectSolution.use_count > globalSolution.use_count ? 
                               projectSolution : globalSolution;
       return {
@@ -257,6 +384,56 @@ class JSMemoryEngine {
       return false;
     }
   }
+
+  // Binary snapshots are a native-engine feature; callers fall back to YAML
+  saveSnapshot() {
+    return false;
+  }
+
+  loadSnapshot() {
+    return false;
+  }
+
+  // Without a write-ahead log callers keep persisting through YAML
+  openWriteAheadLog() {
+    return false;
+  }
+
+  compact() {
+    return false;
+  }
+
+  flushUseCounts() {
+    return 0;
+  }
+
+  // Memory files are parsed natively; callers fall back to js-yaml
+  loadFromFile() {
+    return false;
+  }
+
+  // Promise-returning variants matching the native addon; the fallback
+  // has no worker pool, so these complete synchronously
+  storeSolutionAsync(...args) {
+    return Promise.resolve(this.storeSolution(...args));
+  }
+
+  findSolutionAsync(...args) {
+    return Promise.resolve(this.findSolution(...args));
+  }
+
+  findSolutionsAsync(...args) {
+    return Promise.resolve(this.findSolutions(...args));
+  }
+
+  findSimilarSolutionAsync(...args) {
+    return Promise.resolve(this.findSimilarSolution(...args));
+  }
+
+  loadSolutionsAsync(category, solutions, isGlobal = false) {
+    return Promise.resolve(this.loadSolutions(category, solutions, isGlobal))
+      .then(loaded => loaded && Object.keys(solutions).length);
+  }
 }
 
 module.exports = JSMemoryEngine;
\ No newline at end of file
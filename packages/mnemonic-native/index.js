@@ -26,18 +26,38 @@ class BrainsMemoryEngine {
 
   /**
    * Initialize the engine with error categories
+   * Categories are matched in declaration order unless an explicit priority is
+   * given; lower priorities are matched first. historyCapacity sets how many
+   * solutions each problem in the category keeps per source (default 5).
+   * conflictPolicy overrides the thresholds of conflict resolution:
+   * { recentProjectThresholdDays: 30, ageDifferenceThresholdDays: 90,
+   *   popularityRatioThreshold: 3, globalMaxAgeDays: 180 }; a
+   *   popularityRatioThreshold of Infinity switches the popularity rule off.
    * @param {Object} categories - Map of category names to regex pattern arrays
+   *   or to { patterns: string[], priority: number, historyCapacity: number,
+   *   conflictPolicy: Object } definitions
+   * @param {Object} [options]
+   * @param {Object} [options.conflictPolicy] - Policy of categories that set none
    * @returns {boolean} Success status
    */
-  initialize(categories = {}) {
+  initialize(categories = {}, options = {}) {
     try {
       // Convert single patterns to arrays for consistency
       const processedCategories = {};
       for (const [category, patterns] of Object.entries(categories)) {
-        processedCategories[category] = Array.isArray(patterns) ? patterns : [patterns];
+        if (patterns && typeof patterns === 'object' && !Array.isArray(patterns)) {
+          processedCategories[category] = {
+            patterns: [].concat(patterns.patterns || []),
+            priority: patterns.priority || 0,
+            historyCapacity: patterns.historyCapacity || 0,
+            conflictPolicy: patterns.conflictPolicy
+          };
+        } else {
+          processedCategories[category] = Array.isArray(patterns) ? patterns : [patterns];
+        }
       }
 
-      this.initialized = this.engine.initialize(processedCategories);
+      this.initialized = this.engine.initialize(processedCategories, options);
       return this.initialized;
     } catch (error) {
       console.error('Failed to initialize memory engine:', error);
@@ -90,6 +110,45 @@ class BrainsMemoryEngine {
     }
   }
 
+  /**
+   * Find solutions for a batch of problems in one native call
+   * @param {string[]} problems - Problem descriptions
+   * @param {string[]|string} categories - Category hint per problem, or one hint for all
+   * @returns {Array<Object|null>} Solution result or null per problem, in input order
+   */
+  findSolutions(problems, categories = []) {
+    if (!this.initialized) {
+      throw new Error('Memory engine not initialized');
+    }
+
+    try {
+      return this.engine.findSolutions(problems, categories);
+    } catch (error) {
+      console.error('Failed to find solutions:', error);
+      return problems.map(() => null);
+    }
+  }
+
+  /**
+   * Find a solution for the closest stored problem
+   * @param {string} problem - Problem description, matched approximately
+   * @param {string} category - Optional category hint; other categories are searched if it has no match
+   * @param {number} minScore - Minimum similarity between 0 and 1
+   * @returns {Object|null} Solution result with the matched category, problem and score
+   */
+  findSimilarSolution(problem, category = '', minScore = 0.5) {
+    if (!this.initialized) {
+      throw new Error('Memory engine not initialized');
+    }
+
+    try {
+      return this.engine.findSimilarSolution(problem, category, minScore);
+    } catch (error) {
+      console.error('Failed to find similar solution:', error);
+      return null;
+    }
+  }
+
   /**
    * Categorize an error message
    * @param {string} errorMessage - Error message to categorize
@@ -163,6 +222,217 @@ class BrainsMemoryEngine {
     }
   }
 
+  /**
+   * Write the engine's contents to a binary snapshot for fast warm starts
+   * @param {string} snapshotPath - Destination file; replaced atomically
+   * @returns {boolean} Success status
+   */
+  saveSnapshot(snapshotPath) {
+    if (!this.initialized) {
+      throw new Error('Memory engine not initialized');
+    }
+
+    try {
+      return this.engine.saveSnapshot(snapshotPath);
+    } catch (error) {
+      console.error('Failed to save snapshot:', error);
+      return false;
+    }
+  }
+
+  /**
+   * Serve lookups from a snapshot written by saveSnapshot
+   * @param {string} snapshotPath - Snapshot file
+   * @returns {boolean} False if the file is missing, invalid or unsupported
+   */
+  loadSnapshot(snapshotPath) {
+    if (!this.initialized) {
+      throw new Error('Memory engine not initialized');
+    }
+
+    try {
+      return this.engine.loadSnapshot(snapshotPath);
+    } catch (error) {
+      console.error('Failed to load snapshot:', error);
+      return false;
+    }
+  }
+
+  /**
+   * Log every store to an append-only write-ahead log
+   * Existing records are replayed first; load the snapshot before calling
+   * @param {string} walPath - Log file; created if missing
+   * @param {string} snapshotPath - Snapshot the log is compacted into
+   * @param {Object} options - { syncCommit, flushIntervalMs, compactBytes }
+   * @returns {boolean} False if the log cannot be opened or is already open
+   */
+  openWriteAheadLog(walPath, snapshotPath, options = {}) {
+    if (!this.initialized) {
+      throw new Error('Memory engine not initialized');
+    }
+
+    try {
+      return this.engine.openWriteAheadLog(walPath, snapshotPath, options);
+    } catch (error) {
+      console.error('Failed to open write-ahead log:', error);
+      return false;
+    }
+  }
+
+  /**
+   * Fold the write-ahead log into its snapshot and start an empty log
+   * @returns {boolean} Success status
+   */
+  compact() {
+    if (!this.initialized) {
+      throw new Error('Memory engine not initialized');
+    }
+
+    try {
+      return this.engine.compact();
+    } catch (error) {
+      console.error('Failed to compact write-ahead log:', error);
+      return false;
+    }
+  }
+
+  /**
+   * Log the use counts raised by lookups since the last flush
+   * Hits are otherwise persisted only by compact() and saveSnapshot()
+   * @returns {number} Number of solutions whose count was logged
+   */
+  flushUseCounts() {
+    if (!this.initialized) {
+      throw new Error('Memory engine not initialized');
+    }
+
+    try {
+      return this.engine.flushUseCounts();
+    } catch (error) {
+      console.error('Failed to flush use counts:', error);
+      return 0;
+    }
+  }
+
+  /**
+   * Load a structured memory file (YAML or JSON) natively, keeping each
+   * solution's created_date and use_count
+   * @param {string} filePath - File in the structured_memory.yaml layout
+   * @param {boolean} isGlobal - Whether its solutions are global
+   * @returns {number|boolean} Solutions read, or false if the file could not be loaded
+   */
+  loadFromFile(filePath, isGlobal = false) {
+    if (!this.initialized) {
+      throw new Error('Memory engine not initialized');
+    }
+
+    try {
+      return this.engine.loadFromFile(filePath, isGlobal);
+    } catch (error) {
+      console.error('Failed to load memory file:', error.message);
+      return false;
+    }
+  }
+
+  /**
+   * Store a solution without blocking the event loop
+   * @param {string} problem - Problem description
+   * @param {string} category - Problem category (empty for auto-categorization)
+   * @param {string} solution - Solution content
+   * @param {boolean} isGlobal - Whether to store as global solution
+   * @returns {Promise<boolean>} Success status
+   */
+  async storeSolutionAsync(problem, category = '', solution, isGlobal = false) {
+    if (!this.initialized) {
+      throw new Error('Memory engine not initialized');
+    }
+
+    try {
+      return await this.engine.storeSolutionAsync(problem, category, solution, isGlobal);
+    } catch (error) {
+      console.error('Failed to store solution:', error);
+      return false;
+    }
+  }
+
+  /**
+   * Find a solution without blocking the event loop
+   * @param {string} problem - Problem description
+   * @param {string} category - Optional category hint
+   * @returns {Promise<Object|null>} Solution result with conflict resolution metadata
+   */
+  async findSolutionAsync(problem, category = '') {
+    if (!this.initialized) {
+      throw new Error('Memory engine not initialized');
+    }
+
+    try {
+      return await this.engine.findSolutionAsync(problem, category);
+    } catch (error) {
+      console.error('Failed to find solution:', error);
+      return null;
+    }
+  }
+
+  /**
+   * Find solutions for a batch of problems without blocking the event loop
+   * @param {string[]} problems - Problem descriptions
+   * @param {string[]|string} categories - Category hint per problem, or one hint for all
+   * @returns {Promise<Array<Object|null>>} Solution result or null per problem, in input order
+   */
+  async findSolutionsAsync(problems, categories = []) {
+    if (!this.initialized) {
+      throw new Error('Memory engine not initialized');
+    }
+
+    try {
+      return await this.engine.findSolutionsAsync(problems, categories);
+    } catch (error) {
+      console.error('Failed to find solutions:', error);
+      return problems.map(() => null);
+    }
+  }
+
+  /**
+   * Find a solution for the closest stored problem without blocking the event loop
+   * @param {string} problem - Problem description, matched approximately
+   * @param {string} category - Optional category hint
+   * @param {number} minScore - Minimum similarity between 0 and 1
+   * @returns {Promise<Object|null>} Solution result with the matched category, problem and score
+   */
+  async findSimilarSolutionAsync(problem, category = '', minScore = 0.5) {
+    if (!this.initialized) {
+      throw new Error('Memory engine not initialized');
+    }
+
+    try {
+      return await this.engine.findSimilarSolutionAsync(problem, category, minScore);
+    } catch (error) {
+      console.error('Failed to find similar solution:', error);
+      return null;
+    }
+  }
+
+  /**
+   * Bulk load solutions without blocking the event loop
+   * @param {string} category - Category name
+   * @param {Object} solutions - Map of problem to solution content
+   * @param {boolean} isGlobal - Whether these are global solutions
+   * @returns {Promise<number|boolean>} Number of solutions loaded, or false on failure
+   */
+  async loadSolutionsAsync(category, solutions, isGlobal = false) {
+    if (!this.initialized) {
+      throw new Error('Memory engine not initialized');
+    }
+
+    try {
+      return await this.engine.loadSolutionsAsync(category, solutions, isGlobal);
+    } catch (error) {
+      console.error('Failed to load solutions:', error);
+      return false;
+    }
+  }
+
   /**
    * Get engine type (for debugging)
    * @returns {string} Engine type
@@ -1,180 +1,1031 @@
 #include "memory_engine.h"
+#include "memory_file.h"
 #include <algorithm>
 #include <chrono>
 #include <sstream>
 #include <iomanip>
 #include <ctime>
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <unordered_set>
 
 namespace brains {
 
+namespace {
+
+constexpr int64_t SECONDS_PER_DAY = 24 * 60 * 60;
+
+Solution fromSnapshot(const SnapshotSolution& stored) {
+    Solution solution(stored.content, stored.is_global ? SolutionSource::GLOBAL : SolutionSource::PROJECT);
+    solution.created = stored.created;
+    solution.use_count = stored.use_count;
+    return solution;
+}
+
+SnapshotSolution toSnapshot(const Solution& solution, bool is_global) {
+    return {solution.content, solution.created, solution.use_count, is_global};
+}
+
+size_t loadThreads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// A cached conflict decision packs, into one word, which solution the
+// time-dependent rules pick, why, and the time from which they must be re-run
+enum DecisionPick : uint64_t { PICK_NONE, PICK_PROJECT, PICK_GLOBAL, PICK_BY_USE_COUNT };
+constexpr int64_t DECISION_NEVER_EXPIRES = (int64_t(1) << 55) - 1;
+
+uint64_t packDecision(DecisionPick pick, ResolutionReason reason, int64_t expires) {
+    // Expiry is at least 1, so a packed decision is never 0
+    expires = std::clamp<int64_t>(expires, 1, DECISION_NEVER_EXPIRES);
+    return static_cast<uint64_t>(expires) << 8 | static_cast<uint64_t>(reason) << 2 | pick;
+}
+
+DecisionPick decisionPick(uint64_t decision) { return static_cast<DecisionPick>(decision & 3); }
+ResolutionReason decisionReason(uint64_t decision) { return static_cast<ResolutionReason>((decision >> 2) & 0x3F); }
+int64_t decisionExpires(uint64_t decision) { return static_cast<int64_t>(decision >> 8); }
+
+ConflictStrategy strategyFor(ResolutionReason reason) {
+    switch (reason) {
+        case ResolutionReason::RECENT_PROJECT: return ConflictStrategy::RECENT_PROJECT_PRIORITY;
+        case ResolutionReason::NEWER_SOLUTION: return ConflictStrategy::NEWER_SOLUTION;
+        case ResolutionReason::POPULAR_SOLUTION: return ConflictStrategy::POPULARITY_BASED;
+        default: return ConflictStrategy::DEFAULT_LOCAL_PREFERENCE;
+    }
+}
+
+// Runs task(0) .. task(count - 1) on up to `threads` threads, the caller's included
+void runParallel(size_t count, size_t threads, const std::function<void(size_t)>& task) {
+    std::atomic<size_t> next{0};
+    auto work = [&] {
+        for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;) {
+            task(i);
+        }
+    };
+    
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < std::min(count, threads); ++i) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+} // namespace
+
+std::string ConflictResult::reason() const {
+    switch (reason_code) {
+        case ResolutionReason::ONLY_PROJECT:
+            return "Only project solution available";
+        case ResolutionReason::ONLY_RECENT_GLOBAL:
+            return "Only recent global solution available";
+        case ResolutionReason::RECENT_PROJECT:
+            return "Recent project solution takes priority";
+        case ResolutionReason::NEWER_SOLUTION:
+            return "Newer solution chosen (age difference: " + std::to_string(age_difference_days) + " days)";
+        case ResolutionReason::POPULAR_SOLUTION:
+            return "Popular solution chosen (use counts: project=" + std::to_string(project_use_count) +
+                   ", global=" + std::to_string(global_use_count) + ")";
+        case ResolutionReason::LOCAL_PREFERENCE:
+            return "Default local preference";
+        case ResolutionReason::RANKED:
+            return "AI-ranked result";
+        case ResolutionReason::DEFAULT:
+            break;
+    }
+    return "Default";
+}
+
+// SolutionHistory Implementation
+SolutionHistory::SolutionHistory(size_t capacity)
+    : slots(new std::atomic<const Solution*>[capacity]), capacity(capacity) {
+    for (size_t i = 0; i < capacity; ++i) {
+        slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+SolutionHistory::~SolutionHistory() {
+    for (size_t i = 0; i < capacity; ++i) {
+        delete slots[i].load(std::memory_order_relaxed);
+    }
+}
+
+bool SolutionHistory::push(std::unique_ptr<const Solution> solution, StringInterner& strings) {
+    uint64_t seq = sequence.load(std::memory_order_relaxed);
+    uint64_t pushed = seq / 2;
+    
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    
+    const Solution* evicted = slots[pushed % capacity].exchange(solution.release(), std::memory_order_release);
+    sequence.store(seq + 2, std::memory_order_release);
+    
+    if (evicted) {
+        strings.release(evicted->content);
+        EpochManager::instance().retire(evicted);
+    }
+    return pushed == 0;
+}
+
+const Solution* SolutionHistory::latest() const {
+    // The slot a concurrent push is filling is never the latest one
+    // unless capacity is 1, and then either solution is a valid answer
+    uint64_t pushed = sequence.load(std::memory_order_acquire) / 2;
+    return pushed ? slots[(pushed - 1) % capacity].load(std::memory_order_acquire) : nullptr;
+}
+
+std::vector<const Solution*> SolutionHistory::entries() const {
+    std::vector<const Solution*> result;
+    for (;;) {
+        uint64_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1) continue;
+        
+        uint64_t pushed = before / 2;
+        size_t count = static_cast<size_t>(std::min<uint64_t>(pushed, capacity));
+        result.clear();
+        for (uint64_t i = pushed - count; i < pushed; ++i) {
+            result.push_back(slots[i % capacity].load(std::memory_order_acquire));
+        }
+        
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == before) {
+            return result;
+        }
+    }
+}
+
 // SolutionCache Implementation
+SolutionCache::CompiledPolicy::CompiledPolicy(const ConflictPolicy& policy)
+    : recent_project_seconds(int64_t(policy.recent_project_days) * SECONDS_PER_DAY),
+      newer_solution_seconds((int64_t(policy.age_difference_days) + 1) * SECONDS_PER_DAY),
+      global_max_age_seconds(int64_t(policy.global_max_age_days) * SECONDS_PER_DAY),
+      popularity_ratio(policy.popularity_ratio >= 1.0 ? policy.popularity_ratio : 1.0) {}
+
+SolutionCache::SolutionCache(StringInterner& strings, size_t history_capacity, const ConflictPolicy& policy)
+    : strings(strings), history_capacity(std::min(std::max<size_t>(history_capacity, 1), MAX_HISTORY_CAPACITY)),
+      policy(policy) {
+    auto initial = std::make_unique<TableSet>();
+    for (auto& table : initial->shards) {
+        table = new EntryTable();
+    }
+    tables.store(initial.release(), std::memory_order_release);
+}
+
+SolutionCache::~SolutionCache() {
+    const TableSet* current = tables.load();
+    for (const EntryTable* table : current->shards) {
+        delete table;
+    }
+    delete current;
+    delete snapshot_layer.load();
+}
+
+// Caller must hold the write_mutex of every replaced shard and retire its old table
+void SolutionCache::publishTables(const std::vector<std::pair<size_t, EntryTable*>>& replacements) {
+    std::lock_guard<std::mutex> lock(publish_mutex);
+    
+    const TableSet* current = tables.load(std::memory_order_acquire);
+    auto next = std::make_unique<TableSet>(*current);
+    for (const auto& [shard, table] : replacements) {
+        next->shards[shard] = table;
+    }
+    tables.store(next.release(), std::memory_order_release);
+    EpochManager::instance().retire(current);
+}
+
 void SolutionCache::addSolution(const std::string& problem, const Solution& solution, bool is_global) {
-    std::unique_lock<std::shared_mutex> lock(cache_mutex);
+    addSolutions({{problem, solution}}, is_global);
+}
+
+void SolutionCache::addSolutions(const std::vector<std::pair<std::string, Solution>>& solutions, bool is_global,
+                                 DuplicatePolicy duplicates) {
+    std::vector<uint64_t> hashes(solutions.size());
+    std::vector<size_t> by_shard[SHARD_COUNT];
+    for (size_t i = 0; i < solutions.size(); ++i) {
+        hashes[i] = problemHash(solutions[i].first);
+        by_shard[shardIndex(hashes[i])].push_back(i);
+    }
+    
+    std::vector<std::string> new_problems;
+    EpochGuard guard; // Keeps the snapshot layer alive while entries are seeded
+    
+    for (size_t s = 0; s < SHARD_COUNT; ++s) {
+        if (by_shard[s].empty()) continue;
+        
+        Shard& shard = shards[s];
+        std::lock_guard<std::mutex> lock(shard.write_mutex);
+        
+        EntryTable* table = shardTable(s);
+        
+        for (size_t i : by_shard[s]) {
+            const auto& [problem, solution] = solutions[i];
+            
+            if (ProblemEntry* entry = table->find(hashes[i], problem)) {
+                appendSolution(shard, *entry, solution, is_global, duplicates);
+                continue;
+            }
+            
+            shard.entries.push_back(std::make_unique<ProblemEntry>(strings.intern(problem), history_capacity));
+            ProblemEntry* entry = shard.entries.back().get();
+            
+            seedFromSnapshot(shard, *entry, problem);
+            appendSolution(shard, *entry, solution, is_global, duplicates);
+            
+            // Readers see the entry only once it is complete
+            if (table->needsGrowth()) {
+                std::unique_ptr<EntryTable> grown = table->grown();
+                grown->insert(hashes[i], entry);
+                publishTables({{s, grown.get()}});
+                EpochManager::instance().retire(table);
+                table = grown.release();
+            } else {
+                table->insert(hashes[i], entry);
+            }
+            new_problems.push_back(problem);
+        }
+    }
+    
+    if (!new_problems.empty()) {
+        std::unique_lock<std::shared_mutex> lock(index_mutex);
+        for (const auto& problem : new_problems) {
+            match_index.add(problem);
+        }
+    }
+}
+
+void SolutionCache::bulkLoad(const std::vector<std::pair<std::string, Solution>>& solutions, bool is_global,
+                             DuplicatePolicy duplicates, size_t threads) {
+    using EntryList = std::vector<std::unique_ptr<ProblemEntry>>;
+    
+    std::vector<uint64_t> hashes(solutions.size());
+    std::vector<size_t> by_shard[SHARD_COUNT];
+    for (size_t i = 0; i < solutions.size(); ++i) {
+        hashes[i] = problemHash(solutions[i].first);
+        by_shard[shardIndex(hashes[i])].push_back(i);
+    }
     
-    auto& target_map = is_global ? global_solutions : project_solutions;
-    target_map[problem].push_back(solution);
+    // Locked in shard order; addSolutions never holds more than one
+    std::vector<size_t> touched;
+    std::vector<std::unique_lock<std::mutex>> locks;
+    for (size_t s = 0; s < SHARD_COUNT; ++s) {
+        if (by_shard[s].empty()) continue;
+        touched.push_back(s);
+        locks.emplace_back(shards[s].write_mutex);
+    }
+    if (touched.empty()) return;
+    
+    // A copied solution and the use count it was copied with
+    struct CarriedSolution {
+        const Solution* original;
+        const Solution* copy;
+        uint32_t copied_uses;
+    };
+    
+    std::vector<std::pair<size_t, EntryTable*>> built(touched.size());
+    std::vector<EntryList> superseded(touched.size());
+    std::vector<std::vector<std::string>> new_problems(touched.size());
+    std::vector<std::vector<CarriedSolution>> carried(touched.size());
+    EpochGuard carried_guard; // Copies evicted by the batch stay readable until hits are folded in
+    
+    // Small batches are built on the calling thread
+    size_t worker_count = std::min(threads, solutions.size() / BULK_SOLUTIONS_PER_THREAD + 1);
+    
+    runParallel(touched.size(), worker_count, [&](size_t t) {
+        EpochGuard guard; // Keeps the snapshot layer alive while entries are seeded
+        
+        size_t s = touched[t];
+        Shard& shard = shards[s];
+        const EntryTable* current = shardTable(s);
+        
+        // Entries the batch changes are copied; readers may still be using the originals
+        EntryTable staged(by_shard[s].size() * 2);
+        std::unordered_set<const ProblemEntry*> replaced;
+        EntryList fresh;
+        std::vector<uint64_t> fresh_hashes;
+        
+        for (size_t i : by_shard[s]) {
+            const auto& [problem, solution] = solutions[i];
+            
+            ProblemEntry* entry = staged.find(hashes[i], problem);
+            if (!entry) {
+                const ProblemEntry* original = current->find(hashes[i], problem);
+                if (original) strings.acquire(original->problem);
+                fresh.push_back(std::make_unique<ProblemEntry>(original ? original->problem : strings.intern(problem),
+                                                               history_capacity));
+                fresh_hashes.push_back(hashes[i]);
+                entry = fresh.back().get();
+                staged.insert(hashes[i], entry);
+                
+                if (original) {
+                    for (const SolutionHistory* history : {&original->project, &original->global}) {
+                        for (const Solution* stored : history->entries()) {
+                            strings.acquire(stored->content);
+                            auto copy = std::make_unique<Solution>(*stored);
+                            carried[t].push_back({stored, copy.get(), copy->use_count});
+                            (history == &original->global ? entry->global : entry->project).push(std::move(copy), strings);
+                        }
+                    }
+                    replaced.insert(original);
+                } else {
+                    seedFromSnapshot(shard, *entry, problem);
+                    new_problems[t].push_back(problem);
+                }
+            }
+            appendSolution(shard, *entry, solution, is_global, duplicates);
+        }
+        
+        // Sized once for the final problem count, so it never grows while being filled
+        auto table = std::make_unique<EntryTable>((current->size() - replaced.size() + fresh.size()) * 2);
+        current->forEach([&](uint64_t hash, ProblemEntry* entry) {
+            if (!replaced.count(entry)) table->insert(hash, entry);
+        });
+        for (size_t j = 0; j < fresh.size(); ++j) {
+            table->insert(fresh_hashes[j], fresh[j].get());
+        }
+        
+        if (!replaced.empty()) {
+            for (auto& entry : shard.entries) {
+                if (!replaced.count(entry.get())) continue;
+                releaseEntry(*entry);
+                superseded[t].push_back(std::move(entry));
+            }
+            shard.entries.erase(std::remove(shard.entries.begin(), shard.entries.end(), nullptr), shard.entries.end());
+        }
+        for (auto& entry : fresh) {
+            shard.entries.push_back(std::move(entry));
+        }
+        built[t] = {s, table.release()};
+    });
     
-    // Keep only the most recent 5 solutions per problem to limit memory usage
-    if (target_map[problem].size() > 5) {
-        target_map[problem].erase(target_map[problem].begin());
+    // Every affected shard switches in one store; the originals go once no reader can hold them
+    std::vector<const EntryTable*> old_tables;
+    for (size_t s : touched) {
+        old_tables.push_back(shardTable(s));
+    }
+    publishTables(built);
+    
+    // Hits that reached the originals while their copies were built are not lost
+    bool folded = false;
+    for (const auto& solutions : carried) {
+        for (const auto& solution : solutions) {
+            uint32_t uses = solution.original->use_count;
+            if (uses <= solution.copied_uses) continue;
+            solution.copy->use_count.add(uses - solution.copied_uses);
+            folded = true;
+        }
+    }
+    if (folded) markUsed();
+    
+    for (const EntryTable* table : old_tables) {
+        EpochManager::instance().retire(table);
+    }
+    for (auto& entries : superseded) {
+        if (!entries.empty()) EpochManager::instance().retire(new EntryList(std::move(entries)));
+    }
+    locks.clear();
+    
+    std::unique_lock<std::shared_mutex> lock(index_mutex);
+    for (const auto& problems : new_problems) {
+        for (const auto& problem : problems) {
+            match_index.add(problem);
+        }
     }
 }
 
-std::unique_ptr<ConflictResult> SolutionCache::findSolution(const std::string& problem) const {
-    std::shared_lock<std::shared_mutex> lock(cache_mutex);
+// Caller must hold shard.write_mutex
+void SolutionCache::appendSolution(Shard& shard, ProblemEntry& entry, const Solution& solution, bool is_global,
+                                   DuplicatePolicy duplicates) {
+    SolutionHistory& history = is_global ? entry.global : entry.project;
+    
+    if (duplicates != DuplicatePolicy::KEEP) {
+        auto stored = history.entries();
+        bool present = std::any_of(stored.begin(), stored.end(), [&](const Solution* existing) {
+            return existing->content == solution.content &&
+                   (duplicates == DuplicatePolicy::SKIP_CONTENT || existing->created == solution.created);
+        });
+        if (present) return;
+    }
     
-    auto project_it = project_solutions.find(problem);
-    auto global_it = global_solutions.find(problem);
+    auto stored = std::make_unique<Solution>(solution);
+    stored->content = strings.intern(solution.content);
     
-    bool has_project = (project_it != project_solutions.end() && !project_it->second.empty());
-    bool has_global = (global_it != global_solutions.end() && !global_it->second.empty());
+    // The ring keeps only the most recent history_capacity solutions
+    if (history.push(std::move(stored), strings)) {
+        (is_global ? shard.global_count : shard.project_count)++;
+    }
     
-    if (!has_project && !has_global) {
+    // Published after the push, so readers that see it also see the solution it was decided on
+    entry.decision.store(decide(entry.project.latest(), entry.global.latest(), epochSeconds()),
+                         std::memory_order_release);
+}
+
+// Drops the entry's text references once it is unpublished; caller must hold its shard's write_mutex
+void SolutionCache::releaseEntry(const ProblemEntry& entry) {
+    strings.release(entry.problem);
+    for (const Solution* stored : entry.project.entries()) strings.release(stored->content);
+    for (const Solution* stored : entry.global.entries()) strings.release(stored->content);
+}
+
+// A live entry shadows the snapshot, so it starts from the snapshot's history. The
+// text is interned, so only the snapshot layer keeps the mapping alive; caller
+// must hold an EpochGuard
+void SolutionCache::seedFromSnapshot(Shard& shard, ProblemEntry& entry, std::string_view problem) {
+    auto seeded = findSnapshotSolutions(problem);
+    if (!seeded) return;
+    
+    if (!seeded->project.empty()) { shard.project_count++; snapshot_project_count--; }
+    if (!seeded->global.empty()) { shard.global_count++; snapshot_global_count--; }
+    for (auto* side : {&seeded->project, &seeded->global}) {
+        for (auto& stored : *side) {
+            stored.content = strings.intern(stored.content);
+            (side == &seeded->global ? entry.global : entry.project).push(std::make_unique<Solution>(std::move(stored)), strings);
+        }
+    }
+}
+
+void SolutionCache::copyHistory(const SolutionHistory& history, std::vector<Solution>& out) {
+    for (const Solution* solution : history.entries()) {
+        out.push_back(*solution);
+    }
+}
+
+const SolutionCache::ProblemEntry* SolutionCache::findEntry(std::string_view problem) const {
+    uint64_t hash = problemHash(problem);
+    return shardTable(shardIndex(hash))->find(hash, problem);
+}
+
+// Caller must hold an EpochGuard
+std::unique_ptr<SolutionSet> SolutionCache::findSnapshotSolutions(std::string_view problem) const {
+    const SnapshotLayer* layer = snapshot_layer.load(std::memory_order_acquire);
+    MemorySnapshot::ProblemView view;
+    if (!layer || !layer->snapshot->findProblem(layer->category, problem, view)) {
         return nullptr;
     }
+    return snapshotSolutions(*layer, view);
+}
+
+std::unique_ptr<SolutionSet> SolutionCache::snapshotSolutions(const SnapshotLayer& layer,
+                                                              const MemorySnapshot::ProblemView& view) {
+    auto solutions = std::make_unique<SolutionSet>();
+    auto stored = layer.snapshot->solutions(view);
+    for (size_t i = 0; i < stored.size(); ++i) {
+        Solution solution = fromSnapshot(stored[i]);
+        // The mapping is read-only, so hits on it are counted beside it
+        uint64_t hits = layer.hits[view.first_solution - layer.first_solution + i].load(std::memory_order_relaxed);
+        solution.use_count = static_cast<uint32_t>(std::min<uint64_t>(stored[i].use_count + hits, UINT32_MAX));
+        (stored[i].is_global ? solutions->global : solutions->project).push_back(solution);
+    }
+    return solutions;
+}
+
+// Caller must hold an EpochGuard
+std::optional<ConflictResult> SolutionCache::resolveHit(const ProblemEntry* entry, std::string_view problem) const {
+    const Solution* chosen = nullptr;
+    
+    if (entry) {
+        auto result = resolveEntry(*entry, &chosen);
+        if (result) {
+            result->solution.use_count = chosen->use_count.increment();
+            markUsed();
+        }
+        return result;
+    }
     
-    // If only one source has solutions, use it
-    if (has_project && !has_global) {
-        const auto& latest = project_it->second.back();
-        return std::make_unique<ConflictResult>(latest, ConflictStrategy::DEFAULT_LOCAL_PREFERENCE, 
-                                              "Only project solution available");
-    }
-    
-    if (has_global && !has_project) {
-        const auto& latest = global_it->second.back();
-        // Check if global solution is recent enough (within 6 months)
-        auto now = std::chrono::system_clock::now();
-        auto six_months_ago = now - std::chrono::hours(24 * 180); // 180 days
-        auto created_time = std::chrono::system_clock::from_time_t(std::stoll(latest.created_date));
+    const SnapshotLayer* layer = snapshot_layer.load(std::memory_order_acquire);
+    MemorySnapshot::ProblemView view;
+    if (!layer || !layer->snapshot->findProblem(layer->category, problem, view)) {
+        return std::nullopt;
+    }
+    
+    auto stored = snapshotSolutions(*layer, view);
+    auto result = resolveConflict(*stored, &chosen);
+    if (result) {
+        // Resolution picks the latest solution of a side, the last of its records
+        bool is_global = !stored->global.empty() && chosen == &stored->global.back();
+        size_t record = view.first_solution - layer->first_solution + view.project_count - 1 +
+                        (is_global ? view.global_count : 0);
+        layer->hits[record].fetch_add(1, std::memory_order_relaxed);
+        result->solution.use_count = UseCount(result->solution.use_count).increment();
+        markUsed();
+    }
+    return result;
+}
+
+// Caller must hold an EpochGuard
+void SolutionCache::indexSnapshotProblems() const {
+    const SnapshotLayer* layer = snapshot_layer.load(std::memory_order_acquire);
+    if (!layer) return;
+    
+    {
+        std::shared_lock<std::shared_mutex> lock(index_mutex);
+        if (indexed_generation == layer->generation) return;
+    }
+    
+    // Deferred to the first near-match lookup so attaching a snapshot stays cheap
+    std::unique_lock<std::shared_mutex> lock(index_mutex);
+    if (indexed_generation == layer->generation) return;
+    
+    size_t count = layer->snapshot->problemCount(layer->category);
+    for (size_t i = 0; i < count; ++i) {
+        match_index.add(std::string(layer->snapshot->problemAt(layer->category, i).problem));
+    }
+    indexed_generation = layer->generation;
+}
+
+std::optional<ConflictResult> SolutionCache::findSolution(const std::string& problem) const {
+    EpochGuard guard;
+    
+    return resolveHit(findEntry(problem), problem);
+}
+
+std::vector<std::optional<ConflictResult>> SolutionCache::findSolutions(
+    const std::vector<const std::string*>& problems) const {
+    EpochGuard guard;
+    
+    std::vector<std::optional<ConflictResult>> results(problems.size());
+    const TableSet* current = tables.load(std::memory_order_acquire); // One consistent view per batch
+    
+    for (size_t i = 0; i < problems.size(); ++i) {
+        uint64_t hash = problemHash(*problems[i]);
         
-        if (created_time > six_months_ago) {
-            return std::make_unique<ConflictResult>(latest, ConflictStrategy::DEFAULT_LOCAL_PREFERENCE,
-                                                  "Only recent global solution available");
+        results[i] = resolveHit(current->shards[shardIndex(hash)]->find(hash, *problems[i]), *problems[i]);
+    }
+    
+    return results;
+}
+
+std::unique_ptr<SimilarProblemMatch> SolutionCache::findSimilarSolution(const std::string& problem,
+                                                                        double min_score) const {
+    // Exact hits skip similarity scoring entirely
+    if (auto exact = findSolution(problem)) {
+        return std::make_unique<SimilarProblemMatch>(problem, 1.0, *exact);
+    }
+    
+    {
+        EpochGuard guard;
+        indexSnapshotProblems();
+    }
+    
+    std::vector<ProblemMatchIndex::Match> matches;
+    {
+        std::shared_lock<std::shared_mutex> lock(index_mutex);
+        // A few runners-up cover near matches whose only solution has expired
+        matches = match_index.findMatches(problem, min_score, 4);
+    }
+    
+    for (const auto& match : matches) {
+        if (auto result = findSolution(match.problem)) {
+            return std::make_unique<SimilarProblemMatch>(match.problem, match.score, *result);
         }
-        return nullptr; // Global solution too old
     }
     
-    // Both sources have solutions - apply conflict resolution
-    const auto& project_solution = project_it->second.back();
-    const auto& global_solution = global_it->second.back();
+    return nullptr;
+}
+
+std::optional<ConflictResult> SolutionCache::resolveConflict(const SolutionSet& solutions,
+                                                           const Solution** chosen) const {
+    return resolveConflict(solutions.project.empty() ? nullptr : &solutions.project.back(),
+                           solutions.global.empty() ? nullptr : &solutions.global.back(), chosen);
+}
+
+// Caller must hold an EpochGuard while the solutions are reachable
+std::optional<ConflictResult> SolutionCache::resolveConflict(const Solution* project, const Solution* global,
+                                                           const Solution** chosen) const {
+    return applyDecision(decide(project, global, epochSeconds()), project, global, chosen);
+}
+
+// Caller must hold an EpochGuard
+std::optional<ConflictResult> SolutionCache::resolveEntry(const ProblemEntry& entry, const Solution** chosen) const {
+    // Loaded before the solutions: a decision stored after a push then sees that push, and an
+    // older one only picks a side that was already stored
+    uint64_t decision = entry.decision.load(std::memory_order_acquire);
+    const Solution* project = entry.project.latest();
+    const Solution* global = entry.global.latest();
+    
+    if (decision == 0 ||
+        (decisionExpires(decision) != DECISION_NEVER_EXPIRES && decisionExpires(decision) <= epochSeconds())) {
+        uint64_t current = decide(project, global, epochSeconds());
+        // A decision stored meanwhile by a writer is newer, so it is kept
+        entry.decision.compare_exchange_strong(decision, current, std::memory_order_acq_rel);
+        decision = current;
+    }
+    return applyDecision(decision, project, global, chosen);
+}
+
+// The rules that depend on the clock; use counts are compared when the decision is applied
+uint64_t SolutionCache::decide(const Solution* project, const Solution* global, int64_t now) const {
+    if (!project && !global) {
+        return packDecision(PICK_NONE, ResolutionReason::DEFAULT, DECISION_NEVER_EXPIRES);
+    }
     
-    auto now = std::chrono::system_clock::now();
-    auto project_time = std::chrono::system_clock::from_time_t(std::stoll(project_solution.created_date));
-    auto global_time = std::chrono::system_clock::from_time_t(std::stoll(global_solution.created_date));
+    // If only one source has solutions, use it
+    if (!global) {
+        return packDecision(PICK_PROJECT, ResolutionReason::ONLY_PROJECT, DECISION_NEVER_EXPIRES);
+    }
+    
+    if (!project) {
+        // A lone global solution is used while it is recent enough (6 months by default)
+        int64_t recent_until = global->created + policy.global_max_age_seconds;
+        if (now < recent_until) {
+            return packDecision(PICK_GLOBAL, ResolutionReason::ONLY_RECENT_GLOBAL, recent_until);
+        }
+        return packDecision(PICK_NONE, ResolutionReason::DEFAULT, DECISION_NEVER_EXPIRES); // Global solution too old
+    }
+    
+    // Both sources have solutions - apply conflict resolution
     
     // Rule 1: Project solutions < 30 days always win
-    auto thirty_days_ago = now - std::chrono::hours(24 * 30);
-    if (project_time > thirty_days_ago) {
-        return std::make_unique<ConflictResult>(project_solution, ConflictStrategy::RECENT_PROJECT_PRIORITY,
-                                              "Recent project solution takes priority");
+    int64_t recent_until = project->created + policy.recent_project_seconds;
+    if (now < recent_until) {
+        return packDecision(PICK_PROJECT, ResolutionReason::RECENT_PROJECT, recent_until);
     }
     
     // Rule 2: Use newer solution if age difference > 90 days
-    auto age_diff = std::abs(std::chrono::duration_cast<std::chrono::hours>(project_time - global_time).count()) / 24;
-    if (age_diff > 90) {
-        const auto& newer_solution = (project_time > global_time) ? project_solution : global_solution;
-        std::stringstream reason;
-        reason << "Newer solution chosen (age difference: " << age_diff << " days)";
-        return std::make_unique<ConflictResult>(newer_solution, ConflictStrategy::NEWER_SOLUTION, reason.str());
+    if (std::abs(project->created - global->created) >= policy.newer_solution_seconds) {
+        return packDecision(project->created > global->created ? PICK_PROJECT : PICK_GLOBAL,
+                            ResolutionReason::NEWER_SOLUTION, DECISION_NEVER_EXPIRES);
     }
     
-    // Rule 3: Use solution with higher use count if ratio > 3x
-    double use_ratio = static_cast<double>(std::max(project_solution.use_count, global_solution.use_count)) /
-                      static_cast<double>(std::min(project_solution.use_count, global_solution.use_count));
-    
-    if (use_ratio > 3.0) {
-        const auto& popular_solution = (project_solution.use_count > global_solution.use_count) ? 
-                                      project_solution : global_solution;
-        std::stringstream reason;
-        reason << "Popular solution chosen (use counts: project=" << project_solution.use_count 
-               << ", global=" << global_solution.use_count << ")";
-        return std::make_unique<ConflictResult>(popular_solution, ConflictStrategy::POPULARITY_BASED, reason.str());
+    // Rules 3 and 4 depend only on use counts, which lookups keep raising
+    return packDecision(PICK_BY_USE_COUNT, ResolutionReason::LOCAL_PREFERENCE, DECISION_NEVER_EXPIRES);
+}
+
+std::optional<ConflictResult> SolutionCache::applyDecision(uint64_t decision, const Solution* project,
+                                                           const Solution* global, const Solution** chosen) const {
+    const Solution* unused;
+    const Solution*& pick = chosen ? *chosen : unused; // Which stored solution the result copies
+    ResolutionReason reason = decisionReason(decision);
+    
+    switch (decisionPick(decision)) {
+        case PICK_NONE:
+            return std::nullopt;
+        case PICK_PROJECT:
+            pick = project;
+            break;
+        case PICK_GLOBAL:
+            pick = global;
+            break;
+        case PICK_BY_USE_COUNT: {
+            // Rule 3: Use solution with higher use count if ratio > 3x
+            // Counts move under concurrent hits, so each is read once
+            uint64_t project_uses = std::max<uint32_t>(project->use_count, 1);
+            uint64_t global_uses = std::max<uint32_t>(global->use_count, 1);
+            if (double(std::max(project_uses, global_uses)) >
+                policy.popularity_ratio * double(std::min(project_uses, global_uses))) {
+                pick = (project_uses > global_uses) ? project : global;
+                ConflictResult result(*pick, ConflictStrategy::POPULARITY_BASED, ResolutionReason::POPULAR_SOLUTION);
+                result.project_use_count = static_cast<uint32_t>(project_uses);
+                result.global_use_count = static_cast<uint32_t>(global_uses);
+                return result;
+            }
+            
+            // Rule 4: Default to project solution
+            pick = project;
+            reason = ResolutionReason::LOCAL_PREFERENCE;
+            break;
+        }
     }
     
-    // Rule 4: Default to project solution
-    return std::make_unique<ConflictResult>(project_solution, ConflictStrategy::DEFAULT_LOCAL_PREFERENCE,
-                                          "Default local preference");
+    ConflictResult result(*pick, strategyFor(reason), reason);
+    if (reason == ResolutionReason::NEWER_SOLUTION) {
+        int64_t age_diff = std::abs(project->created - global->created) / SECONDS_PER_DAY;
+        result.age_difference_days = static_cast<uint32_t>(std::min<int64_t>(age_diff, UINT32_MAX));
+    }
+    return result;
 }
 
 std::vector<Solution> SolutionCache::getAllSolutions(const std::string& problem) const {
-    std::shared_lock<std::shared_mutex> lock(cache_mutex);
+    EpochGuard guard;
     
     std::vector<Solution> all_solutions;
     
-    auto project_it = project_solutions.find(problem);
-    if (project_it != project_solutions.end()) {
-        all_solutions.insert(all_solutions.end(), project_it->second.begin(), project_it->second.end());
+    if (const ProblemEntry* entry = findEntry(problem)) {
+        copyHistory(entry->project, all_solutions);
+        copyHistory(entry->global, all_solutions);
+    } else if (auto stored = findSnapshotSolutions(problem)) {
+        all_solutions.insert(all_solutions.end(), stored->project.begin(), stored->project.end());
+        all_solutions.insert(all_solutions.end(), stored->global.begin(), stored->global.end());
     }
     
-    auto global_it = global_solutions.find(problem);
-    if (global_it != global_solutions.end()) {
-        all_solutions.insert(all_solutions.end(), global_it->second.begin(), global_it->second.end());
+    return all_solutions;
+}
+
+void SolutionCache::attachSnapshot(std::shared_ptr<const MemorySnapshot> snapshot, size_t category) {
+    size_t project_count = 0;
+    size_t global_count = 0;
+    uint32_t first_solution = UINT32_MAX;
+    uint32_t end_solution = 0;
+    size_t count = snapshot->problemCount(category);
+    for (size_t i = 0; i < count; ++i) {
+        auto view = snapshot->problemAt(category, i);
+        project_count += view.project_count > 0;
+        global_count += view.global_count > 0;
+        first_solution = std::min(first_solution, view.first_solution);
+        end_solution = std::max(end_solution, view.first_solution + view.project_count + view.global_count);
+    }
+    first_solution = std::min(first_solution, end_solution);
+    
+    auto* layer = new SnapshotLayer{std::move(snapshot), category, ++snapshot_generation, first_solution,
+                                    std::make_unique<std::atomic<uint32_t>[]>(end_solution - first_solution),
+                                    std::make_unique<uint32_t[]>(end_solution - first_solution)};
+    EpochManager::instance().retire(snapshot_layer.exchange(layer, std::memory_order_acq_rel));
+    snapshot_project_count = project_count;
+    snapshot_global_count = global_count;
+}
+
+void SolutionCache::detachSnapshot() {
+    if (const SnapshotLayer* layer = snapshot_layer.exchange(nullptr, std::memory_order_acq_rel)) {
+        EpochManager::instance().retire(layer);
+    }
+    snapshot_project_count = 0;
+    snapshot_global_count = 0;
+}
+
+void SolutionCache::forEachProblem(const std::function<void(std::string_view, const SolutionSet&)>& visit) const {
+    EpochGuard guard;
+    
+    for (const EntryTable* table : tables.load(std::memory_order_acquire)->shards) {
+        table->forEach([&](uint64_t, const ProblemEntry* entry) {
+            SolutionSet solutions;
+            copyHistory(entry->project, solutions.project);
+            copyHistory(entry->global, solutions.global);
+            visit(entry->problem, solutions);
+        });
     }
     
-    return all_solutions;
+    const SnapshotLayer* layer = snapshot_layer.load(std::memory_order_acquire);
+    if (!layer) return;
+    
+    size_t count = layer->snapshot->problemCount(layer->category);
+    for (size_t i = 0; i < count; ++i) {
+        std::string_view problem = layer->snapshot->problemAt(layer->category, i).problem;
+        if (findEntry(problem)) continue; // Shadowed by a live entry
+        if (auto stored = findSnapshotSolutions(problem)) {
+            visit(problem, *stored);
+        }
+    }
+}
+
+void SolutionCache::collectUseCounts(const std::function<void(std::string_view, const Solution&)>& visit,
+                                     UseCountBatch& batch) {
+    std::lock_guard<std::mutex> lock(use_count_mutex);
+    // Cleared before scanning, so a hit landing during the scan marks the cache again
+    if (!uses_dirty.exchange(false, std::memory_order_relaxed)) return;
+    
+    for (const EntryTable* table : tables.load(std::memory_order_acquire)->shards) {
+        table->forEach([&](uint64_t, const ProblemEntry* entry) {
+            for (const SolutionHistory* history : {&entry->project, &entry->global}) {
+                for (const Solution* stored : history->entries()) {
+                    uint32_t uses;
+                    if (!stored->use_count.unlogged(uses)) continue;
+                    batch.solutions.emplace_back(&stored->use_count, uses);
+                    Solution solution(*stored);
+                    solution.use_count = uses;
+                    visit(entry->problem, solution);
+                }
+            }
+        });
+    }
+    
+    const SnapshotLayer* layer = snapshot_layer.load(std::memory_order_acquire);
+    if (!layer) return;
+    batch.layer = layer;
+    
+    size_t count = layer->snapshot->problemCount(layer->category);
+    for (size_t i = 0; i < count; ++i) {
+        auto view = layer->snapshot->problemAt(layer->category, i);
+        auto stored = layer->snapshot->solutions(view);
+        for (size_t j = 0; j < stored.size(); ++j) {
+            size_t record = view.first_solution - layer->first_solution + j;
+            uint32_t hits = layer->hits[record].load(std::memory_order_relaxed);
+            if (hits == layer->logged_hits[record]) continue;
+            batch.snapshot_hits.emplace_back(record, hits);
+            Solution solution = fromSnapshot(stored[j]);
+            solution.use_count = static_cast<uint32_t>(std::min<uint64_t>(uint64_t(stored[j].use_count) + hits, UINT32_MAX));
+            visit(view.problem, solution);
+        }
+    }
+}
+
+void SolutionCache::finishUseCounts(const UseCountBatch& batch, bool logged) {
+    if (batch.solutions.empty() && batch.snapshot_hits.empty()) return;
+    if (!logged) {
+        markUsed();
+        return;
+    }
+    std::lock_guard<std::mutex> lock(use_count_mutex);
+    for (const auto& [use_count, uses] : batch.solutions) {
+        use_count->markLogged(uses);
+    }
+    for (const auto& [record, hits] : batch.snapshot_hits) {
+        batch.layer->logged_hits[record] = std::max(batch.layer->logged_hits[record], hits);
+    }
+}
+
+bool SolutionCache::restoreUseCount(std::string_view problem, const Solution& solution) {
+    std::lock_guard<std::mutex> lock(use_count_mutex);
+    EpochGuard guard;
+    bool is_global = solution.source == SolutionSource::GLOBAL;
+    
+    // The most recent solution with that content is the one a lookup would have chosen
+    if (const ProblemEntry* entry = findEntry(problem)) {
+        auto stored = (is_global ? entry->global : entry->project).entries();
+        for (auto it = stored.rbegin(); it != stored.rend(); ++it) {
+            if ((*it)->content == solution.content) {
+                (*it)->use_count.restore(solution.use_count);
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    const SnapshotLayer* layer = snapshot_layer.load(std::memory_order_acquire);
+    MemorySnapshot::ProblemView view;
+    if (!layer || !layer->snapshot->findProblem(layer->category, problem, view)) {
+        return false;
+    }
+    auto stored = layer->snapshot->solutions(view);
+    for (size_t j = stored.size(); j-- > 0;) {
+        if (stored[j].is_global != is_global || stored[j].content != solution.content) continue;
+        size_t record = view.first_solution - layer->first_solution + j;
+        uint32_t hits = solution.use_count > stored[j].use_count ? solution.use_count - stored[j].use_count : 0;
+        uint32_t current = layer->hits[record].load(std::memory_order_relaxed);
+        while (current < hits && !layer->hits[record].compare_exchange_weak(current, hits, std::memory_order_relaxed)) {}
+        layer->logged_hits[record] = std::max(current, hits);
+        return true;
+    }
+    return false;
 }
 
 void SolutionCache::clear() {
-    std::unique_lock<std::shared_mutex> lock(cache_mutex);
-    project_solutions.clear();
-    global_solutions.clear();
+    using EntryList = std::vector<std::unique_ptr<ProblemEntry>>;
+    
+    for (size_t s = 0; s < SHARD_COUNT; ++s) {
+        Shard& shard = shards[s];
+        std::lock_guard<std::mutex> lock(shard.write_mutex);
+        
+        const EntryTable* old_table = shardTable(s);
+        publishTables({{s, new EntryTable()}});
+        EpochManager::instance().retire(old_table);
+        for (const auto& entry : shard.entries) {
+            releaseEntry(*entry);
+        }
+        EpochManager::instance().retire(new EntryList(std::move(shard.entries)));
+        shard.entries.clear();
+        shard.project_count = 0;
+        shard.global_count = 0;
+    }
+    
+    detachSnapshot();
+    
+    std::unique_lock<std::shared_mutex> lock(index_mutex);
+    match_index.clear();
+    indexed_generation = 0;
 }
 
 std::pair<size_t, size_t> SolutionCache::getStats() const {
-    std::shared_lock<std::shared_mutex> lock(cache_mutex);
-    return {project_solutions.size(), global_solutions.size()};
+    size_t project_count = 0;
+    size_t global_count = 0;
+    for (const auto& shard : shards) {
+        project_count += shard.project_count.load(std::memory_order_relaxed);
+        global_count += shard.global_count.load(std::memory_order_relaxed);
+    }
+    project_count += snapshot_project_count.load(std::memory_order_relaxed);
+    global_count += snapshot_global_count.load(std::memory_order_relaxed);
+    return {project_count, global_count};
 }
 
 // ErrorCategorizer Implementation
-void ErrorCategorizer::loadCategories(const std::unordered_map<std::string, std::vector<std::string>>& categories) {
-    std::unique_lock<std::shared_mutex> lock(patterns_mutex);
-    category_patterns.clear();
+void ErrorCategorizer::loadCategories(const std::vector<CategoryDefinition>& categories) {
+    std::vector<const CategoryDefinition*> ordered;
+    for (const auto& definition : categories) {
+        ordered.push_back(&definition);
+    }
+    std::stable_sort(ordered.begin(), ordered.end(),
+                     [](const auto* a, const auto* b) { return a->priority < b->priority; });
     
-    for (const auto& [category, patterns] : categories) {
-        for (const auto& pattern : patterns) {
-            try {
-                category_patterns[category].emplace_back(pattern, std::regex::icase);
-            } catch (const std::regex_error& e) {
-                // Skip invalid regex patterns
-                continue;
-            }
+    // Category ids follow match order, so the matcher's lowest id wins
+    auto new_matcher = std::make_unique<MultiPatternMatcher>();
+    std::vector<std::string> new_names;
+    
+    for (const auto* definition : ordered) {
+        int category_id = static_cast<int>(new_names.size());
+        bool has_valid_pattern = false;
+        
+        for (const auto& pattern : definition->patterns) {
+            // Invalid regex patterns are skipped by the matcher
+            has_valid_pattern |= new_matcher->addPattern(pattern, category_id);
+        }
+        
+        if (has_valid_pattern) {
+            new_names.push_back(definition->name);
         }
     }
+    new_matcher->compile();
+    
+    std::unique_lock<std::shared_mutex> lock(patterns_mutex);
+    matcher = std::move(new_matcher);
+    category_names = std::move(new_names);
+}
+
+void ErrorCategorizer::loadCategories(const std::unordered_map<std::string, std::vector<std::string>>& categories) {
+    std::vector<CategoryDefinition> definitions;
+    for (const auto& [category, patterns] : categories) {
+        definitions.emplace_back(category, patterns);
+    }
+    std::sort(definitions.begin(), definitions.end(),
+              [](const auto& a, const auto& b) { return a.name < b.name; });
+    
+    loadCategories(definitions);
 }
 
 std::string ErrorCategorizer::categorize(const std::string& error_message) const {
     std::shared_lock<std::shared_mutex> lock(patterns_mutex);
     
-    for (const auto& [category, patterns] : category_patterns) {
-        for (const auto& regex_pattern : patterns) {
-            if (std::regex_search(error_message, regex_pattern)) {
-                return category;
-            }
+    if (matcher) {
+        int category_id = matcher->match(error_message);
+        if (category_id != MultiPatternMatcher::NO_MATCH) {
+            return category_names[category_id];
         }
     }
     
     return "errors_uncategorised";
 }
 
-std::vector<std::string> ErrorCategorizer::getCategories() const {
+std::vector<std::string> ErrorCategorizer::categorizeAll(const std::vector<const std::string*>& error_messages) const {
     std::shared_lock<std::shared_mutex> lock(patterns_mutex);
     
     std::vector<std::string> categories;
-    for (const auto& [category, _] : category_patterns) {
-        categories.push_back(category);
+    categories.reserve(error_messages.size());
+    
+    for (const auto* message : error_messages) {
+        int category_id = matcher ? matcher->match(*message) : MultiPatternMatcher::NO_MATCH;
+        categories.push_back(category_id != MultiPatternMatcher::NO_MATCH ? category_names[category_id]
+                                                                           : "errors_uncategorised");
     }
     
     return categories;
 }
 
+std::vector<std::string> ErrorCategorizer::getCategories() const {
+    std::shared_lock<std::shared_mutex> lock(patterns_mutex);
+    return category_names;
+}
+
+std::string ErrorCategorizer::getStatistics() const {
+    std::shared_lock<std::shared_mutex> lock(patterns_mutex);
+    
+    std::stringstream stats;
+    stats << "{\"automaton_patterns\": " << (matcher ? matcher->getAutomatonPatternCount() : 0)
+          << ", \"fallback_patterns\": " << (matcher ? matcher->getFallbackPatternCount() : 0)
+          << ", \"dfa_states\": " << (matcher ? matcher->getDfaStateCount() : 0)
+          << ", \"prefilter_literals\": " << (matcher ? matcher->getPrefilterLiteralCount() : 0) << "}";
+    return stats.str();
+}
+
 // MemoryEngine Implementation
-MemoryEngine::MemoryEngine() : error_categorizer(std::make_unique<ErrorCategorizer>()) {}
+MemoryEngine::MemoryEngine()
+    : category_table(new CategoryTable()), error_categorizer(std::make_unique<ErrorCategorizer>()) {}
 
-MemoryEngine::~MemoryEngine() = default;
+MemoryEngine::~MemoryEngine() {
+    // Drains the log and joins any running compaction while the caches still exist
+    flushUseCounts();
+    wal.store(nullptr, std::memory_order_release);
+    write_ahead_log.reset();
+    delete category_table.load();
+}
 
 bool MemoryEngine::initialize(const std::unordered_map<std::string, std::vector<std::string>>& categories) {
     try {
         error_categorizer->loadCategories(categories);
+        buildCategoryTable();
+        return true;
+    } catch (const std::exception& e) {
+        return false;
+    }
+}
+
+bool MemoryEngine::initialize(const std::vector<CategoryDefinition>& categories,
+                              const ConflictPolicy& default_policy) {
+    try {
+        error_categorizer->loadCategories(categories);
+        {
+            std::lock_guard<std::mutex> lock(engine_mutex);
+            default_conflict_policy = default_policy;
+            for (const auto& definition : categories) {
+                if (definition.history_capacity > 0) {
+                    history_capacities[definition.name] = definition.history_capacity;
+                }
+                if (definition.conflict_policy) {
+                    conflict_policies[definition.name] = *definition.conflict_policy;
+                }
+            }
+        }
+        buildCategoryTable();
         return true;
     } catch (const std::exception& e) {
         return false;
@@ -185,61 +1036,151 @@ bool MemoryEngine::storeSolution(const std::string& problem,
                                 const std::string& category,
                                 const std::string& solution_content,
                                 bool is_global) {
-    auto start_time = std::chrono::high_resolution_clock::now();
-    
     std::string final_category = category;
     if (final_category.empty()) {
         final_category = categorizeError(problem);
     }
     
-    Solution solution(solution_content, is_global ? "global" : "project");
-    
-    {
-        std::unique_lock<std::shared_mutex> lock(engine_mutex);
-        
-        if (category_index.find(final_category) == category_index.end()) {
-            category_index[final_category] = std::make_unique<SolutionCache>();
+    Solution solution(solution_content, is_global ? SolutionSource::GLOBAL : SolutionSource::PROJECT);
+    
+    // Held from logging until applied, so compaction cannot rotate the record away before the snapshot sees it
+    std::shared_lock<std::shared_mutex> barrier(store_barrier, std::defer_lock);
+    if (WriteAheadLog* log = wal.load(std::memory_order_acquire)) {
+        { std::lock_guard<std::mutex> turnstile(store_turnstile); } // Queues behind a waiting compaction
+        barrier.lock();
+        WalRecord record;
+        record.is_global = is_global;
+        record.created = solution.created;
+        record.use_count = solution.use_count;
+        record.category = final_category;
+        record.problem = problem;
+        record.content = solution_content;
+        if (!log->append(record)) {
+            return false;
         }
-        
-        category_index[final_category]->addSolution(problem, solution, is_global);
     }
     
-    auto end_time = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
-    total_lookup_time_us += duration.count();
+    getOrCreateCache(final_category).addSolution(problem, solution, is_global);
     
     return true;
 }
 
-std::unique_ptr<ConflictResult> MemoryEngine::findSolution(const std::string& problem, 
+std::optional<ConflictResult> MemoryEngine::findSolution(const std::string& problem, 
                                                           const std::string& category) const {
-    auto start_time = std::chrono::high_resolution_clock::now();
-    total_lookups++;
+    LookupTimer timer;
+    
+    // A category hint is used in place; only inferred categories build a string
+    SolutionCache* cache = category.empty() ? getCache(categorizeError(problem)) : getCache(category);
+    
+    std::optional<ConflictResult> result;
+    if (cache) {
+        result = cache->findSolution(problem);
+    }
+    
+    recordLookups(1, result ? 1 : 0, 0, timer);
+    return result;
+}
+
+std::vector<std::optional<ConflictResult>> MemoryEngine::findSolutions(const std::vector<std::string>& problems,
+                                                                       const std::vector<std::string>& categories) const {
+    LookupTimer timer;
+    
+    std::vector<std::optional<ConflictResult>> results(problems.size());
+    
+    // Problems without a category hint are categorized together
+    std::vector<size_t> uncategorized;
+    std::vector<const std::string*> uncategorized_problems;
+    for (size_t i = 0; i < problems.size(); ++i) {
+        if (i >= categories.size() || categories[i].empty()) {
+            uncategorized.push_back(i);
+            uncategorized_problems.push_back(&problems[i]);
+        }
+    }
+    std::vector<std::string> inferred = error_categorizer->categorizeAll(uncategorized_problems);
+    
+    std::vector<const std::string*> final_categories(problems.size());
+    for (size_t i = 0; i < problems.size(); ++i) {
+        if (i < categories.size() && !categories[i].empty()) {
+            final_categories[i] = &categories[i];
+        }
+    }
+    for (size_t j = 0; j < uncategorized.size(); ++j) {
+        final_categories[uncategorized[j]] = &inferred[j];
+    }
+    
+    // Group by category so each cache is resolved and searched once
+    std::unordered_map<std::string_view, std::vector<size_t>> by_category;
+    for (size_t i = 0; i < problems.size(); ++i) {
+        by_category[*final_categories[i]].push_back(i);
+    }
+    
+    uint64_t hits = 0;
+    {
+        EpochGuard guard;
+        const CategoryTable* table = category_table.load(std::memory_order_acquire);
+        
+        for (const auto& [category, indices] : by_category) {
+            auto it = table->find(std::string(category));
+            if (it == table->end()) continue;
+            
+            std::vector<const std::string*> batch;
+            batch.reserve(indices.size());
+            for (size_t i : indices) {
+                batch.push_back(&problems[i]);
+            }
+            
+            auto found = it->second->findSolutions(batch);
+            for (size_t j = 0; j < indices.size(); ++j) {
+                if (found[j]) {
+                    hits++;
+                    results[indices[j]] = std::move(found[j]);
+                }
+            }
+        }
+    }
+    
+    recordLookups(problems.size(), hits, 0, timer);
+    return results;
+}
+
+std::unique_ptr<SimilarProblemMatch> MemoryEngine::findSimilarSolution(const std::string& problem,
+                                                                       const std::string& category,
+                                                                       double min_score) const {
+    LookupTimer timer;
     
     std::string final_category = category;
     if (final_category.empty()) {
         final_category = categorizeError(problem);
     }
     
-    std::unique_ptr<ConflictResult> result = nullptr;
+    std::unique_ptr<SimilarProblemMatch> best = nullptr;
     
     {
-        std::shared_lock<std::shared_mutex> lock(engine_mutex);
+        EpochGuard guard;
+        const CategoryTable* table = category_table.load(std::memory_order_acquire);
+        
+        // Prefer the expected category, then look for a better match elsewhere
+        auto it = table->find(final_category);
+        if (it != table->end()) {
+            best = it->second->findSimilarSolution(problem, min_score);
+        }
         
-        auto it = category_index.find(final_category);
-        if (it != category_index.end()) {
-            result = it->second->findSolution(problem);
-            if (result) {
-                cache_hits++;
+        for (const auto& [name, cache] : *table) {
+            if (name == final_category || (best && best->score >= 1.0)) continue;
+            auto match = cache->findSimilarSolution(problem, best ? best->score : min_score);
+            if (match && (!best || match->score > best->score)) {
+                best = std::move(match);
+                best->category = name;
             }
         }
     }
     
-    auto end_time = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
-    total_lookup_time_us += duration.count();
+    if (best && best->category.empty()) {
+        best->category = final_category;
+    }
     
-    return result;
+    recordLookups(1, best ? 1 : 0, best && best->score < 1.0 ? 1 : 0, timer);
+    return best;
 }
 
 std::string MemoryEngine::categorizeError(const std::string& error_message) const {
@@ -247,21 +1188,31 @@ std::string MemoryEngine::categorizeError(const std::string& error_message) cons
 }
 
 std::string MemoryEngine::getStatistics() const {
-    std::shared_lock<std::shared_mutex> lock(engine_mutex);
+    EpochGuard guard;
+    const CategoryTable* table = category_table.load(std::memory_order_acquire);
+    
+    LookupTotals totals = lookupTotals();
     
     std::stringstream stats;
     stats << "{\n";
-    stats << "  \"total_lookups\": " << total_lookups.load() << ",\n";
-    stats << "  \"cache_hits\": " << cache_hits.load() << ",\n";
-    stats << "  \"hit_rate\": " << (total_lookups > 0 ? 
-                                   static_cast<double>(cache_hits) / total_lookups : 0.0) << ",\n";
-    stats << "  \"avg_lookup_time_us\": " << (total_lookups > 0 ? 
-                                            total_lookup_time_us.load() / total_lookups : 0) << ",\n";
-    stats << "  \"categories\": " << category_index.size() << ",\n";
+    stats << "  \"total_lookups\": " << totals.lookups << ",\n";
+    stats << "  \"cache_hits\": " << totals.hits << ",\n";
+    stats << "  \"similar_hits\": " << totals.similar_hits << ",\n";
+    stats << "  \"hit_rate\": " << (totals.lookups > 0 ? 
+                                   static_cast<double>(totals.hits) / totals.lookups : 0.0) << ",\n";
+    stats << "  \"avg_lookup_time_us\": " << (totals.timed_lookups > 0 ? 
+                                            totals.timed_us / totals.timed_lookups : 0) << ",\n";
+    stats << "  \"categories\": " << table->size() << ",\n";
+    stats << "  \"interned_strings\": " << strings.count() << ",\n";
+    stats << "  \"interned_bytes\": " << strings.bytes() << ",\n";
+    stats << "  \"interned_unreferenced_bytes\": " << strings.unreferencedBytes() << ",\n";
+    stats << "  \"interned_arena_bytes\": " << strings.arenaBytes() << ",\n";
+    stats << "  \"interned_retired_blocks\": " << strings.retiredBlocks() << ",\n";
+    stats << "  \"categorizer\": " << error_categorizer->getStatistics() << ",\n";
     stats << "  \"category_breakdown\": {\n";
     
     bool first = true;
-    for (const auto& [category, cache] : category_index) {
+    for (const auto& [category, cache] : *table) {
         if (!first) stats << ",\n";
         auto [project_count, global_count] = cache->getStats();
         stats << "    \"" << category << "\": {\"project\": " << project_count 
@@ -274,24 +1225,342 @@ std::string MemoryEngine::getStatistics() const {
 }
 
 void MemoryEngine::clear() {
-    std::unique_lock<std::shared_mutex> lock(engine_mutex);
-    category_index.clear();
-    total_lookups = 0;
-    cache_hits = 0;
-    total_lookup_time_us = 0;
+    {
+        // Caches are emptied in place so the category table stays fixed
+        EpochGuard guard;
+        for (const auto& [category, cache] : *category_table.load(std::memory_order_acquire)) {
+            cache->clear();
+        }
+    }
+    
+    for (auto& counters : lookup_counters) {
+        counters.lookups.store(0, std::memory_order_relaxed);
+        counters.hits.store(0, std::memory_order_relaxed);
+        counters.similar_hits.store(0, std::memory_order_relaxed);
+        counters.timed_lookups.store(0, std::memory_order_relaxed);
+        counters.timed_us.store(0, std::memory_order_relaxed);
+    }
+}
+
+MemoryEngine::LookupTimer::LookupTimer() {
+    thread_local uint32_t lookup_sequence = 0;
+    is_sampled = lookup_sequence++ % LOOKUP_TIMING_INTERVAL == 0;
+    if (is_sampled) {
+        start = std::chrono::steady_clock::now();
+    }
+}
+
+uint64_t MemoryEngine::LookupTimer::elapsedMicros() const {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+MemoryEngine::LookupCounters& MemoryEngine::threadCounters() const {
+    // Threads take shards round-robin on first use; the shard is shared by every engine
+    static std::atomic<size_t> next_shard{0};
+    thread_local size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % LOOKUP_COUNTER_SHARDS;
+    return lookup_counters[shard];
+}
+
+void MemoryEngine::recordLookups(uint64_t lookups, uint64_t hits, uint64_t similar_hits,
+                                 const LookupTimer& timer) const {
+    LookupCounters& counters = threadCounters();
+    counters.lookups.fetch_add(lookups, std::memory_order_relaxed);
+    if (hits > 0) counters.hits.fetch_add(hits, std::memory_order_relaxed);
+    if (similar_hits > 0) counters.similar_hits.fetch_add(similar_hits, std::memory_order_relaxed);
+    if (timer.sampled()) {
+        counters.timed_lookups.fetch_add(lookups, std::memory_order_relaxed);
+        counters.timed_us.fetch_add(timer.elapsedMicros(), std::memory_order_relaxed);
+    }
+}
+
+MemoryEngine::LookupTotals MemoryEngine::lookupTotals() const {
+    LookupTotals totals;
+    for (const auto& counters : lookup_counters) {
+        totals.lookups += counters.lookups.load(std::memory_order_relaxed);
+        totals.hits += counters.hits.load(std::memory_order_relaxed);
+        totals.similar_hits += counters.similar_hits.load(std::memory_order_relaxed);
+        totals.timed_lookups += counters.timed_lookups.load(std::memory_order_relaxed);
+        totals.timed_us += counters.timed_us.load(std::memory_order_relaxed);
+    }
+    return totals;
 }
 
 void MemoryEngine::loadSolutions(const std::string& category,
-                                const std::unordered_map<std::string, Solution>& solutions,
+                                const std::unordered_map<std::string, std::string>& solutions,
                                 bool is_global) {
-    std::unique_lock<std::shared_mutex> lock(engine_mutex);
+    SolutionSource source = is_global ? SolutionSource::GLOBAL : SolutionSource::PROJECT;
+    std::vector<std::pair<std::string, Solution>> batch;
+    batch.reserve(solutions.size());
+    for (const auto& [problem, content] : solutions) {
+        batch.emplace_back(problem, Solution(content, source));
+    }
+    getOrCreateCache(category).bulkLoad(batch, is_global, DuplicatePolicy::SKIP_CONTENT, loadThreads());
+}
+
+bool MemoryEngine::loadFromFile(const std::string& path, bool is_global, size_t* loaded, std::string* error) {
+    std::vector<MemoryFileCategory> categories;
+    if (!readMemoryFile(path, categories, error)) {
+        return false;
+    }
+    
+    // Caches are created up front, since creating one takes the engine lock
+    std::vector<SolutionCache*> caches;
+    caches.reserve(categories.size());
+    size_t solution_count = 0;
+    for (const auto& category : categories) {
+        caches.push_back(&getOrCreateCache(category.name));
+        solution_count += category.entries.size();
+    }
+    
+    SolutionSource source = is_global ? SolutionSource::GLOBAL : SolutionSource::PROJECT;
+    int64_t now = epochSeconds();
+    
+    // Each category is built across its shards in parallel and swapped in whole
+    for (size_t i = 0; i < categories.size(); ++i) {
+        std::vector<std::pair<std::string, Solution>> batch;
+        batch.reserve(categories[i].entries.size());
+        for (auto& entry : categories[i].entries) {
+            Solution solution(entry.solution, source);
+            solution.created = entry.created ? entry.created : now;
+            solution.use_count = entry.use_count;
+            batch.emplace_back(std::move(entry.problem), solution);
+        }
+        caches[i]->bulkLoad(batch, is_global, DuplicatePolicy::SKIP_CONTENT, loadThreads());
+    }
+    
+    if (loaded) {
+        *loaded = solution_count;
+    }
+    return true;
+}
+
+bool MemoryEngine::saveSnapshot(const std::string& path) const {
+    SnapshotWriter writer;
+    
+    {
+        EpochGuard guard;
+        const CategoryTable* table = category_table.load(std::memory_order_acquire);
+        
+        for (const auto& [category, cache] : *table) {
+            writer.beginCategory(category);
+            cache->forEachProblem([&](std::string_view problem, const SolutionSet& solutions) {
+                std::vector<SnapshotSolution> stored;
+                for (const auto& solution : solutions.project) stored.push_back(toSnapshot(solution, false));
+                for (const auto& solution : solutions.global) stored.push_back(toSnapshot(solution, true));
+                writer.addProblem(problem, stored);
+            });
+        }
+    }
+    
+    return writer.write(path);
+}
+
+bool MemoryEngine::loadSnapshot(const std::string& path) {
+    auto snapshot = MemorySnapshot::open(path);
+    if (!snapshot) {
+        return false;
+    }
     
-    if (category_index.find(category) == category_index.end()) {
-        category_index[category] = std::make_unique<SolutionCache>();
+    std::unordered_map<std::string, size_t> snapshot_categories;
+    for (size_t i = 0; i < snapshot->categoryCount(); ++i) {
+        snapshot_categories.emplace(std::string(snapshot->categoryName(i)), i);
     }
     
-    for (const auto& [problem, solution] : solutions) {
-        category_index[category]->addSolution(problem, solution, is_global);
+    for (const auto& [category, index] : snapshot_categories) {
+        getOrCreateCache(category).attachSnapshot(snapshot, index);
+    }
+    
+    // Categories absent from the snapshot stop serving any earlier one
+    EpochGuard guard;
+    for (const auto& [category, cache] : *category_table.load(std::memory_order_acquire)) {
+        if (!snapshot_categories.count(category)) {
+            cache->detachSnapshot();
+        }
+    }
+    
+    return true;
+}
+
+bool MemoryEngine::openWriteAheadLog(const std::string& log_path, const std::string& snapshot_path,
+                                     const WalOptions& options) {
+    std::lock_guard<std::mutex> lock(compaction_mutex);
+    if (wal.load(std::memory_order_acquire)) {
+        return false;
+    }
+    
+    // A log rotated by an interrupted compaction is older than the live one
+    replayWriteAheadLog(log_path + ".compacting");
+    replayWriteAheadLog(log_path);
+    
+    auto log = std::make_unique<WriteAheadLog>(options);
+    if (!log->open(log_path)) {
+        return false;
+    }
+    log->setCompactionHandler([this] { compact(); });
+    
+    wal_path = log_path;
+    wal_snapshot_path = snapshot_path;
+    
+    std::lock_guard<std::mutex> engine_lock(engine_mutex);
+    write_ahead_log = std::move(log);
+    wal.store(write_ahead_log.get(), std::memory_order_release);
+    return true;
+}
+
+void MemoryEngine::replayWriteAheadLog(const std::string& path) {
+    // Consecutive records for the same category and side are applied as one batch
+    std::string category;
+    bool is_global = false;
+    std::vector<std::pair<std::string, Solution>> batch;
+    
+    auto apply = [&] {
+        if (batch.empty()) return;
+        // Records already folded into a loaded snapshot replay as exact duplicates
+        getOrCreateCache(category).addSolutions(batch, is_global, DuplicatePolicy::SKIP_IDENTICAL);
+        for (const auto& [problem, solution] : batch) {
+            strings.release(solution.content); // The cache holds its own reference
+        }
+        batch.clear();
+    };
+    
+    WriteAheadLog::replay(path, [&](const WalRecord& record) {
+        if (record.type == WalRecord::Type::USE_COUNT) {
+            // Counts the solution it raises, so the stores before it go first
+            apply();
+            Solution solution(record.content, record.is_global ? SolutionSource::GLOBAL : SolutionSource::PROJECT);
+            solution.use_count = record.use_count;
+            getOrCreateCache(record.category).restoreUseCount(record.problem, solution);
+            return;
+        }
+        
+        if (record.category != category || record.is_global != is_global) {
+            apply();
+            category = record.category;
+            is_global = record.is_global;
+        }
+        
+        // The record is reused for the next one, so its text is interned right away
+        Solution solution(strings.intern(record.content), record.is_global ? SolutionSource::GLOBAL : SolutionSource::PROJECT);
+        solution.created = record.created;
+        solution.use_count = record.use_count;
+        batch.emplace_back(record.problem, std::move(solution));
+    });
+    apply();
+}
+
+bool MemoryEngine::compact() {
+    std::lock_guard<std::mutex> lock(compaction_mutex);
+    WriteAheadLog* log = wal.load(std::memory_order_acquire);
+    if (!log) {
+        return false;
+    }
+    
+    // Stores racing with the snapshot may land in both it and the new log; replay skips those
+    std::string rotated = wal_path + ".compacting";
+    if (std::ifstream(rotated).good()) {
+        // Left by a failed compaction; fold it in before rotating over it
+        if (!saveSnapshot(wal_snapshot_path)) {
+            return false;
+        }
+        std::remove(rotated.c_str());
+    }
+    
+    {
+        // Rotating under the barrier waits out stores that are logged but not yet
+        // applied, so every record in the rotated log is in the caches the snapshot walks
+        std::lock_guard<std::mutex> turnstile(store_turnstile);
+        std::unique_lock<std::shared_mutex> barrier(store_barrier);
+        if (!log->rotate(rotated)) {
+            return false;
+        }
+    }
+    if (!saveSnapshot(wal_snapshot_path)) {
+        return false;
+    }
+    
+    std::remove(rotated.c_str());
+    return true;
+}
+
+size_t MemoryEngine::flushUseCounts() {
+    WriteAheadLog* log = wal.load(std::memory_order_acquire);
+    if (!log) {
+        return 0;
+    }
+    
+    // The guard keeps the collected solutions alive until they are marked logged
+    EpochGuard guard;
+    std::vector<WalRecord> records;
+    std::vector<std::pair<SolutionCache*, SolutionCache::UseCountBatch>> batches;
+    for (const auto& [category, cache] : *category_table.load(std::memory_order_acquire)) {
+        SolutionCache::UseCountBatch& batch = batches.emplace_back(cache, SolutionCache::UseCountBatch()).second;
+        cache->collectUseCounts([&, &category = category](std::string_view problem, const Solution& solution) {
+            WalRecord record;
+            record.type = WalRecord::Type::USE_COUNT;
+            record.is_global = solution.source == SolutionSource::GLOBAL;
+            record.created = solution.created;
+            record.use_count = solution.use_count;
+            record.category = category;
+            record.problem = problem;
+            record.content = solution.content;
+            records.push_back(std::move(record));
+        }, batch);
+    }
+    if (records.empty()) {
+        return 0;
+    }
+    
+    // Counts are marked logged only once they are in the log; a failed
+    // append leaves them for the next flush
+    bool logged = log->append(records.data(), records.size());
+    for (const auto& [cache, batch] : batches) {
+        cache->finishUseCounts(batch, logged);
+    }
+    return logged ? records.size() : 0;
+}
+
+SolutionCache* MemoryEngine::getCache(const std::string& category) const {
+    EpochGuard guard;
+    const CategoryTable* table = category_table.load(std::memory_order_acquire);
+    auto it = table->find(category);
+    return it != table->end() ? it->second : nullptr;
+}
+
+SolutionCache& MemoryEngine::getOrCreateCache(const std::string& category) {
+    if (SolutionCache* cache = getCache(category)) {
+        return *cache;
+    }
+    
+    // Categories outside the configured table are added on first use
+    std::lock_guard<std::mutex> lock(engine_mutex);
+    const CategoryTable* current = category_table.load(std::memory_order_acquire);
+    auto it = current->find(category);
+    if (it != current->end()) {
+        return *it->second;
+    }
+    
+    auto capacity = history_capacities.find(category);
+    auto policy = conflict_policies.find(category);
+    category_caches.push_back(std::make_unique<SolutionCache>(strings,
+        capacity != history_capacities.end() ? capacity->second : SolutionCache::DEFAULT_HISTORY_CAPACITY,
+        policy != conflict_policies.end() ? policy->second : default_conflict_policy));
+    SolutionCache* cache = category_caches.back().get();
+    
+    auto next = std::make_unique<CategoryTable>(*current);
+    next->emplace(category, cache);
+    category_table.store(next.release(), std::memory_order_release);
+    EpochManager::instance().retire(current);
+    
+    return *cache;
+}
+
+void MemoryEngine::buildCategoryTable() {
+    auto categories = error_categorizer->getCategories();
+    categories.push_back("errors_uncategorised");
+    
+    for (const auto& category : categories) {
+        getOrCreateCache(category);
     }
 }
 
@@ -320,7 +1589,7 @@ SolutionScorer::QualityMetrics SolutionScorer::getDetailedMetrics(
     return metrics;
 }
 
-double SolutionScorer::scoreCompleteness(const std::string& solution_content) const {
+double SolutionScorer::scoreCompleteness(std::string_view solution_content) const {
     double score = 0.0;
     
     // Length-based scoring (reasonable solutions should have substance)
@@ -339,7 +1608,7 @@ double SolutionScorer::scoreCompleteness(const std::string& solution_content) co
     return std::min(1.0, score);
 }
 
-double SolutionScorer::scoreClarity(const std::string& solution_content) const {
+double SolutionScorer::scoreClarity(std::string_view solution_content) const {
     double score = 0.5; // Base score
     
     // Penalty for extremely short solutions
@@ -361,12 +1630,12 @@ double SolutionScorer::scoreClarity(const std::string& solution_content) const {
     return std::max(0.0, std::min(1.0, score));
 }
 
-double SolutionScorer::scoreSpecificity(const std::string& solution_content,
+double SolutionScorer::scoreSpecificity(std::string_view solution_content,
                                        const std::string& problem_context) const {
     double score = 0.2; // Base score
     
     // Convert to lowercase for case-insensitive matching
-    std::string lower_solution = solution_content;
+    std::string lower_solution(solution_content);
     std::string lower_problem = problem_context;
     std::transform(lower_solution.begin(), lower_solution.end(), lower_solution.begin(), ::tolower);
     std::transform(lower_problem.begin(), lower_problem.end(), lower_problem.begin(), ::tolower);
@@ -403,9 +1672,7 @@ double SolutionScorer::scoreReliability(const Solution& solution,
     double score = 0.5; // Base score
     
     // Age-based scoring (newer is generally better)
-    auto now = std::chrono::system_clock::now();
-    auto created_time = std::chrono::system_clock::from_time_t(std::stoll(solution.created_date));
-    auto age_days = std::chrono::duration_cast<std::chrono::hours>(now - created_time).count() / 24;
+    int64_t age_days = (epochSeconds() - solution.created) / SECONDS_PER_DAY;
     
     if (age_days < 30) score += 0.3;
     else if (age_days < 90) score += 0.2;
@@ -420,7 +1687,7 @@ double SolutionScorer::scoreReliability(const Solution& solution,
     return std::max(0.0, std::min(1.0, score));
 }
 
-double SolutionScorer::scoreContextRelevance(const std::string& solution_content,
+double SolutionScorer::scoreContextRelevance(std::string_view solution_content,
                                             const std::string& problem_context) const {
     double score = 0.3; // Base score
     
@@ -460,25 +1727,21 @@ std::vector<std::pair<ConflictResult, double>> EnhancedMemoryEngine::findRankedS
     // Get category to search in
     std::string search_category = category.empty() ? categorizeError(problem) : category;
     
-    std::shared_lock<std::shared_mutex> lock(engine_mutex);
-    auto it = category_index.find(search_category);
-    if (it == category_index.end()) {
+    SolutionCache* cache = getCache(search_category);
+    if (!cache) {
         return ranked_solutions; // Empty result
     }
     
     // Get all solutions for the problem
-    auto cache = it->second.get();
     auto all_solutions = cache->getAllSolutions(problem);
     
     // Score each solution
     std::unordered_map<std::string, int> usage_stats; // Simplified for now
     
     for (const auto& solution : all_solutions) {
-        auto conflict_result = std::make_unique<ConflictResult>(
-            solution, ConflictStrategy::DEFAULT_LOCAL_PREFERENCE, "AI-ranked result");
-        
         double score = solution_scorer->scoreSolution(solution, problem, usage_stats);
-        ranked_solutions.emplace_back(*conflict_result, score);
+        ranked_solutions.emplace_back(
+            ConflictResult(solution, ConflictStrategy::DEFAULT_LOCAL_PREFERENCE, ResolutionReason::RANKED), score);
     }
     
     // Sort by score (highest first)
@@ -495,6 +1758,7 @@ std::vector<std::pair<ConflictResult, double>> EnhancedMemoryEngine::findRankedS
 
 std::string EnhancedMemoryEngine::getSuggestions(const std::string& problem,
                                                 const std::string& context) const {
+    EpochGuard guard; // Keeps the ranked solutions' text alive until it is written out
     auto ranked_solutions = findRankedSolutions(problem, "", 5);
     
     std::ostringstream json;
@@ -507,9 +1771,9 @@ std::string EnhancedMemoryEngine::getSuggestions(const std::string& problem,
         json << "{"
              << "\"solution\":\"" << result.solution.content << "\","
              << "\"score\":" << std::fixed << std::setprecision(3) << score << ","
-             << "\"source\":\"" << result.solution.source << "\","
+             << "\"source\":\"" << sourceName(result.solution.source) << "\","
              << "\"use_count\":" << result.solution.use_count << ","
-             << "\"created_date\":\"" << result.solution.created_date << "\""
+             << "\"created_date\":\"" << result.solution.created << "\""
              << "}";
     }
     
@@ -2,6 +2,7 @@
 #define MEMORY_ENGINE_H
 
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <regex>
@@ -10,29 +11,136 @@
 #include <mutex>
 #include <shared_mutex>
 #include <atomic>
+#include <functional>
+#include <cstdint>
+#include <optional>
+#include <algorithm>
+#include "pattern_matcher.h"
+#include "text_index.h"
+#include "epoch.h"
+#include "snapshot.h"
+#include "wal.h"
+#include "problem_table.h"
+#include "string_interner.h"
 
 namespace brains {
 
+/**
+ * @brief Where a solution was learned
+ */
+enum class SolutionSource : uint8_t {
+    PROJECT,
+    GLOBAL
+};
+
+/**
+ * @brief Binding-facing name of a solution source: "project" or "global"
+ */
+inline const char* sourceName(SolutionSource source) {
+    return source == SolutionSource::GLOBAL ? "global" : "project";
+}
+
+/**
+ * @brief Current time in seconds since the Unix epoch
+ */
+inline int64_t epochSeconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Use count of a solution, bumped by lookups without locking
+ *
+ * A hit is one relaxed atomic add on the stored solution, so counting never
+ * takes a lock on the read path. Copies take the current value, which keeps
+ * Solution a plain value type; converts to and from uint32_t. The count last
+ * written to the write-ahead log rides along, so a flush logs only the
+ * solutions whose count moved since.
+ */
+class UseCount {
+public:
+    UseCount(uint32_t count = 1) : count(count), logged(count) {}
+    UseCount(const UseCount& other) : count(other), logged(other.logged.load(std::memory_order_relaxed)) {}
+    UseCount& operator=(const UseCount& other) {
+        count.store(other, std::memory_order_relaxed);
+        logged.store(other.logged.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return *this;
+    }
+    
+    operator uint32_t() const { return count.load(std::memory_order_relaxed); }
+    
+    /**
+     * @brief Count one more use; stops at UINT32_MAX
+     * @return The count including this use
+     */
+    uint32_t increment() const {
+        uint32_t current = count.load(std::memory_order_relaxed);
+        while (current != UINT32_MAX && !count.compare_exchange_weak(current, current + 1, std::memory_order_relaxed)) {}
+        return current == UINT32_MAX ? current : current + 1;
+    }
+    
+    /**
+     * @brief Count uses recorded elsewhere; stops at UINT32_MAX
+     */
+    void add(uint32_t uses) const {
+        uint32_t current = count.load(std::memory_order_relaxed);
+        while (uses && !count.compare_exchange_weak(current, current > UINT32_MAX - uses ? UINT32_MAX : current + uses,
+                                                    std::memory_order_relaxed)) {}
+    }
+    
+    /**
+     * @brief Raise the count to a logged value; lower values are ignored
+     */
+    void restore(uint32_t uses) const {
+        uint32_t current = count.load(std::memory_order_relaxed);
+        while (current < uses && !count.compare_exchange_weak(current, uses, std::memory_order_relaxed)) {}
+        logged.store(std::max(current, uses), std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief Read the count if it moved since it was last marked logged
+     */
+    bool unlogged(uint32_t& uses) const {
+        uses = count.load(std::memory_order_relaxed);
+        return uses != logged.load(std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief Record that a count reached the log; a higher logged count is kept
+     */
+    void markLogged(uint32_t uses) const {
+        uint32_t current = logged.load(std::memory_order_relaxed);
+        while (current < uses && !logged.compare_exchange_weak(current, uses, std::memory_order_relaxed)) {}
+    }
+    
+private:
+    mutable std::atomic<uint32_t> count;
+    mutable std::atomic<uint32_t> logged;
+};
+
 /**
  * @brief Structure representing a solution with metadata
+ *
+ * Timestamps stay numeric so conflict resolution compares them directly;
+ * they are formatted only where results cross into a binding. Content is a
+ * view into the engine's StringInterner or an attached snapshot, so copying
+ * a Solution never copies its text. Stored solutions keep their text
+ * referenced; a returned one stays valid while the caller holds an
+ * EpochGuard taken before the lookup, or once its ConflictResult is detached.
  */
 struct Solution {
-    std::string content;
-    std::string created_date;
-    int use_count;
-    std::string source; // "project" or "global"
-    
-    Solution() : use_count(1), source("project") {}
-    Solution(const std::string& content, const std::string& source = "project") 
-        : content(content), use_count(1), source(source) {
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        created_date = std::to_string(time_t);
-    }
+    std::string_view content;
+    int64_t created;    // Seconds since the Unix epoch
+    UseCount use_count; // Stores and successful lookups
+    SolutionSource source;
+    
+    Solution() : created(0), use_count(1), source(SolutionSource::PROJECT) {}
+    explicit Solution(std::string_view content, SolutionSource source = SolutionSource::PROJECT)
+        : content(content), created(epochSeconds()), use_count(1), source(source) {}
 };
 
 /**
- * @brief Conflict resolution strategies
+ * @brief Conflict resolution strategies, tried in this order
  */
 enum class ConflictStrategy {
     RECENT_PROJECT_PRIORITY,    // Project solutions < 30 days always win
@@ -41,43 +149,336 @@ enum class ConflictStrategy {
     DEFAULT_LOCAL_PREFERENCE   // Default to project solution
 };
 
+/**
+ * @brief Thresholds of the conflict resolution rules, set per category
+ *
+ * The defaults are the limits noted on ConflictStrategy. A
+ * recent_project_days of 0, an age_difference_days of UINT32_MAX or an
+ * infinite popularity_ratio switches that rule off. A popularity_ratio
+ * below 1, NaN included, counts as 1.
+ */
+struct ConflictPolicy {
+    uint32_t recent_project_days = 30;  // Project solutions younger than this always win
+    uint32_t age_difference_days = 90;  // Past this age difference the newer solution wins
+    double popularity_ratio = 3.0;      // Past this use count ratio the more used solution wins
+    uint32_t global_max_age_days = 180; // A lone global solution is used while younger than this
+};
+
+/**
+ * @brief Why conflict resolution picked a solution
+ */
+enum class ResolutionReason : uint8_t {
+    DEFAULT,
+    ONLY_PROJECT,           // No global solution stored
+    ONLY_RECENT_GLOBAL,     // No project solution; global one within 6 months
+    RECENT_PROJECT,         // Project solution < 30 days old
+    NEWER_SOLUTION,         // Age difference > 90 days
+    POPULAR_SOLUTION,       // Use count ratio > 3x
+    LOCAL_PREFERENCE,       // No rule applied
+    RANKED                  // Listed by findRankedSolutions
+};
+
 /**
  * @brief Result of conflict resolution with metadata
+ *
+ * Returned by value: the solution is a copy whose content views interned
+ * text, so building a result allocates nothing. The figures a rule compared
+ * are kept instead of a message, and reason() formats them on demand.
  */
 struct ConflictResult {
     Solution solution;
     ConflictStrategy strategy;
-    std::string reason;
+    ResolutionReason reason_code;
+    uint32_t age_difference_days; // NEWER_SOLUTION
+    uint32_t project_use_count;   // POPULAR_SOLUTION
+    uint32_t global_use_count;    // POPULAR_SOLUTION
     
-    ConflictResult() : strategy(ConflictStrategy::DEFAULT_LOCAL_PREFERENCE), reason("Default") {}
-    ConflictResult(const Solution& sol, ConflictStrategy strat, const std::string& reason)
-        : solution(sol), strategy(strat), reason(reason) {}
+    ConflictResult()
+        : strategy(ConflictStrategy::DEFAULT_LOCAL_PREFERENCE), reason_code(ResolutionReason::DEFAULT),
+          age_difference_days(0), project_use_count(0), global_use_count(0) {}
+    ConflictResult(const Solution& sol, ConflictStrategy strat, ResolutionReason reason)
+        : solution(sol), strategy(strat), reason_code(reason),
+          age_difference_days(0), project_use_count(0), global_use_count(0) {}
+    
+    /**
+     * @brief Human-readable explanation of the resolution
+     */
+    std::string reason() const;
+    
+    /**
+     * @brief Copy the solution text into the result, for results kept past the caller's EpochGuard
+     */
+    void detach() {
+        owned_content = std::make_shared<const std::string>(solution.content);
+        solution.content = *owned_content;
+    }
+    
+private:
+    std::shared_ptr<const std::string> owned_content; // Set by detach(); shared by copies
+};
+
+/**
+ * @brief Approximate problem match with its resolved solution
+ */
+struct SimilarProblemMatch {
+    std::string category; // Set by MemoryEngine; empty from SolutionCache
+    std::string problem;  // Stored problem that matched
+    double score;         // Similarity in [0, 1]; 1.0 for an exact match
+    ConflictResult result;
+    
+    SimilarProblemMatch(const std::string& problem, double score, const ConflictResult& result)
+        : problem(problem), score(score), result(result) {}
+};
+
+/**
+ * @brief How addSolutions treats a solution already in the problem's history
+ */
+enum class DuplicatePolicy {
+    KEEP,           // Always append
+    SKIP_CONTENT,   // Skip if the same side already holds this content
+    SKIP_IDENTICAL  // Skip only exact replays: same content and created time
+};
+
+/**
+ * @brief Copy of the solutions stored for one problem, oldest first
+ */
+struct SolutionSet {
+    std::vector<Solution> project;
+    std::vector<Solution> global;
+};
+
+/**
+ * @brief Fixed-capacity ring holding one side of a problem's solution history
+ *
+ * A single writer (holding its shard's write_mutex) fills the next slot and
+ * retires the solution it evicts through the EpochManager, so a store never
+ * copies or shifts the history. Slots are published individually under a
+ * sequence counter: readers inside an EpochGuard get the latest solution
+ * with one load, and whole-history reads retry if a store overlaps them.
+ */
+class SolutionHistory {
+public:
+    explicit SolutionHistory(size_t capacity);
+    ~SolutionHistory();
+    
+    SolutionHistory(const SolutionHistory&) = delete;
+    SolutionHistory& operator=(const SolutionHistory&) = delete;
+    
+    /**
+     * @brief Append a solution, evicting the oldest once full; writer only
+     * @param strings Interner the evicted solution's text is released to
+     * @return true if the history was empty before
+     */
+    bool push(std::unique_ptr<const Solution> solution, StringInterner& strings);
+    
+    /**
+     * @brief Most recent solution, nullptr if none; caller holds an EpochGuard
+     */
+    const Solution* latest() const;
+    
+    /**
+     * @brief Every held solution, oldest first; caller holds an EpochGuard
+     */
+    std::vector<const Solution*> entries() const;
+    
+    bool empty() const { return latest() == nullptr; }
+    
+private:
+    std::unique_ptr<std::atomic<const Solution*>[]> slots;
+    size_t capacity;
+    std::atomic<uint64_t> sequence{0}; // Twice the completed pushes; odd while a push is in progress
 };
 
 /**
  * @brief High-performance cache for category-based solution storage
+ *
+ * Problems are striped across SHARD_COUNT shards by hash. Readers never lock:
+ * each shard publishes an insert-only open-addressing ProblemTable through an
+ * atomic pointer, and each problem keeps its project and global histories
+ * side by side in SolutionHistory rings, so a lookup is one probe sequence
+ * into one entry. Writers insert and append in place, serialized per shard;
+ * outgrown tables and evicted solutions are retired through the EpochManager.
+ * The shard tables are published together as one TableSet, so a bulk load can
+ * build replacement tables off to the side and swap them all in at once.
+ *
+ * Each entry caches the outcome of the time-dependent conflict rules, decided
+ * when a solution is stored, together with the time at which a rule boundary
+ * (such as a project solution turning 30 days old) makes it stale; lookups
+ * apply it without re-running the rules and re-decide only once it expires.
+ *
+ * A cache may also serve one category of a mapped MemorySnapshot as a
+ * read-only base layer. Live entries shadow the snapshot: the first store to
+ * a snapshot problem seeds its live entry with the snapshot's solutions.
  */
 class SolutionCache {
 private:
-    std::unordered_map<std::string, std::vector<Solution>> project_solutions;
-    std::unordered_map<std::string, std::vector<Solution>> global_solutions;
-    mutable std::shared_mutex cache_mutex;
+    static constexpr size_t SHARD_COUNT = 16;
+    static constexpr size_t BULK_SOLUTIONS_PER_THREAD = 4096; // Below this a bulk load adds no thread
+    
+    struct ProblemEntry {
+        std::string_view problem; // Interned
+        SolutionHistory project;
+        SolutionHistory global;
+        mutable std::atomic<uint64_t> decision{0}; // Packed result of decide(); 0 until first decided
+        
+        ProblemEntry(std::string_view problem, size_t capacity)
+            : problem(problem), project(capacity), global(capacity) {}
+    };
+    
+    // ConflictPolicy in the units decide() compares
+    struct CompiledPolicy {
+        int64_t recent_project_seconds;
+        int64_t newer_solution_seconds; // Smallest age difference that counts as newer
+        int64_t global_max_age_seconds;
+        double popularity_ratio;        // At least 1; infinity switches the rule off
+        
+        explicit CompiledPolicy(const ConflictPolicy& policy);
+    };
+    
+    struct SnapshotLayer {
+        std::shared_ptr<const MemorySnapshot> snapshot;
+        size_t category;    // Category index within the snapshot
+        uint64_t generation; // Distinguishes successive layers for match indexing
+        uint32_t first_solution; // Lowest solution record of the category
+        std::unique_ptr<std::atomic<uint32_t>[]> hits; // Lookups since attaching, by record from first_solution
+        std::unique_ptr<uint32_t[]> logged_hits;       // Hits already logged; guarded by use_count_mutex
+    };
+    
+    using EntryTable = ProblemTable<ProblemEntry>;
+    
+    // Current table of every shard; copied and republished whenever one is replaced
+    struct TableSet {
+        EntryTable* shards[SHARD_COUNT]; // Inserted into in place; replaced when it grows
+    };
+    
+    struct Shard {
+        std::vector<std::unique_ptr<ProblemEntry>> entries; // Owns table entries; guarded by write_mutex
+        std::mutex write_mutex;
+        std::atomic<size_t> project_count{0};
+        std::atomic<size_t> global_count{0};
+    };
+    
+    Shard shards[SHARD_COUNT];
+    std::atomic<const TableSet*> tables{nullptr};
+    std::mutex publish_mutex; // Serializes replacing tables
+    StringInterner& strings;
+    const size_t history_capacity;
+    const CompiledPolicy policy;
+    mutable ProblemMatchIndex match_index; // Snapshot problems are indexed lazily by readers
+    mutable std::shared_mutex index_mutex; // Guards match_index and indexed_generation
+    
+    std::atomic<const SnapshotLayer*> snapshot_layer{nullptr};
+    std::atomic<uint64_t> snapshot_generation{0};
+    std::atomic<size_t> snapshot_project_count{0}; // Unshadowed snapshot problems
+    std::atomic<size_t> snapshot_global_count{0};
+    mutable uint64_t indexed_generation = 0; // Snapshot layer already added to match_index
+    
+    mutable std::atomic<bool> uses_dirty{false}; // Set by hits and failed flushes, cleared by collectUseCounts
+    std::mutex use_count_mutex;                   // Serializes collecting and restoring use counts
+    void markUsed() const {
+        if (!uses_dirty.load(std::memory_order_relaxed)) uses_dirty.store(true, std::memory_order_relaxed);
+    }
+    
+    // Low hash bits pick the table slot, so shards take high ones
+    static size_t shardIndex(uint64_t hash) { return (hash >> 48) % SHARD_COUNT; }
+    // Caller holds an EpochGuard, or the shard's write_mutex
+    EntryTable* shardTable(size_t shard) const { return tables.load(std::memory_order_acquire)->shards[shard]; }
+    void publishTables(const std::vector<std::pair<size_t, EntryTable*>>& replacements);
+    void releaseEntry(const ProblemEntry& entry);
+    void seedFromSnapshot(Shard& shard, ProblemEntry& entry, std::string_view problem);
+    const ProblemEntry* findEntry(std::string_view problem) const;
+    std::unique_ptr<SolutionSet> findSnapshotSolutions(std::string_view problem) const;
+    static std::unique_ptr<SolutionSet> snapshotSolutions(const SnapshotLayer& layer,
+                                                          const MemorySnapshot::ProblemView& view);
+    std::optional<ConflictResult> resolveHit(const ProblemEntry* entry, std::string_view problem) const;
+    std::optional<ConflictResult> resolveEntry(const ProblemEntry& entry, const Solution** chosen) const;
+    uint64_t decide(const Solution* project, const Solution* global, int64_t now) const;
+    std::optional<ConflictResult> applyDecision(uint64_t decision, const Solution* project,
+                                                const Solution* global, const Solution** chosen) const;
+    void indexSnapshotProblems() const;
+    void appendSolution(Shard& shard, ProblemEntry& entry, const Solution& solution, bool is_global,
+                        DuplicatePolicy duplicates);
+    static void copyHistory(const SolutionHistory& history, std::vector<Solution>& out);
+    std::optional<ConflictResult> resolveConflict(const Solution* project, const Solution* global,
+                                                  const Solution** chosen = nullptr) const;
+    std::optional<ConflictResult> resolveConflict(const SolutionSet& solutions,
+                                                  const Solution** chosen = nullptr) const;
     
 public:
+    static constexpr size_t DEFAULT_HISTORY_CAPACITY = 5;
+    static constexpr size_t MAX_HISTORY_CAPACITY = 0xFFFF; // Snapshot records count each side in 16 bits
+    
+    /**
+     * @param strings Interner that stored problems and solution text are kept in; must outlive the cache
+     * @param history_capacity Solutions kept per problem and side; clamped to [1, MAX_HISTORY_CAPACITY]
+     * @param policy Thresholds conflict resolution applies in this cache
+     */
+    explicit SolutionCache(StringInterner& strings, size_t history_capacity = DEFAULT_HISTORY_CAPACITY,
+                           const ConflictPolicy& policy = ConflictPolicy());
+    ~SolutionCache();
+    
+    SolutionCache(const SolutionCache&) = delete;
+    SolutionCache& operator=(const SolutionCache&) = delete;
+    
+
     /**
      * @brief Add a solution to the cache
      * @param problem Problem identifier
-     * @param solution Solution object
+     * @param solution Solution object; its content is interned, so it only needs to outlive the call
      * @param is_global Whether this is a global solution
      */
     void addSolution(const std::string& problem, const Solution& solution, bool is_global = false);
     
+    /**
+     * @brief Add several solutions, publishing each shard's table once
+     * @param solutions Problem and solution pairs
+     * @param is_global Whether these are global solutions
+     * @param duplicates Whether solutions already in a problem's history are appended again
+     */
+    void addSolutions(const std::vector<std::pair<std::string, Solution>>& solutions, bool is_global = false,
+                      DuplicatePolicy duplicates = DuplicatePolicy::KEEP);
+    
+    /**
+     * @brief Add a large batch of solutions as one atomic update
+     * @param solutions Problem and solution pairs
+     * @param is_global Whether these are global solutions
+     * @param duplicates Whether solutions already in a problem's history are appended again
+     * @param threads Most threads to build shards on, the caller's included
+     *
+     * Each affected shard gets a replacement table sized for its final problem
+     * count, holding copies of the entries the batch changes, built in
+     * parallel. Readers keep using the current tables until every shard is
+     * built and then see the whole batch at once; writers to the affected
+     * shards wait for the load.
+     */
+    void bulkLoad(const std::vector<std::pair<std::string, Solution>>& solutions, bool is_global,
+                  DuplicatePolicy duplicates, size_t threads);
+    
     /**
      * @brief Find the best solution for a problem with conflict resolution
      * @param problem Problem identifier
-     * @return ConflictResult with chosen solution and resolution strategy
+     * @return ConflictResult with chosen solution and resolution strategy, empty if not found
+     *
+     * A hit counts one use of the chosen solution; the returned use_count includes it.
      */
-    std::unique_ptr<ConflictResult> findSolution(const std::string& problem) const;
+    std::optional<ConflictResult> findSolution(const std::string& problem) const;
+    
+    /**
+     * @brief Find solutions for several problems under one epoch guard
+     * @param problems Problem identifiers
+     * @return One result per problem, in input order; empty where not found
+     */
+    std::vector<std::optional<ConflictResult>> findSolutions(
+        const std::vector<const std::string*>& problems) const;
+    
+    /**
+     * @brief Find the closest stored problem and resolve its solution
+     * @param problem Problem description, matched approximately
+     * @param min_score Minimum similarity in [0, 1] for a match
+     * @return Best match with a usable solution, nullptr if none scores high enough
+     */
+    std::unique_ptr<SimilarProblemMatch> findSimilarSolution(const std::string& problem,
+                                                             double min_score) const;
     
     /**
      * @brief Get all solutions for a problem (for debugging)
@@ -87,7 +488,61 @@ public:
     std::vector<Solution> getAllSolutions(const std::string& problem) const;
     
     /**
-     * @brief Clear cache
+     * @brief Serve one category of a snapshot as the read-only base layer
+     * @param snapshot Mapped snapshot, kept alive while attached
+     * @param category Category index within the snapshot
+     */
+    void attachSnapshot(std::shared_ptr<const MemorySnapshot> snapshot, size_t category);
+    
+    /**
+     * @brief Stop serving the snapshot base layer; live entries are kept
+     */
+    void detachSnapshot();
+    
+    /**
+     * @brief Visit every stored problem, live and snapshot, with its solutions
+     * @param visit Called once per problem under an epoch guard
+     */
+    void forEachProblem(const std::function<void(std::string_view, const SolutionSet&)>& visit) const;
+    
+    /**
+     * @brief Use counts visited by collectUseCounts, to be passed to finishUseCounts
+     */
+    struct UseCountBatch {
+        std::vector<std::pair<const UseCount*, uint32_t>> solutions;
+        const SnapshotLayer* layer = nullptr;
+        std::vector<std::pair<size_t, uint32_t>> snapshot_hits; // Record from first_solution, hits
+    };
+    
+    /**
+     * @brief Visit the solutions whose use count moved since it was last logged
+     * @param visit Called with the problem and a copy of the solution carrying its count
+     * @param batch Receives the visited counts
+     *
+     * Lookup hits are not logged as they happen; a caller persisting counts
+     * collects them in batches. Solutions served from the snapshot layer are
+     * included with their hits added. Call under an epoch guard that is held
+     * until finishUseCounts.
+     */
+    void collectUseCounts(const std::function<void(std::string_view, const Solution&)>& visit,
+                          UseCountBatch& batch);
+    
+    /**
+     * @brief Settle a collected batch once the caller knows whether it was persisted
+     * @param logged true marks the counts logged; false leaves them for the next collection
+     */
+    void finishUseCounts(const UseCountBatch& batch, bool logged);
+    
+    /**
+     * @brief Raise a stored solution's use count to a logged value
+     * @param problem Problem identifier
+     * @param solution Content, source and use count of the solution to find
+     * @return true if a stored solution with that content was found
+     */
+    bool restoreUseCount(std::string_view problem, const Solution& solution);
+    
+    /**
+     * @brief Clear cache, including any attached snapshot
      */
     void clear();
     
@@ -98,17 +553,41 @@ public:
 };
 
 /**
- * @brief Fast error categorization engine using compiled regex patterns
+ * @brief Entry in the ordered error category table
+ */
+struct CategoryDefinition {
+    std::string name;
+    std::vector<std::string> patterns;
+    int priority; // Lower values are matched first; ties keep table order
+    size_t history_capacity; // Solutions kept per problem and side; 0 for the default
+    std::optional<ConflictPolicy> conflict_policy; // In place of the engine's default policy
+    
+    CategoryDefinition() : priority(0), history_capacity(0) {}
+    CategoryDefinition(const std::string& name, const std::vector<std::string>& patterns, int priority = 0,
+                       size_t history_capacity = 0)
+        : name(name), patterns(patterns), priority(priority), history_capacity(history_capacity) {}
+};
+
+/**
+ * @brief Fast error categorization engine using a single multi-pattern automaton
  */
 class ErrorCategorizer {
 private:
-    std::unordered_map<std::string, std::vector<std::regex>> category_patterns;
+    std::vector<std::string> category_names; // Indexed by category id, in priority order
+    std::unique_ptr<MultiPatternMatcher> matcher;
     mutable std::shared_mutex patterns_mutex;
     
 public:
+    /**
+     * @brief Load error categories from an ordered table
+     * @param categories Category definitions; when several match, the lowest
+     *        priority wins and ties are broken by table order
+     */
+    void loadCategories(const std::vector<CategoryDefinition>& categories);
+    
     /**
      * @brief Load error categories from configuration
-     * @param categories Map of category name to regex patterns
+     * @param categories Map of category name to regex patterns, ordered by name
      */
     void loadCategories(const std::unordered_map<std::string, std::vector<std::string>>& categories);
     
@@ -119,11 +598,24 @@ public:
      */
     std::string categorize(const std::string& error_message) const;
     
+    /**
+     * @brief Categorize several error messages under one lock acquisition
+     * @param error_messages The error messages to categorize
+     * @return Category name per message, in input order
+     */
+    std::vector<std::string> categorizeAll(const std::vector<const std::string*>& error_messages) const;
+    
     /**
      * @brief Get all available categories
-     * @return Vector of category names
+     * @return Vector of category names in match order
      */
     std::vector<std::string> getCategories() const;
+    
+    /**
+     * @brief Get matcher statistics
+     * @return JSON-formatted automaton statistics
+     */
+    std::string getStatistics() const;
 };
 
 /**
@@ -131,14 +623,73 @@ public:
  */
 class MemoryEngine {
 protected:
-    std::unordered_map<std::string, std::unique_ptr<SolutionCache>> category_index;
+    // Category table is created at initialize and only grows. It is published
+    // copy-on-write so lookups resolve categories without locking; caches are
+    // never removed, so pointers into the table stay valid for the engine's life
+    using CategoryTable = std::unordered_map<std::string, SolutionCache*>;
+    std::atomic<const CategoryTable*> category_table;
+    StringInterner strings; // Problem and solution text for every cache; declared before them so it outlives them
+    std::vector<std::unique_ptr<SolutionCache>> category_caches; // Guarded by engine_mutex
     std::unique_ptr<ErrorCategorizer> error_categorizer;
-    mutable std::shared_mutex engine_mutex;
+    std::mutex engine_mutex; // Serializes category table writers
+    std::unordered_map<std::string, size_t> history_capacities; // Per-category overrides; guarded by engine_mutex
+    std::unordered_map<std::string, ConflictPolicy> conflict_policies; // Per-category overrides; guarded by engine_mutex
+    ConflictPolicy default_conflict_policy; // Guarded by engine_mutex
+    
+    SolutionCache* getCache(const std::string& category) const;
+    SolutionCache& getOrCreateCache(const std::string& category);
+    void buildCategoryTable();
     
-    // Performance metrics
-    mutable std::atomic<uint64_t> total_lookups{0};
-    mutable std::atomic<uint64_t> cache_hits{0};
-    mutable std::atomic<uint64_t> total_lookup_time_us{0};
+    // Durable store log, opened once by openWriteAheadLog. Stores are logged
+    // before they are applied; compaction folds the log into a snapshot
+    std::unique_ptr<WriteAheadLog> write_ahead_log; // Guarded by engine_mutex
+    std::atomic<WriteAheadLog*> wal{nullptr};
+    std::string wal_path;
+    std::string wal_snapshot_path;
+    std::mutex compaction_mutex;
+    std::shared_mutex store_barrier; // Shared by logged stores from append to apply; exclusive while compaction rotates
+    std::mutex store_turnstile;      // Held by compaction while it waits, so new stores cannot starve it
+    
+    void replayWriteAheadLog(const std::string& path);
+    
+    // Performance metrics, sharded by thread so concurrent lookups never
+    // write the same cache line; getStatistics sums the shards. Only every
+    // LOOKUP_TIMING_INTERVAL-th lookup of a thread reads the clock
+    static constexpr size_t LOOKUP_COUNTER_SHARDS = 16;
+    static constexpr uint32_t LOOKUP_TIMING_INTERVAL = 16;
+    
+    struct alignas(64) LookupCounters {
+        std::atomic<uint64_t> lookups{0};
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> similar_hits{0};
+        std::atomic<uint64_t> timed_lookups{0};
+        std::atomic<uint64_t> timed_us{0};
+    };
+    
+    struct LookupTotals {
+        uint64_t lookups = 0;
+        uint64_t hits = 0;
+        uint64_t similar_hits = 0;
+        uint64_t timed_lookups = 0;
+        uint64_t timed_us = 0;
+    };
+    
+    // Starts the clock for the sampled lookups of the calling thread only
+    class LookupTimer {
+    public:
+        LookupTimer();
+        bool sampled() const { return is_sampled; }
+        uint64_t elapsedMicros() const;
+    private:
+        bool is_sampled;
+        std::chrono::steady_clock::time_point start;
+    };
+    
+    mutable LookupCounters lookup_counters[LOOKUP_COUNTER_SHARDS];
+    
+    LookupCounters& threadCounters() const;
+    void recordLookups(uint64_t lookups, uint64_t hits, uint64_t similar_hits, const LookupTimer& timer) const;
+    LookupTotals lookupTotals() const;
     
 public:
     /**
@@ -158,6 +709,17 @@ public:
      */
     bool initialize(const std::unordered_map<std::string, std::vector<std::string>>& categories);
     
+    /**
+     * @brief Initialize the engine with an ordered error category table
+     * @param categories Category definitions in match order; a history
+     *        capacity or conflict policy applies to caches created by this call
+     * @param default_policy Conflict policy of categories that set none,
+     *        including those first seen later
+     * @return true if successful
+     */
+    bool initialize(const std::vector<CategoryDefinition>& categories,
+                    const ConflictPolicy& default_policy = ConflictPolicy());
+    
     /**
      * @brief Store a solution in the memory system
      * @param problem Problem description
@@ -175,10 +737,32 @@ public:
      * @brief Find a solution for a problem
      * @param problem Problem description
      * @param category Optional category hint (empty for auto-categorization)
-     * @return ConflictResult with solution and metadata, nullptr if not found
+     * @return ConflictResult with solution and metadata, empty if not found
+     *
+     * A hit with a category hint allocates nothing.
+     */
+    std::optional<ConflictResult> findSolution(const std::string& problem, 
+                                              const std::string& category = "") const;
+    
+    /**
+     * @brief Find solutions for a batch of problems in one pass
+     * @param problems Problem descriptions
+     * @param categories Category hint per problem; missing or empty entries are auto-categorized
+     * @return One result per problem, in input order; empty where not found
+     */
+    std::vector<std::optional<ConflictResult>> findSolutions(const std::vector<std::string>& problems,
+                                                             const std::vector<std::string>& categories = {}) const;
+    
+    /**
+     * @brief Find a solution for the closest stored problem
+     * @param problem Problem description, matched approximately
+     * @param category Optional category hint; other categories are searched if it has no match
+     * @param min_score Minimum similarity in [0, 1] for a match
+     * @return Best match with solution and metadata, nullptr if not found
      */
-    std::unique_ptr<ConflictResult> findSolution(const std::string& problem, 
-                                                const std::string& category = "") const;
+    std::unique_ptr<SimilarProblemMatch> findSimilarSolution(const std::string& problem,
+                                                             const std::string& category = "",
+                                                             double min_score = 0.5) const;
     
     /**
      * @brief Categorize an error message
@@ -198,15 +782,85 @@ public:
      */
     void clear();
     
+    /**
+     * @brief Write every category, problem and solution to a binary snapshot
+     * @param path Snapshot path; replaced atomically
+     * @return true if the snapshot was written
+     */
+    bool saveSnapshot(const std::string& path) const;
+    
+    /**
+     * @brief Serve lookups from a memory-mapped snapshot
+     * @param path Snapshot written by saveSnapshot
+     * @return true if the snapshot was valid and attached
+     *
+     * Categories in the snapshot are created if needed. Solutions stored
+     * afterwards shadow the snapshot's entries for the same problem.
+     */
+    bool loadSnapshot(const std::string& path);
+    
+    /**
+     * @brief Replay and then append every store to a write-ahead log
+     * @param log_path Log file; created if missing
+     * @param snapshot_path Snapshot that compaction folds the log into
+     * @param options Commit and compaction tuning
+     * @return true if the log was replayed and opened; false if already open
+     *
+     * Load the snapshot first, then open the log: records the snapshot
+     * already holds are recognised on replay and skipped. From then on
+     * storeSolution returns only once its record is logged (durably, with
+     * sync_commit), and the log is compacted into snapshot_path whenever it
+     * outgrows options.compact_bytes.
+     */
+    bool openWriteAheadLog(const std::string& log_path, const std::string& snapshot_path,
+                           const WalOptions& options = WalOptions());
+    
+    /**
+     * @brief Fold the write-ahead log into its snapshot and start an empty log
+     * @return true if the snapshot was written; the old log is kept otherwise
+     */
+    bool compact();
+    
+    /**
+     * @brief Log the use counts lookups have raised since the last flush
+     * @return Number of solutions whose count was logged; 0 without a log
+     *
+     * Hits are counted in memory only, so they outlive a restart once they
+     * are flushed here, compacted, or saved in a snapshot. The engine flushes
+     * once more when it is destroyed with a log open.
+     */
+    size_t flushUseCounts();
+    
     /**
      * @brief Load solutions from external source (for bulk loading)
      * @param category Category name
-     * @param solutions Map of problem to solution
+     * @param solutions Map of problem to solution content
      * @param is_global Whether these are global solutions
+     *
+     * Solutions whose content the problem already holds are skipped, so
+     * reloading the same source does not grow the history. The category is
+     * bulk loaded: lookups see either none or all of the solutions.
      */
     void loadSolutions(const std::string& category,
-                      const std::unordered_map<std::string, Solution>& solutions,
+                      const std::unordered_map<std::string, std::string>& solutions,
                       bool is_global = false);
+    
+    /**
+     * @brief Load a structured memory file (YAML or JSON) straight into the caches
+     * @param path File in the lessons_learned layout of structured_memory.yaml
+     * @param is_global Whether its solutions are global
+     * @param loaded Receives the number of solutions read, if given
+     * @param error Receives a description when the file is unusable
+     * @return false if the file cannot be read or parsed
+     *
+     * Created dates and use counts are kept; solutions without a created
+     * date are stamped with the load time. Each category is bulk loaded, so
+     * lookups keep being served from the previous contents until it is
+     * swapped in whole. As with loadSolutions, solutions whose content the
+     * problem already holds are skipped.
+     */
+    bool loadFromFile(const std::string& path, bool is_global = false,
+                      size_t* loaded = nullptr, std::string* error = nullptr);
 };
 
 /**
@@ -250,13 +904,13 @@ public:
                                      const std::string& problem_context) const;
     
 private:
-    double scoreCompleteness(const std::string& solution_content) const;
-    double scoreClarity(const std::string& solution_content) const;
-    double scoreSpecificity(const std::string& solution_content,
+    double scoreCompleteness(std::string_view solution_content) const;
+    double scoreClarity(std::string_view solution_content) const;
+    double scoreSpecificity(std::string_view solution_content,
                            const std::string& problem_context) const;
     double scoreReliability(const Solution& solution,
                            const std::unordered_map<std::string, int>& usage_stats) const;
-    double scoreContextRelevance(const std::string& solution_content,
+    double scoreContextRelevance(std::string_view solution_content,
                                 const std::string& problem_context) const;
 };
 
@@ -0,0 +1,805 @@
+#include "memory_file.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace brains {
+
+namespace {
+
+/**
+ * @brief Malformed input; caught by readMemoryFile and reported through its error string
+ */
+struct MemoryFileError : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+// Days since 1970-01-01 of a proleptic Gregorian date
+int64_t daysFromCivil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    unsigned year_of_era = static_cast<unsigned>(year - era * 400);
+    unsigned day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    unsigned day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + static_cast<int64_t>(day_of_era) - 719468;
+}
+
+// Reads exactly count digits at pos
+bool readDigits(std::string_view text, size_t& pos, size_t count, int& value) {
+    if (pos + count > text.size()) return false;
+    value = 0;
+    for (size_t i = 0; i < count; ++i) {
+        char c = text[pos + i];
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + (c - '0');
+    }
+    pos += count;
+    return true;
+}
+
+void appendUtf8(std::string& out, uint32_t code_point) {
+    if (code_point < 0x80) {
+        out += static_cast<char>(code_point);
+    } else if (code_point < 0x800) {
+        out += static_cast<char>(0xC0 | (code_point >> 6));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    } else if (code_point < 0x10000) {
+        out += static_cast<char>(0xE0 | (code_point >> 12));
+        out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code_point >> 18));
+        out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+}
+
+// Parses count hex digits at pos
+uint32_t readHex(std::string_view text, size_t& pos, size_t count) {
+    if (pos + count > text.size()) {
+        throw MemoryFileError("truncated escape sequence");
+    }
+    uint32_t value = 0;
+    for (size_t i = 0; i < count; ++i) {
+        char c = text[pos++];
+        value <<= 4;
+        if (c >= '0' && c <= '9') value |= c - '0';
+        else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+        else throw MemoryFileError("invalid hex digit in escape sequence");
+    }
+    return value;
+}
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t';
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && isSpace(text.front())) text.remove_prefix(1);
+    while (!text.empty() && isSpace(text.back())) text.remove_suffix(1);
+    return text;
+}
+
+// Use counts that are missing, zero or not a plain number count as 1
+uint32_t parseUseCount(std::string_view text) {
+    text = trim(text);
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string_view::npos) return 1;
+
+    uint64_t value = 0;
+    for (char c : text) {
+        value = std::min<uint64_t>(value * 10 + (c - '0'), UINT32_MAX);
+    }
+    return value ? static_cast<uint32_t>(value) : 1;
+}
+
+int64_t parseCreated(std::string_view text) {
+    int64_t seconds = 0;
+    return parseTimestamp(trim(text), seconds) ? seconds : 0;
+}
+
+/**
+ * @brief Fields of one problem as they are read
+ */
+struct PendingEntry {
+    std::string solution;
+    int64_t created = 0;
+    uint32_t use_count = 1;
+
+    void set(std::string_view field, std::string value) {
+        if (field == "solution") solution = std::move(value);
+        else if (field == "created_date") created = parseCreated(value);
+        else if (field == "use_count") use_count = parseUseCount(value);
+    }
+};
+
+/**
+ * @brief Reader for the block-style YAML subset that js-yaml dumps
+ *
+ * Handles nested block mappings with plain, single- and double-quoted
+ * keys; plain, quoted (including multi-line) and literal or folded block
+ * scalar values; empty flow mappings; and comments. Block sequences and
+ * non-empty flow collections are skipped wherever a value is not needed.
+ */
+class YamlReader {
+public:
+    explicit YamlReader(std::string_view text) {
+        size_t start = 0;
+        while (start < text.size()) {
+            size_t end = text.find('\n', start);
+            if (end == std::string_view::npos) end = text.size();
+            std::string_view line = text.substr(start, end - start);
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+            size_t indent = 0;
+            while (indent < line.size() && line[indent] == ' ') ++indent;
+            lines.push_back({indent, line.substr(indent)});
+            start = end + 1;
+        }
+    }
+
+    void read(std::vector<MemoryFileCategory>& categories) {
+        // Directives and the document start marker carry nothing the importer needs
+        while (next < lines.size() &&
+               (isBlank(lines[next]) ||
+                (lines[next].indent == 0 && (lines[next].text.rfind("%", 0) == 0 || lines[next].text.rfind("---", 0) == 0)))) {
+            ++next;
+        }
+
+        readMapping(0, [&](const std::string& section, std::string_view section_value, size_t section_indent) {
+            if (section != "lessons_learned" || !section_value.empty()) return;
+
+            readMapping(section_indent + 1, [&](const std::string& category, std::string_view category_value,
+                                                size_t category_indent) {
+                if (!category_value.empty()) return; // {} or a stray scalar
+
+                MemoryFileCategory lessons{category, {}};
+                readMapping(category_indent + 1, [&](const std::string& problem, std::string_view problem_value,
+                                                     size_t problem_indent) {
+                    if (!problem_value.empty()) return;
+
+                    PendingEntry entry;
+                    readMapping(problem_indent + 1, [&](const std::string& field, std::string_view value,
+                                                        size_t field_indent) {
+                        entry.set(field, readScalar(value, field_indent));
+                    });
+                    if (!entry.solution.empty()) {
+                        lessons.entries.push_back({problem, std::move(entry.solution), entry.created, entry.use_count});
+                    }
+                });
+
+                if (!lessons.entries.empty()) {
+                    categories.push_back(std::move(lessons));
+                }
+            });
+        });
+    }
+
+private:
+    struct Line {
+        size_t indent;         // Leading spaces
+        std::string_view text; // Remainder, without a trailing CR
+    };
+
+    std::vector<Line> lines;
+    size_t next = 0;
+
+    static bool isBlank(const Line& line) {
+        std::string_view text = trim(line.text);
+        return text.empty() || text.front() == '#';
+    }
+
+    [[noreturn]] void fail(const std::string& message, size_t line) const {
+        throw MemoryFileError("line " + std::to_string(line + 1) + ": " + message);
+    }
+
+    // Next line with content, skipping blank and comment lines
+    const Line* peek() {
+        while (next < lines.size() && isBlank(lines[next])) ++next;
+        if (next < lines.size() && lines[next].indent == 0 &&
+            (lines[next].text.rfind("...", 0) == 0 || lines[next].text.rfind("---", 0) == 0)) {
+            next = lines.size(); // End of the first document
+        }
+        return next < lines.size() ? &lines[next] : nullptr;
+    }
+
+    // Skip the rest of a node whose key sits at indent, including a
+    // sequence written at the key's own indentation
+    void skipNode(size_t indent) {
+        while (const Line* line = peek()) {
+            bool sequence_item = line->indent == indent &&
+                                 (line->text == "-" || line->text.rfind("- ", 0) == 0);
+            if (line->indent <= indent && !sequence_item) break;
+            ++next;
+        }
+    }
+
+    /**
+     * Visits each key of the block mapping starting at the next line, whose
+     * keys must be indented at least min_indent. visit(key, rest, indent)
+     * gets the value text after the colon (empty if the value is a nested
+     * block) and may consume the value's lines; whatever it leaves is skipped.
+     */
+    template<typename Visit>
+    void readMapping(size_t min_indent, Visit&& visit) {
+        const Line* first = peek();
+        if (!first || first->indent < min_indent) return;
+        size_t indent = first->indent;
+
+        while (const Line* line = peek()) {
+            if (line->indent < min_indent) break;
+            if (line->indent != indent) fail("inconsistent indentation", next);
+            if (line->text == "-" || line->text.rfind("- ", 0) == 0) fail("expected a mapping, found a sequence", next);
+
+            std::string key;
+            std::string_view rest;
+            if (line->text == "?" || line->text.rfind("? ", 0) == 0) {
+                rest = readExplicitKey(indent, key);
+            } else {
+                size_t colon = findKeyColon(line->text, &key);
+                if (colon == std::string_view::npos) fail("expected 'key: value'", next);
+                rest = valueText(line->text.substr(colon + 1));
+                ++next;
+            }
+            visit(key, rest, indent);
+            skipNode(indent);
+        }
+    }
+
+    /**
+     * Finds the colon ending the key at the start of text, decoding the key
+     * into key if given.
+     * @return Offset of the colon, or npos if text does not start with a key
+     */
+    static size_t findKeyColon(std::string_view text, std::string* key) {
+        if (text.empty()) return std::string_view::npos;
+
+        if (text.front() == '"' || text.front() == '\'') {
+            std::string decoded;
+            size_t end = 0;
+            if (!decodeQuoted(text, decoded, end)) return std::string_view::npos;
+            size_t colon = end;
+            while (colon < text.size() && isSpace(text[colon])) ++colon;
+            if (colon >= text.size() || text[colon] != ':' ||
+                (colon + 1 < text.size() && !isSpace(text[colon + 1]))) {
+                return std::string_view::npos;
+            }
+            if (key) *key = std::move(decoded);
+            return colon;
+        }
+
+        // A plain key ends at the first colon followed by a space or the end of the line
+        for (size_t colon = text.find(':'); colon != std::string_view::npos; colon = text.find(':', colon + 1)) {
+            if (colon + 1 == text.size() || isSpace(text[colon + 1])) {
+                if (key) *key = std::string(trim(text.substr(0, colon)));
+                return colon;
+            }
+        }
+        return std::string_view::npos;
+    }
+
+    // Value text after a key's colon, with comments and empty flow mappings reduced to "" and "{}"
+    static std::string_view valueText(std::string_view rest) {
+        rest = trim(rest);
+        if (!rest.empty() && rest.front() == '#') return std::string_view();
+        if (rest.rfind("{}", 0) == 0) return std::string_view("{}");
+        return rest;
+    }
+
+    /**
+     * Reads an explicit "? key" entry, as written for keys spanning lines,
+     * up to and including its ": value" line. A nested mapping may start on
+     * that line; its first key is then left in place for the caller to read.
+     */
+    std::string_view readExplicitKey(size_t indent, std::string& key) {
+        size_t key_line = next;
+        std::string_view key_text = trim(lines[next++].text.substr(1));
+        key = readScalar(key_text, indent);
+
+        const Line* value_line = peek();
+        if (!value_line || value_line->indent != indent || value_line->text.front() != ':' ||
+            (value_line->text.size() > 1 && !isSpace(value_line->text[1]))) {
+            fail("expected ': value' after explicit key", key_line);
+        }
+
+        size_t offset = 1;
+        while (offset < value_line->text.size() && isSpace(value_line->text[offset])) ++offset;
+        std::string_view rest = value_line->text.substr(offset);
+        if (findKeyColon(rest, nullptr) != std::string_view::npos) {
+            lines[next] = {indent + offset, rest};
+            return std::string_view();
+        }
+        ++next;
+        return valueText(rest);
+    }
+
+    /**
+     * Decodes the quoted scalar at the start of text into out, folding line
+     * breaks as YAML flow scalars do. end receives the offset just past the
+     * closing quote.
+     * @return false if text ends before the closing quote
+     */
+    static bool decodeQuoted(std::string_view text, std::string& out, size_t& end) {
+        char quote = text.front();
+        out.clear();
+        size_t pos = 1;
+
+        while (pos < text.size()) {
+            char c = text[pos];
+
+            if (c == quote) {
+                if (quote == '\'' && pos + 1 < text.size() && text[pos + 1] == '\'') {
+                    out += '\'';
+                    pos += 2;
+                    continue;
+                }
+                end = pos + 1;
+                return true;
+            }
+
+            if (c == '\n') {
+                // A single break folds to a space; each further (blank) line is a newline
+                while (!out.empty() && isSpace(out.back())) out.pop_back();
+                size_t breaks = 0;
+                while (pos < text.size() && (text[pos] == '\n' || isSpace(text[pos]))) {
+                    breaks += text[pos] == '\n';
+                    ++pos;
+                }
+                out.append(breaks > 1 ? breaks - 1 : 1, breaks > 1 ? '\n' : ' ');
+                continue;
+            }
+
+            if (c != '\\' || quote == '\'') {
+                out += c;
+                ++pos;
+                continue;
+            }
+
+            if (++pos >= text.size()) return false;
+            char escape = text[pos++];
+            switch (escape) {
+                case '0': out += '\0'; break;
+                case 'a': out += '\a'; break;
+                case 'b': out += '\b'; break;
+                case 't': case '\t': out += '\t'; break;
+                case 'n': out += '\n'; break;
+                case 'v': out += '\v'; break;
+                case 'f': out += '\f'; break;
+                case 'r': out += '\r'; break;
+                case 'e': out += '\x1b'; break;
+                case ' ': out += ' '; break;
+                case '"': out += '"'; break;
+                case '/': out += '/'; break;
+                case '\\': out += '\\'; break;
+                case 'N': appendUtf8(out, 0x85); break;
+                case '_': appendUtf8(out, 0xA0); break;
+                case 'L': appendUtf8(out, 0x2028); break;
+                case 'P': appendUtf8(out, 0x2029); break;
+                case 'x': appendUtf8(out, readHex(text, pos, 2)); break;
+                case 'u': appendUtf8(out, readHex(text, pos, 4)); break;
+                case 'U': appendUtf8(out, readHex(text, pos, 8)); break;
+                case '\n':
+                    // Escaped line break: join without a space
+                    while (pos < text.size() && isSpace(text[pos])) ++pos;
+                    break;
+                default:
+                    throw MemoryFileError(std::string("unknown escape sequence \\") + escape);
+            }
+        }
+        return false;
+    }
+
+    // Reads the scalar value of a key at key_indent, consuming continuation lines
+    std::string readScalar(std::string_view rest, size_t key_indent) {
+        // Tags and anchors do not change the text
+        while (!rest.empty() && (rest.front() == '!' || rest.front() == '&')) {
+            size_t space = rest.find(' ');
+            rest = space == std::string_view::npos ? std::string_view() : trim(rest.substr(space));
+        }
+
+        if (rest.empty()) {
+            // A plain scalar may start on the next, more indented line
+            const Line* line = peek();
+            bool nested = !line || line->indent <= key_indent || line->text.front() == '-' ||
+                          line->text.front() == '?' || findKeyColon(line->text, nullptr) != std::string_view::npos;
+            return nested ? std::string() : readPlainScalar(rest, key_indent);
+        }
+        if (rest == "{}" || rest.front() == '{' || rest.front() == '[' || rest.front() == '*') {
+            return std::string(); // Collection or alias: not a text value
+        }
+        if (rest.front() == '|' || rest.front() == '>') {
+            return readBlockScalar(rest, key_indent);
+        }
+        if (rest.front() == '"' || rest.front() == '\'') {
+            return readQuotedScalar(rest, key_indent);
+        }
+        return readPlainScalar(rest, key_indent);
+    }
+
+    std::string readQuotedScalar(std::string_view rest, size_t key_indent) {
+        size_t first_line = next - 1;
+        std::string text(rest);
+        std::string value;
+        size_t end = 0;
+
+        // Continuation lines are appended until the closing quote turns up
+        while (!decodeQuoted(text, value, end)) {
+            if (next >= lines.size() || (!isBlank(lines[next]) && lines[next].indent <= key_indent)) {
+                fail("unterminated quoted scalar", first_line);
+            }
+            text += '\n';
+            text += trim(lines[next++].text);
+        }
+        return value;
+    }
+
+    std::string readPlainScalar(std::string_view rest, size_t key_indent) {
+        auto stripComment = [](std::string_view text) {
+            for (size_t i = 1; i < text.size(); ++i) {
+                if (text[i] == '#' && isSpace(text[i - 1])) return trim(text.substr(0, i));
+            }
+            return text;
+        };
+
+        std::string value(stripComment(rest));
+        if (value == "~" || value == "null" || value == "Null" || value == "NULL") {
+            value.clear();
+        }
+
+        // More-indented lines continue the scalar; breaks fold like quoted ones
+        size_t blank_lines = 0;
+        for (size_t i = next; i < lines.size(); ++i) {
+            if (trim(lines[i].text).empty()) {
+                ++blank_lines;
+                continue;
+            }
+            if (lines[i].indent <= key_indent || lines[i].text.front() == '#') break;
+
+            if (!value.empty()) value.append(blank_lines ? blank_lines : 1, blank_lines ? '\n' : ' ');
+            value += stripComment(trim(lines[i].text));
+            blank_lines = 0;
+            next = i + 1;
+        }
+        return value;
+    }
+
+    std::string readBlockScalar(std::string_view header, size_t key_indent) {
+        bool folded = header.front() == '>';
+        char chomping = 'c'; // Clip: keep a single final newline
+        size_t indent = 0;
+        for (size_t i = 1; i < header.size() && !isSpace(header[i]); ++i) {
+            char c = header[i];
+            if (c == '-' || c == '+') chomping = c;
+            else if (c >= '1' && c <= '9') indent = key_indent + (c - '0');
+            else fail("invalid block scalar header", next - 1);
+        }
+
+        // Content lines; an unset indent is taken from the first non-empty line
+        std::vector<std::string_view> content;
+        for (; next < lines.size(); ++next) {
+            const Line& line = lines[next];
+            if (trim(line.text).empty()) {
+                content.push_back(std::string_view());
+                continue;
+            }
+            if (!indent) {
+                if (line.indent <= key_indent) break;
+                indent = line.indent;
+            }
+            if (line.indent < indent) break;
+
+            // Indentation past the block's is part of the text; those spaces precede line.text in the buffer
+            size_t extra = line.indent - indent;
+            content.push_back(std::string_view(line.text.data() - extra, line.text.size() + extra));
+        }
+
+        size_t trailing_blanks = 0;
+        while (!content.empty() && content.back().empty()) {
+            content.pop_back();
+            ++trailing_blanks;
+        }
+
+        std::string value;
+        if (folded) {
+            size_t pending_breaks = 0;
+            bool has_text = false;
+            bool previous_indented = false;
+            for (std::string_view line : content) {
+                if (line.empty()) {
+                    ++pending_breaks;
+                    continue;
+                }
+                bool indented = isSpace(line.front());
+                if (has_text) {
+                    if (pending_breaks) {
+                        value.append(pending_breaks + (previous_indented || indented), '\n');
+                    } else {
+                        value += previous_indented || indented ? '\n' : ' ';
+                    }
+                } else {
+                    value.append(pending_breaks, '\n');
+                }
+                value += line;
+                has_text = true;
+                previous_indented = indented;
+                pending_breaks = 0;
+            }
+        } else {
+            for (size_t i = 0; i < content.size(); ++i) {
+                if (i) value += '\n';
+                value += content[i];
+            }
+        }
+
+        if (!content.empty() && chomping != '-') value += '\n';
+        if (chomping == '+') value.append(trailing_blanks, '\n');
+        return value;
+    }
+};
+
+/**
+ * @brief Reader for the same structure written as JSON
+ */
+class JsonReader {
+public:
+    explicit JsonReader(std::string_view text) : text(text) {}
+
+    void read(std::vector<MemoryFileCategory>& categories) {
+        readObject([&](const std::string& section) {
+            if (section != "lessons_learned" || !atObject()) return skipValue();
+
+            readObject([&](const std::string& category) {
+                if (!atObject()) return skipValue();
+
+                MemoryFileCategory lessons{category, {}};
+                readObject([&](const std::string& problem) {
+                    if (!atObject()) return skipValue();
+
+                    PendingEntry entry;
+                    readObject([&](const std::string& field) {
+                        entry.set(field, readScalar());
+                    });
+                    if (!entry.solution.empty()) {
+                        lessons.entries.push_back({problem, std::move(entry.solution), entry.created, entry.use_count});
+                    }
+                });
+
+                if (!lessons.entries.empty()) {
+                    categories.push_back(std::move(lessons));
+                }
+            });
+        });
+
+        skipWhitespace();
+        if (pos != text.size()) fail("unexpected data after the top-level object");
+    }
+
+private:
+    std::string_view text;
+    size_t pos = 0;
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw MemoryFileError("offset " + std::to_string(pos) + ": " + message);
+    }
+
+    void skipWhitespace() {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r')) {
+            ++pos;
+        }
+    }
+
+    bool atObject() {
+        skipWhitespace();
+        return pos < text.size() && text[pos] == '{';
+    }
+
+    void expect(char c) {
+        skipWhitespace();
+        if (pos >= text.size() || text[pos] != c) fail(std::string("expected '") + c + "'");
+        ++pos;
+    }
+
+    // Calls visit(key) with the position at each member's value, which visit must consume
+    template<typename Visit>
+    void readObject(Visit&& visit) {
+        expect('{');
+        skipWhitespace();
+        if (pos < text.size() && text[pos] == '}') {
+            ++pos;
+            return;
+        }
+
+        while (true) {
+            skipWhitespace();
+            std::string key = readString();
+            expect(':');
+            visit(key);
+
+            skipWhitespace();
+            if (pos < text.size() && text[pos] == ',') {
+                ++pos;
+                continue;
+            }
+            expect('}');
+            return;
+        }
+    }
+
+    std::string readString() {
+        if (pos >= text.size() || text[pos] != '"') fail("expected a string");
+        ++pos;
+
+        std::string out;
+        while (true) {
+            if (pos >= text.size()) fail("unterminated string");
+            char c = text[pos++];
+            if (c == '"') return out;
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+
+            if (pos >= text.size()) fail("unterminated string");
+            char escape = text[pos++];
+            switch (escape) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    uint32_t code_point = readHex(text, pos, 4);
+                    // Surrogate pairs encode code points above the basic plane
+                    if (code_point >= 0xD800 && code_point < 0xDC00 &&
+                        text.substr(pos, 2) == "\\u") {
+                        size_t low_pos = pos + 2;
+                        uint32_t low = readHex(text, low_pos, 4);
+                        if (low >= 0xDC00 && low < 0xE000) {
+                            code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                            pos = low_pos;
+                        }
+                    }
+                    appendUtf8(out, code_point);
+                    break;
+                }
+                default:
+                    fail(std::string("unknown escape sequence \\") + escape);
+            }
+        }
+    }
+
+    // String contents, or the literal text of a number or boolean; null and containers read as ""
+    std::string readScalar() {
+        skipWhitespace();
+        if (pos >= text.size()) fail("expected a value");
+        if (text[pos] == '"') return readString();
+        if (text[pos] == '{' || text[pos] == '[') {
+            skipValue();
+            return std::string();
+        }
+
+        size_t start = pos;
+        while (pos < text.size() && text[pos] != ',' && text[pos] != '}' && text[pos] != ']' &&
+               !isSpace(text[pos]) && text[pos] != '\n' && text[pos] != '\r') {
+            ++pos;
+        }
+        if (pos == start) fail("expected a value");
+        std::string_view literal = text.substr(start, pos - start);
+        return literal == "null" ? std::string() : std::string(literal);
+    }
+
+    void skipValue() {
+        skipWhitespace();
+        if (pos >= text.size()) fail("expected a value");
+
+        if (text[pos] == '{') {
+            readObject([&](const std::string&) { skipValue(); });
+        } else if (text[pos] == '[') {
+            ++pos;
+            skipWhitespace();
+            if (pos < text.size() && text[pos] == ']') {
+                ++pos;
+                return;
+            }
+            while (true) {
+                skipValue();
+                skipWhitespace();
+                if (pos < text.size() && text[pos] == ',') {
+                    ++pos;
+                    continue;
+                }
+                expect(']');
+                return;
+            }
+        } else {
+            readScalar();
+        }
+    }
+};
+
+} // namespace
+
+bool parseTimestamp(std::string_view text, int64_t& seconds) {
+    size_t pos = 0;
+    int year, month, day;
+    if (!readDigits(text, pos, 4, year) || pos >= text.size() || text[pos++] != '-' ||
+        !readDigits(text, pos, 2, month) || pos >= text.size() || text[pos++] != '-' ||
+        !readDigits(text, pos, 2, day) || month < 1 || month > 12 || day < 1 || day > 31) {
+        return false;
+    }
+
+    int hour = 0, minute = 0, second = 0;
+    int64_t offset = 0;
+    if (pos < text.size()) {
+        if (text[pos] != 'T' && text[pos] != 't' && text[pos] != ' ') return false;
+        ++pos;
+        if (!readDigits(text, pos, 2, hour) || pos >= text.size() || text[pos++] != ':' ||
+            !readDigits(text, pos, 2, minute) || hour > 23 || minute > 59) {
+            return false;
+        }
+        if (pos < text.size() && text[pos] == ':') {
+            ++pos;
+            if (!readDigits(text, pos, 2, second) || second > 60) return false;
+        }
+        if (pos < text.size() && text[pos] == '.') {
+            ++pos;
+            while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') ++pos; // Sub-second part is dropped
+        }
+        while (pos < text.size() && text[pos] == ' ') ++pos;
+
+        if (pos < text.size()) {
+            if (text[pos] == 'Z' || text[pos] == 'z') {
+                ++pos;
+            } else if (text[pos] == '+' || text[pos] == '-') {
+                int sign = text[pos++] == '-' ? -1 : 1;
+                int offset_hours = 0, offset_minutes = 0;
+                if (!readDigits(text, pos, 2, offset_hours)) return false;
+                if (pos < text.size() && text[pos] == ':') ++pos;
+                if (pos < text.size() && !readDigits(text, pos, 2, offset_minutes)) return false;
+                offset = sign * (offset_hours * 3600 + offset_minutes * 60);
+            }
+        }
+        if (pos != text.size()) return false;
+    }
+
+    seconds = daysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day)) * 86400 +
+              hour * 3600 + minute * 60 + second - offset;
+    return true;
+}
+
+bool readMemoryFile(const std::string& path, std::vector<MemoryFileCategory>& categories, std::string* error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    std::string contents = buffer.str();
+
+    std::string_view text(contents);
+    if (text.rfind("\xEF\xBB\xBF", 0) == 0) text.remove_prefix(3); // UTF-8 byte order mark
+
+    size_t first = text.find_first_not_of(" \t\r\n");
+    std::vector<MemoryFileCategory> parsed;
+    try {
+        if (first != std::string_view::npos && text[first] == '{') {
+            JsonReader(text).read(parsed);
+        } else {
+            YamlReader(text).read(parsed);
+        }
+    } catch (const MemoryFileError& e) {
+        if (error) *error = path + ": " + e.what();
+        return false;
+    }
+
+    categories = std::move(parsed);
+    return true;
+}
+
+} // namespace brains
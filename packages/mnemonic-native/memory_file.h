@@ -0,0 +1,56 @@
+#ifndef MEMORY_FILE_H
+#define MEMORY_FILE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace brains {
+
+/**
+ * @brief One lesson read from a structured memory file
+ */
+struct MemoryFileEntry {
+    std::string problem;
+    std::string solution;
+    int64_t created = 0;    // Seconds since the Unix epoch; 0 if absent or unparseable
+    uint32_t use_count = 1;
+};
+
+/**
+ * @brief Lessons of one category, in file order
+ */
+struct MemoryFileCategory {
+    std::string name;
+    std::vector<MemoryFileEntry> entries;
+};
+
+/**
+ * @brief Parse an ISO 8601 date or date-time into seconds since the Unix epoch
+ *
+ * Accepts YYYY-MM-DD, optionally followed by T or a space, HH:MM[:SS[.fff]]
+ * and a Z or ±HH[:MM] offset; times without an offset are taken as UTC.
+ * @return false if text is not such a timestamp
+ */
+bool parseTimestamp(std::string_view text, int64_t& seconds);
+
+/**
+ * @brief Read the lessons_learned section of a structured memory file
+ *
+ * The file is either YAML in the block style js-yaml writes
+ * (structured_memory.yaml) or the same structure as JSON, told apart by its
+ * first significant character. Each problem maps to { solution,
+ * created_date, use_count }; problems without a solution and any other
+ * sections are skipped in a single pass, without building a document tree.
+ * @param path File to read
+ * @param categories Receives one entry per category with lessons
+ * @param error Receives a description when the file is unusable
+ * @return false if the file cannot be read or is malformed
+ */
+bool readMemoryFile(const std::string& path, std::vector<MemoryFileCategory>& categories,
+                    std::string* error = nullptr);
+
+} // namespace brains
+
+#endif // MEMORY_FILE_H
@@ -1,9 +1,84 @@
 #include <napi.h>
 #include "domain_engine.h"
 #include <memory>
+#include <functional>
 
 using namespace brains;
 
+/**
+ * Runs a service call on the libuv thread pool and resolves a Promise with
+ * its string result. The owning JS object is referenced until completion so
+ * the service outlives the work.
+ */
+class ServiceWorker : public Napi::AsyncWorker {
+public:
+    ServiceWorker(Napi::Env env, Napi::Object owner, std::function<std::string()> work)
+        : Napi::AsyncWorker(env, "BrainsMemoryEngineTask"),
+          deferred(Napi::Promise::Deferred::New(env)),
+          owner_ref(Napi::Persistent(owner)),
+          work(std::move(work)) {}
+    
+    Napi::Promise GetPromise() const { return deferred.Promise(); }
+    
+protected:
+    void Execute() override {
+        try {
+            result = work();
+        } catch (const std::exception& e) {
+            SetError(e.what());
+        }
+    }
+    
+    void OnOK() override {
+        deferred.Resolve(Napi::String::New(Env(), result));
+    }
+    
+    void OnError(const Napi::Error& error) override {
+        deferred.Reject(error.Value());
+    }
+    
+private:
+    Napi::Promise::Deferred deferred;
+    Napi::ObjectReference owner_ref;
+    std::function<std::string()> work;
+    std::string result;
+};
+
+/**
+ * Reads (problems[, categories]) for batch lookups. categories may be an
+ * array aligned with problems or one category applied to every problem.
+ * Throws a JS TypeError and returns false on invalid arguments.
+ */
+static bool ReadBatchArgs(const Napi::CallbackInfo& info,
+                          std::vector<std::string>& problems,
+                          std::vector<std::string>& categories) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsArray()) {
+        Napi::TypeError::New(env, "Expected array of problem descriptions").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    Napi::Array problem_array = info[0].As<Napi::Array>();
+    problems.reserve(problem_array.Length());
+    for (uint32_t i = 0; i < problem_array.Length(); i++) {
+        problems.push_back(problem_array.Get(i).ToString().Utf8Value());
+    }
+    
+    if (info.Length() > 1 && info[1].IsArray()) {
+        Napi::Array category_array = info[1].As<Napi::Array>();
+        categories.reserve(category_array.Length());
+        for (uint32_t i = 0; i < category_array.Length(); i++) {
+            Napi::Value category = category_array.Get(i);
+            categories.push_back(category.IsString() ? category.As<Napi::String>().Utf8Value() : "");
+        }
+    } else if (info.Length() > 1 && info[1].IsString()) {
+        categories.assign(problems.size(), info[1].As<Napi::String>().Utf8Value());
+    }
+    
+    return true;
+}
+
 class MemoryEngineWrapper : public Napi::ObjectWrap<MemoryEngineWrapper> {
 public:
     static Napi::Object Init(Napi::Env env, Napi::Object exports);
@@ -24,6 +99,15 @@ private:
     // Compatibility with existing JS interface
     Napi::Value CategorizeError(const Napi::CallbackInfo& info);
     Napi::Value FindSolution(const Napi::CallbackInfo& info);
+    Napi::Value FindSolutions(const Napi::CallbackInfo& info);
+    
+    // Promise-returning variants that run on the libuv thread pool
+    Napi::Value CreateMemoryEntryAsync(const Napi::CallbackInfo& info);
+    Napi::Value SearchMemoriesAsync(const Napi::CallbackInfo& info);
+    Napi::Value FindSolutionAsync(const Napi::CallbackInfo& info);
+    Napi::Value FindSolutionsAsync(const Napi::CallbackInfo& info);
+    
+    Napi::Value QueueServiceWork(const Napi::CallbackInfo& info, std::function<std::string()> work);
 };
 
 Napi::FunctionReference MemoryEngineWrapper::constructor;
@@ -39,7 +123,12 @@ Napi::Object MemoryEngineWrapper::Init(Napi::Env env, Napi::Object exports) {
         InstanceMethod("getMemoryEntry", &MemoryEngineWrapper::GetMemoryEntry),
         InstanceMethod("getStatistics", &MemoryEngineWrapper::GetStatistics),
         InstanceMethod("categorizeError", &MemoryEngineWrapper::CategorizeError),
-        InstanceMethod("findSolution", &MemoryEngineWrapper::FindSolution)
+        InstanceMethod("findSolution", &MemoryEngineWrapper::FindSolution),
+        InstanceMethod("findSolutions", &MemoryEngineWrapper::FindSolutions),
+        InstanceMethod("createMemoryEntryAsync", &MemoryEngineWrapper::CreateMemoryEntryAsync),
+        InstanceMethod("searchMemoriesAsync", &MemoryEngineWrapper::SearchMemoriesAsync),
+        InstanceMethod("findSolutionAsync", &MemoryEngineWrapper::FindSolutionAsync),
+        InstanceMethod("findSolutionsAsync", &MemoryEngineWrapper::FindSolutionsAsync)
     });
     
     constructor = Napi::Persistent(func);
@@ -62,32 +151,48 @@ Napi::Value MemoryEngineWrapper::Initialize(const Napi::CallbackInfo& info) {
         return env.Null();
     }
     
+    // Property order is the category match order; values are pattern arrays,
+    // single patterns, or { patterns: [...], priority: n } objects
     Napi::Object categories = info[0].As<Napi::Object>();
-    std::unordered_map<std::string, std::vector<std::string>> category_map;
+    std::vector<CategoryDefinition> category_table;
     
-    Napi::Array category_names = categories.GetPropertyNames();
-    for (uint32_t i = 0; i < category_names.Length(); i++) {
-        Napi::String category = category_names.Get(i).As<Napi::String>();
-        std::string category_str = category.Utf8Value();
-        
-        Napi::Value patterns_value = categories.Get(category);
-        if (patterns_value.IsArray()) {
-            Napi::Array patterns = patterns_value.As<Napi::Array>();
-            std::vector<std::string> pattern_list;
-            
+    auto append_patterns = [](Napi::Value value, std::vector<std::string>& pattern_list) {
+        if (value.IsArray()) {
+            Napi::Array patterns = value.As<Napi::Array>();
             for (uint32_t j = 0; j < patterns.Length(); j++) {
                 Napi::Value pattern = patterns.Get(j);
                 if (pattern.IsString()) {
                     pattern_list.push_back(pattern.As<Napi::String>().Utf8Value());
                 }
             }
-            category_map[category_str] = pattern_list;
-        } else if (patterns_value.IsString()) {
-            category_map[category_str] = {patterns_value.As<Napi::String>().Utf8Value()};
+        } else if (value.IsString()) {
+            pattern_list.push_back(value.As<Napi::String>().Utf8Value());
         }
+    };
+    
+    Napi::Array category_names = categories.GetPropertyNames();
+    for (uint32_t i = 0; i < category_names.Length(); i++) {
+        Napi::String category = category_names.Get(i).As<Napi::String>();
+        
+        CategoryDefinition definition;
+        definition.name = category.Utf8Value();
+        
+        Napi::Value patterns_value = categories.Get(category);
+        if (patterns_value.IsObject() && !patterns_value.IsArray()) {
+            Napi::Object definition_obj = patterns_value.As<Napi::Object>();
+            append_patterns(definition_obj.Get("patterns"), definition.patterns);
+            Napi::Value priority = definition_obj.Get("priority");
+            if (priority.IsNumber()) {
+                definition.priority = priority.As<Napi::Number>().Int32Value();
+            }
+        } else {
+            append_patterns(patterns_value, definition.patterns);
+        }
+        
+        category_table.push_back(std::move(definition));
     }
     
-    bool success = service->initialize(category_map);
+    bool success = service->initialize(category_table);
     return Napi::Boolean::New(env, success);
 }
 
@@ -174,7 +279,7 @@ Napi::Value MemoryEngineWrapper::CategorizeError(const Napi::CallbackInfo& info)
     // Use a temporary basic engine for categorization
     // In production, this would be integrated with the domain engine
     DomainMemoryEngine temp_engine;
-    std::unordered_map<std::string, std::vector<std::string>> default_categories = {
+    std::vector<CategoryDefinition> default_categories = {
         {"authentication", {"(intent|callback).*oauth|auth.*fail|token.*invalid"}},
         {"networking", {"http.*timeout|connection.*refused|network.*error"}},
         {"database", {"(db|database).*(fail|connection)|sql.*error"}},
@@ -204,6 +309,91 @@ Napi::Value MemoryEngineWrapper::FindSolution(const Napi::CallbackInfo& info) {
     return Napi::String::New(env, results);
 }
 
+Napi::Value MemoryEngineWrapper::FindSolutions(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    std::vector<std::string> problems;
+    std::vector<std::string> categories;
+    if (!ReadBatchArgs(info, problems, categories)) {
+        return env.Null();
+    }
+    
+    std::string results = service->searchMemoriesBatch(problems, categories, 1);
+    return Napi::String::New(env, results);
+}
+
+// Async variants
+Napi::Value MemoryEngineWrapper::QueueServiceWork(const Napi::CallbackInfo& info,
+                                                  std::function<std::string()> work) {
+    auto* worker = new ServiceWorker(info.Env(), info.This().As<Napi::Object>(), std::move(work));
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue(); // Deleted by node-addon-api once settled
+    return promise;
+}
+
+Napi::Value MemoryEngineWrapper::CreateMemoryEntryAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 3) {
+        Napi::TypeError::New(env, "Expected 3 arguments: problem, solution, category").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string problem = info[0].As<Napi::String>().Utf8Value();
+    std::string solution = info[1].As<Napi::String>().Utf8Value();
+    std::string category = info[2].As<Napi::String>().Utf8Value();
+    MemoryApplicationService* svc = service.get();
+    
+    return QueueServiceWork(info, [=] { return svc->createMemoryEntry(problem, solution, category); });
+}
+
+Napi::Value MemoryEngineWrapper::SearchMemoriesAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "Expected at least 1 argument: query").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string query = info[0].As<Napi::String>().Utf8Value();
+    std::string category = (info.Length() > 1 && info[1].IsString()) ? 
+                          info[1].As<Napi::String>().Utf8Value() : "";
+    int max_results = (info.Length() > 2 && info[2].IsNumber()) ? 
+                     info[2].As<Napi::Number>().Int32Value() : 10;
+    MemoryApplicationService* svc = service.get();
+    
+    return QueueServiceWork(info, [=] { return svc->searchMemories(query, category, max_results); });
+}
+
+Napi::Value MemoryEngineWrapper::FindSolutionAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "Expected problem description").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string problem = info[0].As<Napi::String>().Utf8Value();
+    std::string category = (info.Length() > 1 && info[1].IsString()) ? 
+                          info[1].As<Napi::String>().Utf8Value() : "";
+    MemoryApplicationService* svc = service.get();
+    
+    return QueueServiceWork(info, [=] { return svc->searchMemories(problem, category, 1); });
+}
+
+Napi::Value MemoryEngineWrapper::FindSolutionsAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    std::vector<std::string> problems;
+    std::vector<std::string> categories;
+    if (!ReadBatchArgs(info, problems, categories)) {
+        return env.Null();
+    }
+    MemoryApplicationService* svc = service.get();
+    
+    return QueueServiceWork(info, [=] { return svc->searchMemoriesBatch(problems, categories, 1); });
+}
+
 // Module initialization
 Napi::Object InitAll(Napi::Env env, Napi::Object exports) {
     return MemoryEngineWrapper::Init(env, exports);
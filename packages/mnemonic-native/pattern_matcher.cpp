@@ -0,0 +1,941 @@
+#include "pattern_matcher.h"
+#include <algorithm>
+#include <stdexcept>
+#include <cctype>
+
+namespace brains {
+
+/**
+ * @brief Parsed regex syntax tree for the subset the automaton supports
+ */
+struct RegexNode {
+    enum Kind { EMPTY, BYTES, CONCAT, ALTERNATE, REPEAT, BEGIN, END };
+
+    Kind kind;
+    std::bitset<256> bytes;
+    std::vector<std::unique_ptr<RegexNode>> children;
+    int min_repeat = 0;
+    int max_repeat = -1; // -1 for unbounded
+
+    explicit RegexNode(Kind k) : kind(k) {}
+};
+
+namespace {
+
+constexpr int MAX_COUNTED_REPEAT = 64;
+
+/**
+ * @brief Thrown when a pattern uses syntax the automaton cannot express
+ */
+class UnsupportedPattern : public std::runtime_error {
+public:
+    explicit UnsupportedPattern(const std::string& what) : std::runtime_error(what) {}
+};
+
+std::bitset<256> foldCase(std::bitset<256> bytes) {
+    for (int c = 'a'; c <= 'z'; ++c) {
+        if (bytes.test(c) || bytes.test(c - 'a' + 'A')) {
+            bytes.set(c);
+            bytes.set(c - 'a' + 'A');
+        }
+    }
+    return bytes;
+}
+
+std::bitset<256> digitBytes() {
+    std::bitset<256> bytes;
+    for (int c = '0'; c <= '9'; ++c) bytes.set(c);
+    return bytes;
+}
+
+std::bitset<256> wordBytes() {
+    std::bitset<256> bytes = digitBytes();
+    for (int c = 'a'; c <= 'z'; ++c) bytes.set(c);
+    for (int c = 'A'; c <= 'Z'; ++c) bytes.set(c);
+    bytes.set('_');
+    return bytes;
+}
+
+std::bitset<256> spaceBytes() {
+    std::bitset<256> bytes;
+    for (char c : std::string(" \t\n\r\f\v")) bytes.set(static_cast<unsigned char>(c));
+    return bytes;
+}
+
+int firstByte(const std::bitset<256>& bytes) {
+    for (int b = 0; b < 256; ++b) {
+        if (bytes.test(b)) return b;
+    }
+    return -1;
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * @brief Recursive-descent parser for ECMAScript-style patterns
+ */
+class RegexParser {
+public:
+    explicit RegexParser(const std::string& source) : pattern(source) {}
+
+    std::unique_ptr<RegexNode> parse() {
+        auto node = parseAlternation();
+        if (pos != pattern.size()) {
+            throw UnsupportedPattern("unbalanced parenthesis");
+        }
+        return node;
+    }
+
+private:
+    const std::string& pattern;
+    size_t pos = 0;
+
+    bool atEnd() const { return pos >= pattern.size(); }
+    char peek() const { return pattern[pos]; }
+
+    std::unique_ptr<RegexNode> parseAlternation() {
+        auto first = parseConcat();
+        if (atEnd() || peek() != '|') {
+            return first;
+        }
+
+        auto node = std::make_unique<RegexNode>(RegexNode::ALTERNATE);
+        node->children.push_back(std::move(first));
+        while (!atEnd() && peek() == '|') {
+            ++pos;
+            node->children.push_back(parseConcat());
+        }
+        return node;
+    }
+
+    std::unique_ptr<RegexNode> parseConcat() {
+        auto node = std::make_unique<RegexNode>(RegexNode::CONCAT);
+        while (!atEnd() && peek() != '|' && peek() != ')') {
+            node->children.push_back(parseRepeat());
+        }
+        if (node->children.empty()) {
+            return std::make_unique<RegexNode>(RegexNode::EMPTY);
+        }
+        if (node->children.size() == 1) {
+            return std::move(node->children.front());
+        }
+        return node;
+    }
+
+    std::unique_ptr<RegexNode> parseRepeat() {
+        auto atom = parseAtom();
+
+        while (!atEnd()) {
+            int min_repeat;
+            int max_repeat;
+            char c = peek();
+            if (c == '*') {
+                min_repeat = 0; max_repeat = -1; ++pos;
+            } else if (c == '+') {
+                min_repeat = 1; max_repeat = -1; ++pos;
+            } else if (c == '?') {
+                min_repeat = 0; max_repeat = 1; ++pos;
+            } else if (c == '{') {
+                parseCount(min_repeat, max_repeat);
+            } else {
+                break;
+            }
+
+            // Lazy quantifiers only change which match is reported, not whether one exists
+            if (!atEnd() && peek() == '?') {
+                ++pos;
+            }
+            if (atom->kind == RegexNode::BEGIN || atom->kind == RegexNode::END) {
+                throw UnsupportedPattern("quantified assertion");
+            }
+
+            auto repeat = std::make_unique<RegexNode>(RegexNode::REPEAT);
+            repeat->min_repeat = min_repeat;
+            repeat->max_repeat = max_repeat;
+            repeat->children.push_back(std::move(atom));
+            atom = std::move(repeat);
+        }
+        return atom;
+    }
+
+    void parseCount(int& min_repeat, int& max_repeat) {
+        ++pos; // '{'
+        min_repeat = parseNumber();
+        max_repeat = min_repeat;
+        if (!atEnd() && peek() == ',') {
+            ++pos;
+            max_repeat = (!atEnd() && std::isdigit(static_cast<unsigned char>(peek()))) ? parseNumber() : -1;
+        }
+        if (atEnd() || peek() != '}') {
+            throw UnsupportedPattern("malformed repetition");
+        }
+        ++pos;
+        if (min_repeat > MAX_COUNTED_REPEAT || max_repeat > MAX_COUNTED_REPEAT ||
+            (max_repeat != -1 && max_repeat < min_repeat)) {
+            throw UnsupportedPattern("repetition bound too large");
+        }
+    }
+
+    int parseNumber() {
+        if (atEnd() || !std::isdigit(static_cast<unsigned char>(peek()))) {
+            throw UnsupportedPattern("expected number");
+        }
+        int value = 0;
+        while (!atEnd() && std::isdigit(static_cast<unsigned char>(peek()))) {
+            value = value * 10 + (peek() - '0');
+            if (value > MAX_COUNTED_REPEAT) {
+                throw UnsupportedPattern("repetition bound too large");
+            }
+            ++pos;
+        }
+        return value;
+    }
+
+    std::unique_ptr<RegexNode> makeBytes(const std::bitset<256>& bytes) {
+        auto node = std::make_unique<RegexNode>(RegexNode::BYTES);
+        node->bytes = bytes;
+        return node;
+    }
+
+    std::unique_ptr<RegexNode> parseAtom() {
+        char c = peek();
+        switch (c) {
+            case '(': {
+                ++pos;
+                if (!atEnd() && peek() == '?') {
+                    if (pos + 1 < pattern.size() && pattern[pos + 1] == ':') {
+                        pos += 2;
+                    } else {
+                        throw UnsupportedPattern("lookaround");
+                    }
+                }
+                auto inner = parseAlternation();
+                if (atEnd() || peek() != ')') {
+                    throw UnsupportedPattern("unbalanced parenthesis");
+                }
+                ++pos;
+                return inner;
+            }
+            case '[':
+                ++pos;
+                return makeBytes(parseClass());
+            case '.': {
+                ++pos;
+                std::bitset<256> bytes;
+                bytes.set();
+                bytes.reset('\n');
+                bytes.reset('\r');
+                return makeBytes(bytes);
+            }
+            case '^':
+                ++pos;
+                return std::make_unique<RegexNode>(RegexNode::BEGIN);
+            case '$':
+                ++pos;
+                return std::make_unique<RegexNode>(RegexNode::END);
+            case '\\': {
+                ++pos;
+                return makeBytes(foldCase(parseEscape(false)));
+            }
+            case '*':
+            case '+':
+            case '?':
+            case '{':
+                throw UnsupportedPattern("nothing to repeat");
+            default: {
+                ++pos;
+                std::bitset<256> bytes;
+                bytes.set(static_cast<unsigned char>(c));
+                return makeBytes(foldCase(bytes));
+            }
+        }
+    }
+
+    // Escapes yield their exact bytes; callers fold case once the atom or class is complete,
+    // so a hex letter stays a single byte that can bound a class range
+    std::bitset<256> parseEscape(bool in_class) {
+        if (atEnd()) {
+            throw UnsupportedPattern("trailing backslash");
+        }
+        char c = pattern[pos++];
+        std::bitset<256> bytes;
+        switch (c) {
+            case 'd': return digitBytes();
+            case 'D': return ~digitBytes();
+            case 'w': return wordBytes();
+            case 'W': return ~wordBytes();
+            case 's': return spaceBytes();
+            case 'S': return ~spaceBytes();
+            case 'n': bytes.set('\n'); return bytes;
+            case 'r': bytes.set('\r'); return bytes;
+            case 't': bytes.set('\t'); return bytes;
+            case 'f': bytes.set('\f'); return bytes;
+            case 'v': bytes.set('\v'); return bytes;
+            case '0': bytes.set(0); return bytes;
+            case 'x': {
+                if (pos + 1 >= pattern.size() || hexValue(pattern[pos]) < 0 || hexValue(pattern[pos + 1]) < 0) {
+                    throw UnsupportedPattern("malformed hex escape");
+                }
+                bytes.set(hexValue(pattern[pos]) * 16 + hexValue(pattern[pos + 1]));
+                pos += 2;
+                return bytes;
+            }
+            case 'b':
+                if (in_class) {
+                    bytes.set('\b');
+                    return bytes;
+                }
+                throw UnsupportedPattern("word boundary");
+            default:
+                if (std::isalnum(static_cast<unsigned char>(c))) {
+                    throw UnsupportedPattern("unsupported escape");
+                }
+                bytes.set(static_cast<unsigned char>(c));
+                return bytes;
+        }
+    }
+
+    std::bitset<256> parseClass() {
+        bool negated = false;
+        if (!atEnd() && peek() == '^') {
+            negated = true;
+            ++pos;
+        }
+
+        std::bitset<256> bytes;
+        while (!atEnd() && peek() != ']') {
+            int low;
+            if (peek() == '\\') {
+                ++pos;
+                std::bitset<256> escaped = parseEscape(true);
+                if (escaped.count() != 1) {
+                    bytes |= escaped; // Shorthand class such as \d
+                    continue;
+                }
+                low = firstByte(escaped);
+            } else {
+                low = static_cast<unsigned char>(pattern[pos++]);
+            }
+
+            int high = low;
+            if (pos + 1 < pattern.size() && peek() == '-' && pattern[pos + 1] != ']') {
+                ++pos;
+                if (peek() == '\\') {
+                    ++pos;
+                    std::bitset<256> escaped = parseEscape(true);
+                    if (escaped.count() != 1) {
+                        throw UnsupportedPattern("class range with shorthand");
+                    }
+                    high = firstByte(escaped);
+                } else {
+                    high = static_cast<unsigned char>(pattern[pos++]);
+                }
+                if (high < low) {
+                    throw UnsupportedPattern("reversed class range");
+                }
+            }
+            for (int b = low; b <= high; ++b) {
+                bytes.set(b);
+            }
+        }
+        if (atEnd()) {
+            throw UnsupportedPattern("unterminated class");
+        }
+        ++pos; // ']'
+
+        bytes = foldCase(bytes);
+        return negated ? ~bytes : bytes;
+    }
+};
+
+constexpr size_t MAX_REQUIRED_ALTERNATIVES = 16;
+
+/**
+ * @brief Literals of which at least one occurs in every match of a sub-pattern
+ */
+struct RequiredLiterals {
+    bool valid = false;
+    std::vector<std::string> alternatives;
+
+    size_t shortest() const {
+        size_t length = alternatives.empty() ? 0 : alternatives.front().size();
+        for (const auto& literal : alternatives) {
+            length = std::min(length, literal.size());
+        }
+        return length;
+    }
+
+    bool betterThan(const RequiredLiterals& other) const {
+        if (!valid) return false;
+        if (!other.valid) return true;
+        if (shortest() != other.shortest()) return shortest() > other.shortest();
+        return alternatives.size() < other.alternatives.size();
+    }
+};
+
+// Returns the lowercase character a byte set matches, ignoring case, or -1
+int singleFoldedChar(const std::bitset<256>& bytes) {
+    size_t count = bytes.count();
+    if (count == 0 || count > 2) return -1;
+    int first = firstByte(bytes);
+    int lower = std::tolower(first);
+    if (count == 1) return std::isalpha(first) ? -1 : first;
+    return (std::isalpha(first) && bytes.test(lower) && bytes.test(std::toupper(first))) ? lower : -1;
+}
+
+RequiredLiterals requiredLiterals(const RegexNode& node) {
+    RequiredLiterals result;
+    switch (node.kind) {
+        case RegexNode::BYTES: {
+            int c = singleFoldedChar(node.bytes);
+            if (c >= 0) {
+                result.valid = true;
+                result.alternatives.emplace_back(1, static_cast<char>(c));
+            }
+            return result;
+        }
+        case RegexNode::CONCAT: {
+            // Adjacent single characters form one longer literal run
+            std::string run;
+            auto flush = [&]() {
+                if (run.empty()) return;
+                RequiredLiterals candidate;
+                candidate.valid = true;
+                candidate.alternatives.push_back(run);
+                if (candidate.betterThan(result)) result = std::move(candidate);
+                run.clear();
+            };
+            for (const auto& child : node.children) {
+                int c = child->kind == RegexNode::BYTES ? singleFoldedChar(child->bytes) : -1;
+                if (c >= 0) {
+                    run.push_back(static_cast<char>(c));
+                    continue;
+                }
+                flush();
+                RequiredLiterals candidate = requiredLiterals(*child);
+                if (candidate.betterThan(result)) result = std::move(candidate);
+            }
+            flush();
+            return result;
+        }
+        case RegexNode::ALTERNATE: {
+            for (const auto& child : node.children) {
+                RequiredLiterals branch = requiredLiterals(*child);
+                if (!branch.valid) return RequiredLiterals();
+                for (auto& literal : branch.alternatives) {
+                    if (std::find(result.alternatives.begin(), result.alternatives.end(), literal) ==
+                        result.alternatives.end()) {
+                        result.alternatives.push_back(std::move(literal));
+                    }
+                }
+            }
+            if (result.alternatives.size() > MAX_REQUIRED_ALTERNATIVES) return RequiredLiterals();
+            result.valid = true;
+            return result;
+        }
+        case RegexNode::REPEAT:
+            return node.min_repeat > 0 ? requiredLiterals(*node.children.front()) : result;
+        default:
+            return result;
+    }
+}
+
+int minCategory(int a, int b) {
+    if (a == MultiPatternMatcher::NO_MATCH) return b;
+    if (b == MultiPatternMatcher::NO_MATCH) return a;
+    return std::min(a, b);
+}
+
+} // anonymous namespace
+
+// LiteralPrefilter Implementation
+int LiteralPrefilter::addLiteral(const std::string& literal) {
+    std::string folded = literal;
+    std::transform(folded.begin(), folded.end(), folded.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    auto it = literal_ids.find(folded);
+    if (it != literal_ids.end()) {
+        return it->second;
+    }
+    literals.push_back(folded);
+    int id = static_cast<int>(literals.size()) - 1;
+    literal_ids.emplace(std::move(folded), id);
+    return id;
+}
+
+void LiteralPrefilter::compile() {
+    transitions.clear();
+    outputs.clear();
+    num_classes = 0;
+    if (literals.empty()) {
+        return;
+    }
+
+    // Class 0 holds every byte that appears in no literal
+    std::fill(std::begin(byte_classes), std::end(byte_classes), 0);
+    num_classes = 1;
+    for (const auto& literal : literals) {
+        for (unsigned char c : literal) {
+            if (byte_classes[c] == 0) {
+                byte_classes[c] = static_cast<uint8_t>(num_classes++);
+            }
+        }
+    }
+    for (int c = 'A'; c <= 'Z'; ++c) {
+        byte_classes[c] = byte_classes[std::tolower(c)];
+    }
+
+    // Trie
+    std::vector<std::vector<int32_t>> trie(1, std::vector<int32_t>(num_classes, -1));
+    outputs.assign(1, {});
+    for (size_t id = 0; id < literals.size(); ++id) {
+        int state = 0;
+        for (unsigned char c : literals[id]) {
+            int& next = trie[state][byte_classes[c]];
+            if (next < 0) {
+                next = static_cast<int>(trie.size());
+                trie.emplace_back(num_classes, -1);
+                outputs.emplace_back();
+            }
+            state = next;
+        }
+        outputs[state].push_back(static_cast<int>(id));
+    }
+
+    // Breadth-first failure links, folded into a complete transition table
+    std::vector<int> failure(trie.size(), 0);
+    std::vector<int> queue;
+    for (int cls = 0; cls < num_classes; ++cls) {
+        int& next = trie[0][cls];
+        if (next < 0) {
+            next = 0;
+        } else {
+            queue.push_back(next);
+        }
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int state = queue[head];
+        const auto& inherited = outputs[failure[state]];
+        outputs[state].insert(outputs[state].end(), inherited.begin(), inherited.end());
+
+        for (int cls = 0; cls < num_classes; ++cls) {
+            int& next = trie[state][cls];
+            if (next < 0) {
+                next = trie[failure[state]][cls];
+            } else {
+                failure[next] = trie[failure[state]][cls];
+                queue.push_back(next);
+            }
+        }
+    }
+
+    transitions.reserve(trie.size() * num_classes);
+    for (const auto& row : trie) {
+        transitions.insert(transitions.end(), row.begin(), row.end());
+    }
+}
+
+// MultiPatternMatcher Implementation
+MultiPatternMatcher::MultiPatternMatcher() = default;
+
+MultiPatternMatcher::~MultiPatternMatcher() = default;
+
+bool MultiPatternMatcher::addPattern(const std::string& pattern, int category_id) {
+    try {
+        auto root = RegexParser(pattern).parse();
+        Fragment fragment = buildFragment(*root, category_id);
+        int match_state = addState(NfaState::MATCH, category_id);
+        patch(fragment.holes, match_state);
+        pattern_starts.push_back(fragment.start);
+        automaton_patterns++;
+
+        RequiredLiterals required = requiredLiterals(*root);
+        if (!required.valid) {
+            always_candidate_min = minCategory(always_candidate_min, category_id);
+        } else {
+            for (const auto& literal : required.alternatives) {
+                size_t literal_id = static_cast<size_t>(prefilter.addLiteral(literal));
+                if (literal_id >= literal_min_category.size()) {
+                    literal_min_category.resize(literal_id + 1, NO_MATCH);
+                }
+                literal_min_category[literal_id] = minCategory(literal_min_category[literal_id], category_id);
+            }
+        }
+        return true;
+    } catch (const UnsupportedPattern&) {
+        // Fall through to std::regex, which also validates the pattern
+    }
+
+    try {
+        fallback_patterns.emplace_back(category_id, std::regex(pattern, std::regex::icase));
+        return true;
+    } catch (const std::regex_error&) {
+        return false;
+    }
+}
+
+int MultiPatternMatcher::addState(NfaState::Type type, int category) {
+    NfaState state;
+    state.type = type;
+    state.category = category;
+    nfa.push_back(state);
+    return static_cast<int>(nfa.size()) - 1;
+}
+
+int MultiPatternMatcher::addByteSet(const std::bitset<256>& bytes) {
+    auto it = byte_set_ids.find(bytes);
+    if (it != byte_set_ids.end()) {
+        return it->second;
+    }
+    byte_sets.push_back(bytes);
+    int id = static_cast<int>(byte_sets.size()) - 1;
+    byte_set_ids.emplace(bytes, id);
+    return id;
+}
+
+void MultiPatternMatcher::patch(const std::vector<std::pair<int, int>>& holes, int target) {
+    for (const auto& [state, slot] : holes) {
+        if (slot == 0) {
+            nfa[state].out = target;
+        } else {
+            nfa[state].out1 = target;
+        }
+    }
+}
+
+MultiPatternMatcher::Fragment MultiPatternMatcher::buildFragment(const RegexNode& node, int category) {
+    switch (node.kind) {
+        case RegexNode::EMPTY: {
+            int s = addState(NfaState::EPSILON, category);
+            return {s, {{s, 0}}};
+        }
+        case RegexNode::BYTES: {
+            int s = addState(NfaState::BYTE, category);
+            nfa[s].byte_set = addByteSet(node.bytes);
+            return {s, {{s, 0}}};
+        }
+        case RegexNode::BEGIN: {
+            int s = addState(NfaState::ASSERT_BEGIN, category);
+            return {s, {{s, 0}}};
+        }
+        case RegexNode::END: {
+            int s = addState(NfaState::ASSERT_END, category);
+            return {s, {{s, 0}}};
+        }
+        case RegexNode::CONCAT: {
+            Fragment result = buildFragment(*node.children.front(), category);
+            for (size_t i = 1; i < node.children.size(); ++i) {
+                Fragment next = buildFragment(*node.children[i], category);
+                patch(result.holes, next.start);
+                result.holes = std::move(next.holes);
+            }
+            return result;
+        }
+        case RegexNode::ALTERNATE: {
+            Fragment result = buildFragment(*node.children.back(), category);
+            for (size_t i = node.children.size() - 1; i-- > 0;) {
+                Fragment branch = buildFragment(*node.children[i], category);
+                int split = addState(NfaState::SPLIT, category);
+                nfa[split].out = branch.start;
+                nfa[split].out1 = result.start;
+                branch.holes.insert(branch.holes.end(), result.holes.begin(), result.holes.end());
+                result = {split, std::move(branch.holes)};
+            }
+            return result;
+        }
+        case RegexNode::REPEAT: {
+            const RegexNode& child = *node.children.front();
+            Fragment result{-1, {}};
+            auto append = [&](Fragment next) {
+                if (result.start < 0) {
+                    result = std::move(next);
+                } else {
+                    patch(result.holes, next.start);
+                    result.holes = std::move(next.holes);
+                }
+            };
+
+            // Mandatory copies
+            for (int i = 0; i < node.min_repeat; ++i) {
+                append(buildFragment(child, category));
+            }
+
+            if (node.max_repeat == -1) {
+                // Kleene loop for the unbounded tail
+                Fragment body = buildFragment(child, category);
+                int split = addState(NfaState::SPLIT, category);
+                nfa[split].out = body.start;
+                patch(body.holes, split);
+                append({split, {{split, 1}}});
+            } else {
+                // Optional copies for the bounded tail
+                for (int i = node.min_repeat; i < node.max_repeat; ++i) {
+                    Fragment body = buildFragment(child, category);
+                    int split = addState(NfaState::SPLIT, category);
+                    nfa[split].out = body.start;
+                    body.holes.emplace_back(split, 1);
+                    append({split, std::move(body.holes)});
+                }
+            }
+
+            if (result.start < 0) {
+                int s = addState(NfaState::EPSILON, category);
+                result = {s, {{s, 0}}};
+            }
+            return result;
+        }
+    }
+    throw UnsupportedPattern("unknown node");
+}
+
+void MultiPatternMatcher::computeByteClasses() {
+    // Bytes that every byte set treats identically share a class
+    std::map<std::vector<bool>, uint8_t> signatures;
+    class_representatives.clear();
+
+    for (int b = 0; b < 256; ++b) {
+        std::vector<bool> signature(byte_sets.size());
+        for (size_t i = 0; i < byte_sets.size(); ++i) {
+            signature[i] = byte_sets[i].test(b);
+        }
+        auto [it, inserted] = signatures.emplace(std::move(signature),
+                                                 static_cast<uint8_t>(class_representatives.size()));
+        if (inserted) {
+            class_representatives.push_back(static_cast<uint8_t>(b));
+        }
+        byte_classes[b] = it->second;
+    }
+    num_classes = static_cast<int>(class_representatives.size());
+}
+
+void MultiPatternMatcher::compile() {
+    std::stable_sort(fallback_patterns.begin(), fallback_patterns.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    prefilter.compile();
+
+    if (pattern_starts.empty()) {
+        return;
+    }
+
+    computeByteClasses();
+
+    dfa_states = std::make_unique<DfaState[]>(MAX_DFA_STATES);
+    dfa_transitions = std::make_unique<std::atomic<int32_t>[]>(
+        static_cast<size_t>(MAX_DFA_STATES) * num_classes);
+    for (size_t i = 0; i < static_cast<size_t>(MAX_DFA_STATES) * num_classes; ++i) {
+        dfa_transitions[i].store(UNKNOWN_STATE, std::memory_order_relaxed);
+    }
+    dfa_cache.clear();
+    dfa_state_count.store(0, std::memory_order_relaxed);
+
+    // State 0 is the start state, the only one where '^' can match
+    std::vector<int> start_set;
+    int start_match = NO_MATCH;
+    closure(pattern_starts, true, false, NO_MATCH, start_set, start_match);
+
+    std::lock_guard<std::mutex> lock(build_mutex);
+    addDfaState(std::move(start_set), start_match);
+}
+
+void MultiPatternMatcher::closure(const std::vector<int>& roots, bool at_begin, bool at_end, int best,
+                                  std::vector<int>& out_set, int& out_match) const {
+    std::vector<char> visited(nfa.size(), 0);
+    std::vector<int> stack(roots.begin(), roots.end());
+    out_set.clear();
+    out_match = NO_MATCH;
+
+    while (!stack.empty()) {
+        int id = stack.back();
+        stack.pop_back();
+        if (id < 0 || visited[id]) continue;
+        visited[id] = 1;
+
+        const NfaState& state = nfa[id];
+        // Categories that can no longer beat the current best are pruned
+        if (best != NO_MATCH && state.category >= best) continue;
+
+        switch (state.type) {
+            case NfaState::BYTE:
+                out_set.push_back(id);
+                break;
+            case NfaState::SPLIT:
+                stack.push_back(state.out1);
+                stack.push_back(state.out);
+                break;
+            case NfaState::EPSILON:
+                stack.push_back(state.out);
+                break;
+            case NfaState::MATCH:
+                out_match = minCategory(out_match, state.category);
+                break;
+            case NfaState::ASSERT_BEGIN:
+                if (at_begin) stack.push_back(state.out);
+                break;
+            case NfaState::ASSERT_END:
+                if (at_end) {
+                    stack.push_back(state.out);
+                } else {
+                    out_set.push_back(id);
+                }
+                break;
+        }
+    }
+
+    std::sort(out_set.begin(), out_set.end());
+}
+
+void MultiPatternMatcher::step(const std::vector<int>& set, int best, uint8_t byte,
+                               std::vector<int>& next_set, int& next_best) const {
+    // Re-seed every pattern start so matches may begin at any offset
+    std::vector<int> roots(pattern_starts.begin(), pattern_starts.end());
+    for (int id : set) {
+        const NfaState& state = nfa[id];
+        if (state.type == NfaState::BYTE && byte_sets[state.byte_set].test(byte)) {
+            roots.push_back(state.out);
+        }
+    }
+
+    int matched = NO_MATCH;
+    closure(roots, false, false, best, next_set, matched);
+    next_best = minCategory(best, matched);
+
+    if (next_best != best) {
+        next_set.erase(std::remove_if(next_set.begin(), next_set.end(),
+                                      [&](int id) { return nfa[id].category >= next_best; }),
+                       next_set.end());
+    }
+}
+
+int MultiPatternMatcher::acceptAtEnd(const std::vector<int>& set, int best) const {
+    std::vector<int> roots;
+    for (int id : set) {
+        if (nfa[id].type == NfaState::ASSERT_END) {
+            roots.push_back(nfa[id].out);
+        }
+    }
+    if (roots.empty()) {
+        return NO_MATCH;
+    }
+
+    std::vector<int> unused;
+    int matched = NO_MATCH;
+    closure(roots, false, true, best, unused, matched);
+    return matched;
+}
+
+int MultiPatternMatcher::addDfaState(std::vector<int> set, int best) const {
+    auto key = std::make_pair(best, set);
+    auto it = dfa_cache.find(key);
+    if (it != dfa_cache.end()) {
+        return it->second;
+    }
+
+    int id = dfa_state_count.load(std::memory_order_relaxed);
+    if (id >= MAX_DFA_STATES) {
+        return UNKNOWN_STATE;
+    }
+
+    DfaState& state = dfa_states[id];
+    state.accept_at_end = acceptAtEnd(set, best);
+    state.best = best;
+    state.terminal = (best == 0) || set.empty();
+    state.nfa_states = std::move(set);
+
+    dfa_cache.emplace(std::move(key), id);
+    dfa_state_count.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+int MultiPatternMatcher::buildTransition(int state, int byte_class) const {
+    std::lock_guard<std::mutex> lock(build_mutex);
+
+    auto& slot = dfa_transitions[static_cast<size_t>(state) * num_classes + byte_class];
+    int32_t existing = slot.load(std::memory_order_relaxed);
+    if (existing != UNKNOWN_STATE) {
+        return existing;
+    }
+
+    std::vector<int> next_set;
+    int next_best = NO_MATCH;
+    step(dfa_states[state].nfa_states, dfa_states[state].best,
+         class_representatives[byte_class], next_set, next_best);
+
+    int next = addDfaState(std::move(next_set), next_best);
+    if (next != UNKNOWN_STATE) {
+        slot.store(next, std::memory_order_release);
+    }
+    return next;
+}
+
+int MultiPatternMatcher::runAutomaton(const std::string& text, int floor) const {
+    int current = 0;
+    const DfaState* state = &dfa_states[0];
+
+    for (size_t i = 0; i < text.size(); ++i) {
+        // Stop once no better candidate remains according to the prefilter
+        if (state->terminal || (state->best != NO_MATCH && state->best <= floor)) {
+            return state->best;
+        }
+
+        int byte_class = byte_classes[static_cast<unsigned char>(text[i])];
+        int next = dfa_transitions[static_cast<size_t>(current) * num_classes + byte_class]
+                       .load(std::memory_order_acquire);
+        if (next == UNKNOWN_STATE) {
+            next = buildTransition(current, byte_class);
+            if (next == UNKNOWN_STATE) {
+                // DFA cache is full; finish this message on the NFA directly
+                return simulate(text, i, state->nfa_states, state->best);
+            }
+        }
+
+        current = next;
+        state = &dfa_states[current];
+    }
+
+    return minCategory(state->best, state->accept_at_end);
+}
+
+int MultiPatternMatcher::simulate(const std::string& text, size_t pos, std::vector<int> set, int best) const {
+    std::vector<int> next_set;
+    for (; pos < text.size(); ++pos) {
+        if (best == 0 || set.empty()) {
+            return best;
+        }
+        step(set, best, static_cast<uint8_t>(text[pos]), next_set, best);
+        set.swap(next_set);
+    }
+    return minCategory(best, acceptAtEnd(set, best));
+}
+
+int MultiPatternMatcher::match(const std::string& text) const {
+    int candidate = always_candidate_min;
+    if (candidate != 0) {
+        prefilter.scan(text, [&](int literal_id) {
+            candidate = minCategory(candidate, literal_min_category[literal_id]);
+        });
+    }
+
+    int result = NO_MATCH;
+    if (candidate != NO_MATCH) {
+        result = runAutomaton(text, candidate);
+    }
+
+    for (const auto& [category, regex_pattern] : fallback_patterns) {
+        if (result != NO_MATCH && category >= result) {
+            break;
+        }
+        if (std::regex_search(text, regex_pattern)) {
+            return category;
+        }
+    }
+
+    return result;
+}
+
+} // namespace brains
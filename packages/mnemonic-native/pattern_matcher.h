@@ -0,0 +1,184 @@
+#ifndef PATTERN_MATCHER_H
+#define PATTERN_MATCHER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <regex>
+#include <bitset>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+namespace brains {
+
+struct RegexNode;
+
+/**
+ * @brief Case-insensitive Aho-Corasick scanner over a fixed set of literals
+ *
+ * The goto and failure functions are folded into one dense transition table
+ * over byte classes, so a scan costs one table lookup per input byte.
+ */
+class LiteralPrefilter {
+public:
+    /**
+     * @brief Register a literal (matched case-insensitively)
+     * @return Literal id; duplicate literals share an id
+     */
+    int addLiteral(const std::string& literal);
+
+    /**
+     * @brief Build the automaton; must be called after the last addLiteral
+     */
+    void compile();
+
+    /**
+     * @brief Report every literal occurring in text
+     * @param text Text to scan
+     * @param on_match Callback invoked with the id of each literal occurrence
+     */
+    template<typename Callback>
+    void scan(const std::string& text, Callback&& on_match) const {
+        if (num_classes == 0) return;
+        int state = 0;
+        for (unsigned char c : text) {
+            state = transitions[static_cast<size_t>(state) * num_classes + byte_classes[c]];
+            for (int literal_id : outputs[state]) {
+                on_match(literal_id);
+            }
+        }
+    }
+
+    size_t getLiteralCount() const { return literals.size(); }
+
+private:
+    std::vector<std::string> literals;
+    std::unordered_map<std::string, int> literal_ids;
+    uint8_t byte_classes[256] = {};
+    int num_classes = 0;
+    std::vector<int32_t> transitions;
+    std::vector<std::vector<int>> outputs;
+};
+
+/**
+ * @brief Multi-pattern matcher that merges every category pattern into one automaton
+ *
+ * Patterns are compiled into a single Thompson NFA whose accepting states carry
+ * their category id. Matching walks a DFA that is built lazily from that NFA over
+ * byte equivalence classes, so a message is categorised in one linear pass no
+ * matter how many patterns are loaded. When several categories match, the lowest
+ * category id wins. Patterns outside the supported regex subset (backreferences,
+ * lookaround, word boundaries) are kept as std::regex fallbacks.
+ *
+ * Each pattern also contributes the literals that any match must contain. A
+ * LiteralPrefilter scan finds which of them occur, so messages that cannot match
+ * any category are rejected without running the automaton or the fallbacks.
+ */
+class MultiPatternMatcher {
+public:
+    static constexpr int NO_MATCH = -1;
+
+    MultiPatternMatcher();
+    ~MultiPatternMatcher();
+
+    /**
+     * @brief Add a case-insensitive pattern for a category
+     * @param pattern ECMAScript-style regex pattern
+     * @param category_id Category identifier (lower ids take precedence)
+     * @return false if the pattern is invalid and was skipped
+     */
+    bool addPattern(const std::string& pattern, int category_id);
+
+    /**
+     * @brief Build the automaton; must be called after the last addPattern
+     */
+    void compile();
+
+    /**
+     * @brief Find the lowest category id with a pattern matching anywhere in text
+     * @param text Message to scan
+     * @return Category id or NO_MATCH
+     */
+    int match(const std::string& text) const;
+
+    size_t getAutomatonPatternCount() const { return automaton_patterns; }
+    size_t getFallbackPatternCount() const { return fallback_patterns.size(); }
+    size_t getDfaStateCount() const { return dfa_state_count.load(std::memory_order_relaxed); }
+    size_t getPrefilterLiteralCount() const { return prefilter.getLiteralCount(); }
+
+private:
+    struct NfaState {
+        enum Type : uint8_t { BYTE, SPLIT, EPSILON, MATCH, ASSERT_BEGIN, ASSERT_END };
+        Type type;
+        int out = -1;
+        int out1 = -1;
+        int byte_set = -1;
+        int category = NO_MATCH;
+    };
+
+    struct DfaState {
+        std::vector<int> nfa_states;  // Sorted BYTE/ASSERT_END states still alive
+        int best = NO_MATCH;          // Lowest category matched so far
+        int accept_at_end = NO_MATCH; // Lowest category matched if input ends here
+        bool terminal = false;        // No lower category can match any more
+    };
+
+    static constexpr int MAX_DFA_STATES = 4096;
+    static constexpr int32_t UNKNOWN_STATE = -1;
+
+    // NFA shared by all automaton patterns
+    std::vector<NfaState> nfa;
+    std::vector<std::bitset<256>> byte_sets;
+    std::unordered_map<std::bitset<256>, int> byte_set_ids;
+    std::vector<int> pattern_starts;
+    size_t automaton_patterns = 0;
+
+    // Byte equivalence classes
+    uint8_t byte_classes[256] = {};
+    std::vector<uint8_t> class_representatives;
+    int num_classes = 0;
+
+    // Lazily built DFA; transitions are published with release semantics so
+    // readers never take build_mutex once a path has been explored
+    mutable std::unique_ptr<DfaState[]> dfa_states;
+    mutable std::unique_ptr<std::atomic<int32_t>[]> dfa_transitions;
+    mutable std::atomic<int> dfa_state_count{0};
+    mutable std::map<std::pair<int, std::vector<int>>, int> dfa_cache;
+    mutable std::mutex build_mutex;
+
+    // Patterns the automaton cannot express, ordered by category id
+    std::vector<std::pair<int, std::regex>> fallback_patterns;
+
+    // Required-literal prefilter: a category is a candidate only if one of its
+    // patterns has no required literals or one of them occurs in the message
+    LiteralPrefilter prefilter;
+    std::vector<int> literal_min_category; // Indexed by literal id
+    int always_candidate_min = NO_MATCH;
+
+    struct Fragment {
+        int start;
+        std::vector<std::pair<int, int>> holes; // (state, out slot) left dangling
+    };
+
+    int addState(NfaState::Type type, int category);
+    int addByteSet(const std::bitset<256>& bytes);
+    void patch(const std::vector<std::pair<int, int>>& holes, int target);
+    Fragment buildFragment(const RegexNode& node, int category);
+    void computeByteClasses();
+    void closure(const std::vector<int>& roots, bool at_begin, bool at_end, int best,
+                 std::vector<int>& out_set, int& out_match) const;
+    void step(const std::vector<int>& set, int best, uint8_t byte,
+              std::vector<int>& next_set, int& next_best) const;
+    int acceptAtEnd(const std::vector<int>& set, int best) const;
+    int addDfaState(std::vector<int> set, int best) const;
+    int buildTransition(int state, int byte_class) const;
+    int runAutomaton(const std::string& text, int floor) const;
+    int simulate(const std::string& text, size_t pos, std::vector<int> set, int best) const;
+};
+
+} // namespace brains
+
+#endif // PATTERN_MATCHER_H
@@ -0,0 +1,121 @@
+#ifndef PROBLEM_TABLE_H
+#define PROBLEM_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace brains {
+
+/**
+ * @brief Hash used to place problems in shards and table slots
+ */
+inline uint64_t problemHash(std::string_view problem) {
+    return std::hash<std::string_view>{}(problem);
+}
+
+/**
+ * @brief Insert-only open-addressing table of problem entries
+ *
+ * Each slot holds the entry's precomputed hash next to the entry pointer,
+ * so a probe compares hashes in one contiguous array and touches the entry
+ * only to confirm a hash match. Slots are linearly probed and never move,
+ * which lets a single writer insert in place while readers probe without
+ * locking: a slot becomes visible when its entry pointer is published, and
+ * a reader stops at the first empty slot. Growing rehashes into a new table
+ * that the owner publishes in place of this one.
+ *
+ * Entry must expose the problem text as a `problem` member convertible to
+ * std::string_view. Entries are not owned.
+ */
+template<typename Entry>
+class ProblemTable {
+public:
+    /**
+     * @param capacity Minimum slot count; rounded up to a power of two
+     */
+    explicit ProblemTable(size_t capacity = 16) {
+        size_t slot_count = 16;
+        while (slot_count < capacity) slot_count *= 2;
+        mask = slot_count - 1;
+        slots.reset(new Slot[slot_count]);
+    }
+
+    ProblemTable(const ProblemTable&) = delete;
+    ProblemTable& operator=(const ProblemTable&) = delete;
+
+    /**
+     * @brief Find an entry by problem text and its problemHash
+     * @param probes Incremented once per slot inspected, if given
+     * @return Entry, or nullptr if not stored
+     */
+    Entry* find(uint64_t hash, std::string_view problem, size_t* probes = nullptr) const {
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            if (probes) ++*probes;
+            Entry* entry = slots[i].entry.load(std::memory_order_acquire);
+            if (!entry) return nullptr;
+            if (slots[i].hash == hash && std::string_view(entry->problem) == problem) return entry;
+        }
+    }
+
+    /**
+     * @brief Add an entry whose problem is not yet stored; writer only
+     *
+     * The caller grows the table first while needsGrowth() holds, so a free
+     * slot always exists.
+     */
+    void insert(uint64_t hash, Entry* entry) {
+        size_t i = hash & mask;
+        while (slots[i].entry.load(std::memory_order_relaxed)) {
+            i = (i + 1) & mask;
+        }
+        slots[i].hash = hash;
+        slots[i].entry.store(entry, std::memory_order_release);
+        ++count;
+    }
+
+    /**
+     * @brief Whether one more insert would exceed a load factor of 1/2
+     */
+    bool needsGrowth() const { return (count + 1) * 2 > mask + 1; }
+
+    /**
+     * @brief Copy of this table with twice the slots; writer only
+     */
+    std::unique_ptr<ProblemTable> grown() const {
+        auto next = std::make_unique<ProblemTable>((mask + 1) * 2);
+        forEach([&](uint64_t hash, Entry* entry) { next->insert(hash, entry); });
+        return next;
+    }
+
+    /**
+     * @brief Visit every stored entry with its hash, in slot order
+     */
+    template<typename Visit>
+    void forEach(Visit&& visit) const {
+        for (size_t i = 0; i <= mask; ++i) {
+            if (Entry* entry = slots[i].entry.load(std::memory_order_acquire)) {
+                visit(slots[i].hash, entry);
+            }
+        }
+    }
+
+    size_t size() const { return count; }
+    size_t slotCount() const { return mask + 1; }
+
+private:
+    struct Slot {
+        uint64_t hash = 0;               // Written before entry is published
+        std::atomic<Entry*> entry{nullptr};
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask = 0;
+    size_t count = 0; // Writer only
+};
+
+} // namespace brains
+
+#endif // PROBLEM_TABLE_H
@@ -0,0 +1,399 @@
+#include "snapshot.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <cstdlib>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace brains {
+
+// On-disk layout: a fixed header followed by 8-byte aligned sections of
+// category, problem, solution and string records, then the string bytes.
+// Strings are referenced by id; integers are in host byte order, which the
+// header records so a foreign-endian file is rejected rather than misread.
+struct MemorySnapshot::Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t file_size;
+    uint64_t category_count;
+    uint64_t problem_count;
+    uint64_t solution_count;
+    uint64_t string_count;
+    uint64_t categories_offset;
+    uint64_t problems_offset;
+    uint64_t solutions_offset;
+    uint64_t strings_offset;
+    uint64_t string_data_offset;
+    uint64_t string_data_size;
+};
+
+struct MemorySnapshot::StringRecord {
+    uint64_t offset; // Relative to string_data_offset
+    uint64_t length;
+};
+
+struct MemorySnapshot::CategoryRecord {
+    uint64_t name;
+    uint64_t first_problem;
+    uint64_t problem_count;
+};
+
+// Problems of a category are contiguous and sorted by (hash, text)
+struct MemorySnapshot::ProblemRecord {
+    uint64_t hash;
+    uint64_t problem;
+    uint32_t first_solution;
+    uint16_t project_count;
+    uint16_t global_count;
+};
+
+struct MemorySnapshot::SolutionRecord {
+    uint64_t content;
+    int64_t created;
+    uint32_t use_count;
+    uint32_t flags;
+};
+
+namespace {
+
+constexpr char SNAPSHOT_MAGIC[8] = {'M', 'N', 'E', 'M', 'S', 'N', 'A', 'P'};
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr uint32_t SOLUTION_GLOBAL = 1;
+
+size_t alignTo8(size_t value) {
+    return (value + 7) & ~static_cast<size_t>(7);
+}
+
+template<typename T>
+void appendRecords(std::string& buffer, size_t offset, const std::vector<T>& records) {
+    static_assert(std::is_trivially_copyable<T>::value, "snapshot records must be trivially copyable");
+    if (!records.empty()) {
+        std::memcpy(&buffer[offset], records.data(), records.size() * sizeof(T));
+    }
+}
+
+} // namespace
+
+uint64_t snapshotHash(std::string_view text) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// SnapshotWriter Implementation
+uint64_t SnapshotWriter::internString(std::string_view text) {
+    auto [it, inserted] = string_ids.emplace(std::string(text), strings.size());
+    if (inserted) {
+        strings.push_back(it->first);
+    }
+    return it->second;
+}
+
+void SnapshotWriter::beginCategory(std::string_view name) {
+    categories.push_back({internString(name), {}});
+}
+
+void SnapshotWriter::addProblem(std::string_view problem, const std::vector<SnapshotSolution>& problem_solutions) {
+    if (categories.empty()) {
+        beginCategory("errors_uncategorised");
+    }
+
+    PendingProblem record{snapshotHash(problem), internString(problem),
+                          static_cast<uint32_t>(solutions.size()), 0, 0};
+
+    // Project history first, then global, each in the caller's (oldest first) order
+    for (bool global : {false, true}) {
+        for (const auto& solution : problem_solutions) {
+            if (solution.is_global != global) continue;
+            solutions.push_back({internString(solution.content), solution.created, solution.use_count,
+                                 global ? SOLUTION_GLOBAL : 0});
+            (global ? record.global_count : record.project_count)++;
+        }
+    }
+
+    categories.back().problems.push_back(record);
+}
+
+bool SnapshotWriter::write(const std::string& path) {
+    using Header = MemorySnapshot::Header;
+
+    std::vector<MemorySnapshot::CategoryRecord> category_records;
+    std::vector<MemorySnapshot::ProblemRecord> problem_records;
+    std::vector<MemorySnapshot::SolutionRecord> solution_records;
+    std::vector<MemorySnapshot::StringRecord> string_records;
+
+    for (auto& category : categories) {
+        std::sort(category.problems.begin(), category.problems.end(),
+                  [this](const PendingProblem& a, const PendingProblem& b) {
+                      return a.hash != b.hash ? a.hash < b.hash : strings[a.problem] < strings[b.problem];
+                  });
+
+        category_records.push_back({category.name, problem_records.size(), category.problems.size()});
+        for (const auto& problem : category.problems) {
+            problem_records.push_back({problem.hash, problem.problem, problem.first_solution,
+                                       problem.project_count, problem.global_count});
+        }
+    }
+
+    for (const auto& solution : solutions) {
+        solution_records.push_back({solution.content, solution.created, solution.use_count, solution.flags});
+    }
+
+    uint64_t string_data_size = 0;
+    for (const auto& text : strings) {
+        string_records.push_back({string_data_size, text.size()});
+        string_data_size += text.size();
+    }
+
+    Header header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = MemorySnapshot::FORMAT_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.category_count = category_records.size();
+    header.problem_count = problem_records.size();
+    header.solution_count = solution_records.size();
+    header.string_count = string_records.size();
+    header.categories_offset = alignTo8(sizeof(Header));
+    header.problems_offset = alignTo8(header.categories_offset + category_records.size() * sizeof(category_records[0]));
+    header.solutions_offset = alignTo8(header.problems_offset + problem_records.size() * sizeof(problem_records[0]));
+    header.strings_offset = alignTo8(header.solutions_offset + solution_records.size() * sizeof(solution_records[0]));
+    header.string_data_offset = header.strings_offset + string_records.size() * sizeof(string_records[0]);
+    header.string_data_size = string_data_size;
+    header.file_size = header.string_data_offset + string_data_size;
+
+    std::string buffer(header.file_size, '\0');
+    std::memcpy(&buffer[0], &header, sizeof(header));
+    appendRecords(buffer, header.categories_offset, category_records);
+    appendRecords(buffer, header.problems_offset, problem_records);
+    appendRecords(buffer, header.solutions_offset, solution_records);
+    appendRecords(buffer, header.strings_offset, string_records);
+    for (size_t i = 0; i < strings.size(); ++i) {
+        std::memcpy(&buffer[header.string_data_offset + string_records[i].offset], strings[i].data(), strings[i].size());
+    }
+
+    // Readers may have the old file mapped, so replace it rather than rewrite it
+    std::string temp_path = path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out.write(buffer.data(), static_cast<std::streamsize>(buffer.size())) || !out.flush()) {
+            std::remove(temp_path.c_str());
+            return false;
+        }
+    }
+#ifdef _WIN32
+    std::remove(path.c_str());
+#endif
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+// MemorySnapshot Implementation
+std::shared_ptr<const MemorySnapshot> MemorySnapshot::open(const std::string& path, std::string* error) {
+    std::shared_ptr<MemorySnapshot> snapshot(new MemorySnapshot());
+
+#ifdef _WIN32
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        if (error) *error = "cannot open " + path;
+        return nullptr;
+    }
+    snapshot->size = static_cast<size_t>(in.tellg());
+    char* buffer = new char[snapshot->size > 0 ? snapshot->size : 1];
+    snapshot->data = buffer;
+    in.seekg(0);
+    if (!in.read(buffer, static_cast<std::streamsize>(snapshot->size))) {
+        if (error) *error = "cannot read " + path;
+        return nullptr;
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        if (error) *error = "cannot open " + path;
+        return nullptr;
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        if (error) *error = "cannot stat " + path;
+        return nullptr;
+    }
+
+    snapshot->size = static_cast<size_t>(info.st_size);
+    void* mapping = ::mmap(nullptr, snapshot->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps the file alive
+    if (mapping == MAP_FAILED) {
+        if (error) *error = "cannot map " + path;
+        return nullptr;
+    }
+    snapshot->data = static_cast<const char*>(mapping);
+    snapshot->mapped = true;
+#endif
+
+    if (!snapshot->validate(error)) {
+        return nullptr;
+    }
+    return snapshot;
+}
+
+MemorySnapshot::~MemorySnapshot() {
+#ifdef _WIN32
+    delete[] data;
+#else
+    if (mapped) {
+        ::munmap(const_cast<char*>(data), size);
+    } else {
+        delete[] data;
+    }
+#endif
+}
+
+bool MemorySnapshot::validate(std::string* error) const {
+    auto fail = [error](const char* reason) {
+        if (error) *error = reason;
+        return false;
+    };
+
+    if (size < sizeof(Header)) return fail("snapshot truncated");
+    const Header& h = header();
+
+    if (std::memcmp(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic)) != 0) return fail("not a snapshot file");
+    if (h.byte_order != BYTE_ORDER_MARK) return fail("snapshot byte order mismatch");
+    if (h.version != FORMAT_VERSION) return fail("unsupported snapshot version");
+    if (h.file_size != size) return fail("snapshot size mismatch");
+
+    auto section_fits = [this](uint64_t offset, uint64_t count, size_t record_size) {
+        return offset % 8 == 0 && offset <= size && count <= (size - offset) / record_size;
+    };
+    if (!section_fits(h.categories_offset, h.category_count, sizeof(CategoryRecord)) ||
+        !section_fits(h.problems_offset, h.problem_count, sizeof(ProblemRecord)) ||
+        !section_fits(h.solutions_offset, h.solution_count, sizeof(SolutionRecord)) ||
+        !section_fits(h.strings_offset, h.string_count, sizeof(StringRecord)) ||
+        h.string_data_offset > size || h.string_data_size > size - h.string_data_offset) {
+        return fail("snapshot section out of bounds");
+    }
+
+    const auto* string_records = reinterpret_cast<const StringRecord*>(data + h.strings_offset);
+    for (uint64_t i = 0; i < h.string_count; ++i) {
+        if (string_records[i].offset > h.string_data_size ||
+            string_records[i].length > h.string_data_size - string_records[i].offset) {
+            return fail("snapshot string out of bounds");
+        }
+    }
+
+    const auto* category_records = reinterpret_cast<const CategoryRecord*>(data + h.categories_offset);
+    for (uint64_t c = 0; c < h.category_count; ++c) {
+        const auto& category = category_records[c];
+        if (category.name >= h.string_count || category.first_problem > h.problem_count ||
+            category.problem_count > h.problem_count - category.first_problem) {
+            return fail("snapshot category out of bounds");
+        }
+
+        const ProblemRecord* problems = problemRecords(c);
+        for (uint64_t p = 0; p < category.problem_count; ++p) {
+            const auto& problem = problems[p];
+            uint64_t solution_end = static_cast<uint64_t>(problem.first_solution) +
+                                    problem.project_count + problem.global_count;
+            if (problem.problem >= h.string_count || solution_end > h.solution_count) {
+                return fail("snapshot problem out of bounds");
+            }
+            if (p > 0 && problems[p - 1].hash > problem.hash) {
+                return fail("snapshot problems out of order");
+            }
+        }
+    }
+
+    const auto* solution_records = reinterpret_cast<const SolutionRecord*>(data + h.solutions_offset);
+    for (uint64_t s = 0; s < h.solution_count; ++s) {
+        if (solution_records[s].content >= h.string_count) {
+            return fail("snapshot solution out of bounds");
+        }
+    }
+
+    return true;
+}
+
+const MemorySnapshot::Header& MemorySnapshot::header() const {
+    return *reinterpret_cast<const Header*>(data);
+}
+
+const MemorySnapshot::CategoryRecord& MemorySnapshot::categoryRecord(size_t category) const {
+    return reinterpret_cast<const CategoryRecord*>(data + header().categories_offset)[category];
+}
+
+const MemorySnapshot::ProblemRecord* MemorySnapshot::problemRecords(size_t category) const {
+    return reinterpret_cast<const ProblemRecord*>(data + header().problems_offset) +
+           categoryRecord(category).first_problem;
+}
+
+std::string_view MemorySnapshot::string(uint64_t id) const {
+    const auto& record = reinterpret_cast<const StringRecord*>(data + header().strings_offset)[id];
+    return std::string_view(data + header().string_data_offset + record.offset, record.length);
+}
+
+MemorySnapshot::ProblemView MemorySnapshot::toView(const ProblemRecord& record) const {
+    return {string(record.problem), record.first_solution, record.project_count, record.global_count};
+}
+
+size_t MemorySnapshot::categoryCount() const {
+    return header().category_count;
+}
+
+std::string_view MemorySnapshot::categoryName(size_t category) const {
+    return string(categoryRecord(category).name);
+}
+
+size_t MemorySnapshot::problemCount(size_t category) const {
+    return categoryRecord(category).problem_count;
+}
+
+bool MemorySnapshot::findProblem(size_t category, std::string_view problem, ProblemView& view) const {
+    const ProblemRecord* begin = problemRecords(category);
+    const ProblemRecord* end = begin + categoryRecord(category).problem_count;
+    uint64_t hash = snapshotHash(problem);
+
+    auto it = std::lower_bound(begin, end, hash,
+                               [](const ProblemRecord& record, uint64_t value) { return record.hash < value; });
+    for (; it != end && it->hash == hash; ++it) {
+        if (string(it->problem) == problem) {
+            view = toView(*it);
+            return true;
+        }
+    }
+    return false;
+}
+
+MemorySnapshot::ProblemView MemorySnapshot::problemAt(size_t category, size_t index) const {
+    return toView(problemRecords(category)[index]);
+}
+
+std::vector<SnapshotSolution> MemorySnapshot::solutions(const ProblemView& view) const {
+    const auto* records = reinterpret_cast<const SolutionRecord*>(data + header().solutions_offset);
+
+    std::vector<SnapshotSolution> result;
+    result.reserve(view.project_count + view.global_count);
+    for (uint32_t i = 0; i < static_cast<uint32_t>(view.project_count + view.global_count); ++i) {
+        const auto& record = records[view.first_solution + i];
+        result.push_back({string(record.content), record.created, record.use_count,
+                          (record.flags & SOLUTION_GLOBAL) != 0});
+    }
+    return result;
+}
+
+} // namespace brains
@@ -0,0 +1,155 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+
+namespace brains {
+
+/**
+ * @brief Stable 64-bit FNV-1a hash used to key problems on disk
+ */
+uint64_t snapshotHash(std::string_view text);
+
+/**
+ * @brief Solution fields as stored in a snapshot
+ */
+struct SnapshotSolution {
+    std::string_view content;
+    int64_t created;    // Seconds since the Unix epoch
+    uint32_t use_count;
+    bool is_global;
+};
+
+/**
+ * @brief Serializes categories, problems and solutions into a snapshot file
+ *
+ * Call beginCategory, then addProblem for each of its problems; repeat per
+ * category and finish with write. Identical strings are stored once.
+ */
+class SnapshotWriter {
+public:
+    void beginCategory(std::string_view name);
+    void addProblem(std::string_view problem, const std::vector<SnapshotSolution>& solutions);
+
+    /**
+     * @brief Write the snapshot through a temporary file and rename it into place
+     * @param path Destination path
+     * @return true if the file was written completely
+     */
+    bool write(const std::string& path);
+
+private:
+    struct PendingProblem {
+        uint64_t hash;
+        uint64_t problem;      // String id
+        uint32_t first_solution;
+        uint16_t project_count;
+        uint16_t global_count;
+    };
+
+    struct PendingCategory {
+        uint64_t name;         // String id
+        std::vector<PendingProblem> problems;
+    };
+
+    struct PendingSolution {
+        uint64_t content;      // String id
+        int64_t created;
+        uint32_t use_count;
+        uint32_t flags;
+    };
+
+    std::vector<PendingCategory> categories;
+    std::vector<PendingSolution> solutions;
+    std::vector<std::string_view> strings; // Views into string_ids keys
+    std::unordered_map<std::string, uint64_t> string_ids;
+
+    uint64_t internString(std::string_view text);
+};
+
+/**
+ * @brief Read-only, memory-mapped snapshot of a MemoryEngine
+ *
+ * The file is validated once when opened; lookups then binary-search each
+ * category's problem records by hash directly in the mapped pages, without
+ * copying anything into the heap.
+ */
+class MemorySnapshot {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    /**
+     * @brief Problem record located in the snapshot
+     */
+    struct ProblemView {
+        std::string_view problem;
+        uint32_t first_solution;
+        uint16_t project_count;
+        uint16_t global_count;
+    };
+
+    /**
+     * @brief Map and validate a snapshot file
+     * @param path Snapshot path
+     * @param error Receives a description when the file is unusable
+     * @return Snapshot, or nullptr if the file is missing or invalid
+     */
+    static std::shared_ptr<const MemorySnapshot> open(const std::string& path, std::string* error = nullptr);
+
+    ~MemorySnapshot();
+
+    MemorySnapshot(const MemorySnapshot&) = delete;
+    MemorySnapshot& operator=(const MemorySnapshot&) = delete;
+
+    size_t categoryCount() const;
+    std::string_view categoryName(size_t category) const;
+    size_t problemCount(size_t category) const;
+
+    /**
+     * @brief Find a problem in one category
+     * @return true and fills view if the problem is stored
+     */
+    bool findProblem(size_t category, std::string_view problem, ProblemView& view) const;
+
+    /**
+     * @brief Problem record by position within its category
+     */
+    ProblemView problemAt(size_t category, size_t index) const;
+
+    /**
+     * @brief Solutions of a problem, project history first then global, oldest first
+     */
+    std::vector<SnapshotSolution> solutions(const ProblemView& view) const;
+
+    size_t fileSize() const { return size; }
+
+private:
+    friend class SnapshotWriter;
+
+    struct Header;
+    struct StringRecord;
+    struct CategoryRecord;
+    struct ProblemRecord;
+    struct SolutionRecord;
+
+    const char* data = nullptr;
+    size_t size = 0;
+    bool mapped = false; // Otherwise data is a heap buffer
+
+    MemorySnapshot() = default;
+    bool validate(std::string* error) const;
+    const Header& header() const;
+    const CategoryRecord& categoryRecord(size_t category) const;
+    const ProblemRecord* problemRecords(size_t category) const;
+    std::string_view string(uint64_t id) const;
+    ProblemView toView(const ProblemRecord& record) const;
+};
+
+} // namespace brains
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,142 @@
+#include "string_interner.h"
+#include "epoch.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+namespace brains {
+
+StringInterner::Shard& StringInterner::shardFor(std::string_view text) {
+    size_t hash = std::hash<std::string_view>{}(text);
+    return shards[(hash >> 32) % SHARD_COUNT];
+}
+
+std::string_view StringInterner::intern(std::string_view text) {
+    if (text.empty()) {
+        return std::string_view();
+    }
+
+    Shard& shard = shardFor(text);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.strings.find(text);
+    if (it != shard.strings.end()) {
+        reference(it->second, text.size());
+        return it->first;
+    }
+
+    Block* block;
+    char* stored = allocate(shard, text.size(), block);
+    std::memcpy(stored, text.data(), text.size());
+    std::string_view view(stored, text.size());
+    shard.strings.emplace(view, Interned{1, block});
+    block->strings.push_back(view);
+    block->referenced++;
+
+    string_count.fetch_add(1, std::memory_order_relaxed);
+    byte_count.fetch_add(text.size(), std::memory_order_relaxed);
+    return view;
+}
+
+void StringInterner::acquire(std::string_view interned) {
+    if (interned.empty()) {
+        return;
+    }
+
+    Shard& shard = shardFor(interned);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // Equal text elsewhere, such as in a snapshot mapping, is not ours to count
+    auto it = shard.strings.find(interned);
+    if (it == shard.strings.end() || it->first.data() != interned.data()) {
+        return;
+    }
+    reference(it->second, interned.size());
+}
+
+void StringInterner::release(std::string_view interned) {
+    if (interned.empty()) {
+        return;
+    }
+
+    Shard& shard = shardFor(interned);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.strings.find(interned);
+    if (it == shard.strings.end() || it->first.data() != interned.data() || it->second.references == 0) {
+        return;
+    }
+    unreference(shard, it->second, interned.size());
+}
+
+// Caller must hold the string's shard mutex
+void StringInterner::reference(Interned& interned, size_t length) {
+    if (interned.references++ == 0) {
+        interned.block->referenced++;
+        unreferenced_bytes.fetch_sub(length, std::memory_order_relaxed);
+    }
+}
+
+// Caller must hold shard.mutex; may erase the string from shard.strings
+void StringInterner::unreference(Shard& shard, Interned& interned, size_t length) {
+    if (--interned.references != 0) {
+        return;
+    }
+    unreferenced_bytes.fetch_add(length, std::memory_order_relaxed);
+    Block* block = interned.block;
+    if (--block->referenced == 0 && block != shard.current) {
+        retireBlock(shard, block);
+    }
+}
+
+// Caller must hold shard.mutex
+void StringInterner::retireBlock(Shard& shard, Block* block) {
+    size_t bytes = 0;
+    for (std::string_view view : block->strings) {
+        shard.strings.erase(view);
+        bytes += view.size();
+    }
+    string_count.fetch_sub(block->strings.size(), std::memory_order_relaxed);
+    byte_count.fetch_sub(bytes, std::memory_order_relaxed);
+    unreferenced_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    arena_bytes.fetch_sub(block->size, std::memory_order_relaxed);
+    retired_blocks.fetch_add(1, std::memory_order_relaxed);
+
+    // Unreferenced views may still be in use by readers pinned before this point
+    auto it = std::find_if(shard.blocks.begin(), shard.blocks.end(),
+                           [&](const std::unique_ptr<Block>& owned) { return owned.get() == block; });
+    std::swap(*it, shard.blocks.back());
+    EpochManager::instance().retire(shard.blocks.back().release());
+    shard.blocks.pop_back();
+}
+
+// Caller must hold shard.mutex
+char* StringInterner::allocate(Shard& shard, size_t length, Block*& block) {
+    // Large strings get a block of their own so they do not strand the current block's tail
+    if (length > BLOCK_SIZE / 4) {
+        shard.blocks.push_back(std::make_unique<Block>(Block{std::make_unique<char[]>(length), length}));
+        arena_bytes.fetch_add(length, std::memory_order_relaxed);
+        block = shard.blocks.back().get();
+        return block->data.get();
+    }
+
+    if (shard.current_used + length > BLOCK_SIZE) {
+        Block* full = shard.current;
+        shard.blocks.push_back(std::make_unique<Block>(Block{std::make_unique<char[]>(BLOCK_SIZE), BLOCK_SIZE}));
+        arena_bytes.fetch_add(BLOCK_SIZE, std::memory_order_relaxed);
+        shard.current = shard.blocks.back().get();
+        shard.current_used = 0;
+
+        // A full block whose text was all released while it was being filled is retired now
+        if (full && full->referenced == 0) {
+            retireBlock(shard, full);
+        }
+    }
+
+    block = shard.current;
+    char* stored = block->data.get() + shard.current_used;
+    shard.current_used += length;
+    return stored;
+}
+
+} // namespace brains
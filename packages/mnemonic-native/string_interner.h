@@ -0,0 +1,115 @@
+#ifndef STRING_INTERNER_H
+#define STRING_INTERNER_H
+
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+namespace brains {
+
+/**
+ * @brief Thread-safe store of distinct strings handing out stable views
+ *
+ * Each distinct text is copied once into arena blocks that are never moved.
+ * Interning is striped over SHARD_COUNT mutexes by hash.
+ *
+ * Holders count their references with intern()/acquire() and release(). A
+ * view stays valid while its text is referenced; unreferenced text is
+ * reported by unreferencedBytes() and reused if interned again, until every
+ * string in its block is unreferenced. The block is then retired through
+ * the EpochManager, so readers that found a view under an EpochGuard can
+ * use it until they unpin. The block still being filled is retired only
+ * once it is full.
+ */
+class StringInterner {
+public:
+    StringInterner() = default;
+
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+
+    /**
+     * @brief View of the interned copy of text, adding it if new
+     */
+    std::string_view intern(std::string_view text);
+
+    /**
+     * @brief Add a reference to a view returned by intern(); other views are ignored
+     */
+    void acquire(std::string_view interned);
+
+    /**
+     * @brief Drop a reference taken by intern() or acquire(); other views are ignored
+     */
+    void release(std::string_view interned);
+
+    /**
+     * @brief Number of distinct strings interned
+     */
+    size_t count() const { return string_count.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Bytes of interned text
+     */
+    size_t bytes() const { return byte_count.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Bytes of interned text that no holder references, not yet reclaimed
+     */
+    size_t unreferencedBytes() const { return unreferenced_bytes.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Bytes of arena blocks allocated and not yet retired, including unused block tails
+     */
+    size_t arenaBytes() const { return arena_bytes.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Number of arena blocks retired because none of their text was referenced
+     */
+    size_t retiredBlocks() const { return retired_blocks.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t SHARD_COUNT = 16;
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+        std::vector<std::string_view> strings; // Interned into this block
+        size_t referenced = 0;                 // Strings with at least one reference
+    };
+
+    struct Interned {
+        uint32_t references;
+        Block* block;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<std::string_view, Interned> strings; // Views into the blocks
+        std::vector<std::unique_ptr<Block>> blocks;             // Not yet retired; large strings get one each
+        Block* current = nullptr;                               // Small strings are appended here
+        size_t current_used = BLOCK_SIZE;
+    };
+
+    Shard shards[SHARD_COUNT];
+    std::atomic<size_t> string_count{0};
+    std::atomic<size_t> byte_count{0};
+    std::atomic<size_t> unreferenced_bytes{0};
+    std::atomic<size_t> arena_bytes{0};
+    std::atomic<size_t> retired_blocks{0};
+
+    Shard& shardFor(std::string_view text);
+    char* allocate(Shard& shard, size_t length, Block*& block);
+    void reference(Interned& interned, size_t length);
+    void unreference(Shard& shard, Interned& interned, size_t length);
+    void retireBlock(Shard& shard, Block* block);
+};
+
+} // namespace brains
+
+#endif // STRING_INTERNER_H
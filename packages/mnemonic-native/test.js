@@ -37,6 +37,23 @@ async function runTests() {
   }
   console.log(`Categorization: ${categorizationPassed}/${testErrors.length} passed`);
 
+  // Explicit priorities override declaration order when several categories match
+  const priorityEngine = new BrainsMemoryEngine();
+  priorityEngine.initialize({
+    networking: { patterns: ['http.*timeout'], priority: 2 },
+    database: { patterns: ['connection.*timeout'], priority: 1 }
+  });
+  const priorityCategory = priorityEngine.categorizeError('HTTP connection timeout');
+  console.log(`  ${priorityCategory === 'database' ? '✅' : '❌'} Priority ordering → ${priorityCategory} (expected: database)`);
+
+  // Hex escapes of letters bound class ranges and still match either case
+  const escapeEngine = new BrainsMemoryEngine();
+  escapeEngine.initialize({ hex: ['[\\x61-\\x7a]+rror', '\\x41PI down'] });
+  const rangeCategory = escapeEngine.categorizeError('an error here');
+  const foldedCategory = escapeEngine.categorizeError('the api down again');
+  console.log(`  ${rangeCategory === 'hex' ? '✅' : '❌'} Hex escape class range → ${rangeCategory} (expected: hex)`);
+  console.log(`  ${foldedCategory === 'hex' ? '✅' : '❌'} Hex escape folds case → ${foldedCategory} (expected: hex)`);
+
   // Test 3: Solution Storage and Retrieval
   console.log('\n💾 Test 3: Solution Storage and Retrieval');
   
@@ -92,6 +109,26 @@ async function runTests() {
   }
   console.log(`Lookup: ${lookupPassed}/${lookupTests.length} passed`);
 
+  // Near-match lookup resolves a reworded problem to the stored one
+  const similar = engine.findSimilarSolution('HTTP timeout on large uploads');
+  const similarPassed = similar !== null && similar.problem === 'HTTP timeout on uploads' && similar.score < 1;
+  console.log(`  ${similarPassed ? '✅' : '❌'} Near match for "HTTP timeout on large uploads"` +
+              (similar ? ` -> "${similar.problem}" (score ${similar.score.toFixed(2)})` : ''));
+
+  // Batch lookup returns one entry per problem, in input order
+  const batch = engine.findSolutions(
+    ['HTTP timeout on uploads', 'Non-existent problem', 'OAuth PKCE intent not triggering'],
+    ['networking', '', 'authentication']);
+  const batchPassed = batch.length === 3 && batch[0] !== null && batch[1] === null &&
+                      batch[2] !== null && batch[2].solution.content === engine.findSolution(storageTests[0].problem, 'authentication').solution.content;
+  console.log(`  ${batchPassed ? '✅' : '❌'} Batch lookup of 3 problems`);
+
+  // Promise variants run on the worker pool and agree with the sync path
+  const asyncStored = await engine.storeSolutionAsync('Connection refused on port 5432', 'database', 'Start the database service', false);
+  const asyncFound = await engine.findSolutionAsync('Connection refused on port 5432', 'database');
+  const asyncPassed = asyncStored && asyncFound !== null && asyncFound.solution.content === 'Start the database service';
+  console.log(`  ${asyncPassed ? '✅' : '❌'} Async store and lookup`);
+
   // Test 5: Performance Statistics
   console.log('\n📊 Test 5: Performance Statistics');
   const stats = engine.getStatistics();
@@ -106,6 +143,59 @@ async function runTests() {
     console.log(`❌ Statistics generation failed: ${stats?.error || 'Unknown error'}`);
   }
 
+  // Per-thread counter shards add up to exact totals
+  const countingEngine = new BrainsMemoryEngine();
+  countingEngine.initialize({ database: ['sql.*error'] });
+  countingEngine.storeSolution('SQL error near SELECT', 'database', 'Quote the column name', false);
+  const countingLookups = [];
+  for (let i = 0; i < 40; i++) {
+    countingLookups.push(countingEngine.findSolutionAsync(i % 4 === 0 ? 'SQL error near FROM' : 'SQL error near SELECT', 'database'));
+  }
+  await Promise.all(countingLookups);
+  countingEngine.findSolution('SQL error near SELECT', 'database');
+  const countingStats = countingEngine.getStatistics();
+  const countsExact = countingStats.total_lookups === 41 && countingStats.cache_hits === 31;
+  console.log(`  ${countsExact ? '✅' : '❌'} Lookup counters: ${countingStats.total_lookups} lookups, ${countingStats.cache_hits} hits (expected: 41, 31)`);
+
+  // Text evicted from a full history stays in the interner and is reported as unreferenced
+  const churnEngine = new BrainsMemoryEngine();
+  churnEngine.initialize({ database: { patterns: ['sql.*error'], historyCapacity: 2 } });
+  const churnSolutions = Array.from({ length: 10 }, (_, i) => `Rebuild index ${i} and retry the query`);
+  churnSolutions.forEach(solution => churnEngine.storeSolution('SQL error on churn', 'database', solution, false));
+  const churnStats = churnEngine.getStatistics();
+  if (churnStats.interned_unreferenced_bytes !== undefined) {
+    const evictedBytes = churnSolutions.slice(0, 8).reduce((sum, solution) => sum + solution.length, 0);
+    const churnReported = churnStats.interned_unreferenced_bytes === evictedBytes &&
+                          churnStats.interned_arena_bytes >= churnStats.interned_bytes;
+    console.log(`  ${churnReported ? '✅' : '❌'} Interned text growth: ${churnStats.interned_unreferenced_bytes} of ${churnStats.interned_bytes} bytes unreferenced (expected: ${evictedBytes})`);
+  }
+
+  // Text in a block of its own is reclaimed once nothing references it
+  const largeEngine = new BrainsMemoryEngine();
+  largeEngine.initialize({ database: { patterns: ['sql.*error'], historyCapacity: 2 } });
+  const largeSolutions = Array.from({ length: 10 }, (_, i) => `Rebuild index ${i} `.padEnd(20000, 'x'));
+  largeSolutions.forEach(solution => largeEngine.storeSolution('SQL error on large churn', 'database', solution, false));
+  const largeStats = largeEngine.getStatistics();
+  if (largeStats.interned_retired_blocks !== undefined) {
+    const largeFound = largeEngine.findSolution('SQL error on large churn', 'database');
+    const largeReclaimed = largeStats.interned_retired_blocks === 8 && largeStats.interned_unreferenced_bytes === 0 &&
+                           largeStats.interned_arena_bytes < largeSolutions.length * 20000 &&
+                           largeFound?.solution.content === largeSolutions[9];
+    console.log(`  ${largeReclaimed ? '✅' : '❌'} Interned text reclaimed: ${largeStats.interned_retired_blocks} blocks retired, ${largeStats.interned_arena_bytes} arena bytes left`);
+  }
+
+  // Shared blocks are reclaimed once full and unreferenced, so steady churn keeps the arena bounded
+  const blockEngine = new BrainsMemoryEngine();
+  blockEngine.initialize({ database: { patterns: ['sql.*error'], historyCapacity: 2 } });
+  for (let i = 0; i < 4000; i++) {
+    blockEngine.storeSolution('SQL error on block churn', 'database', `Rebuild index ${i} `.padEnd(1000, 'x'), false);
+  }
+  const blockStats = blockEngine.getStatistics();
+  if (blockStats.interned_retired_blocks !== undefined) {
+    const blockReclaimed = blockStats.interned_retired_blocks > 0 && blockStats.interned_arena_bytes < 4000 * 1000 / 2;
+    console.log(`  ${blockReclaimed ? '✅' : '❌'} Shared arena blocks reclaimed: ${blockStats.interned_retired_blocks} blocks retired, ${blockStats.interned_arena_bytes} arena bytes left`);
+  }
+
   // Test 6: Bulk Loading
   console.log('\n📦 Test 6: Bulk Solution Loading');
   const bulkSolutions = {
@@ -117,6 +207,172 @@ async function runTests() {
   const bulkSuccess = engine.loadSolutions('authentication', bulkSolutions, true);
   console.log(`${bulkSuccess ? '✅' : '❌'} Bulk loading: ${bulkSuccess ? 'PASS' : 'FAIL'}`);
 
+  // Snapshot round trip serves the same lookups from the mapped file
+  const snapshotPath = require('path').join(require('os').tmpdir(), `mnemonic-test-${process.pid}.snapshot`);
+  const saved = engine.saveSnapshot(snapshotPath);
+  const warmEngine = new BrainsMemoryEngine();
+  warmEngine.initialize(categories);
+  const warmLoaded = saved && warmEngine.loadSnapshot(snapshotPath);
+  const warmResult = warmLoaded ? warmEngine.findSolution('JWT token expired', 'authentication') : null;
+  const snapshotPassed = warmResult !== null && warmResult.solution.content === bulkSolutions['JWT token expired'];
+  console.log(`${snapshotPassed ? '✅' : '❌'} Snapshot save and warm start: ${snapshotPassed ? 'PASS' : 'FAIL'}`);
+  require('fs').rmSync(snapshotPath, { force: true });
+
+  // Stores logged to the write-ahead log are replayed by a fresh engine
+  const walPath = `${snapshotPath}.wal`;
+  const walOpened = warmEngine.openWriteAheadLog(walPath, snapshotPath);
+  warmEngine.storeSolution('Webhook signature mismatch', 'api', 'Verify against the raw request body');
+  const replayEngine = new BrainsMemoryEngine();
+  replayEngine.initialize(categories);
+  replayEngine.openWriteAheadLog(walPath, snapshotPath);
+  const replayed = replayEngine.findSolution('Webhook signature mismatch', 'api');
+  const compacted = warmEngine.compact() && require('fs').statSync(walPath).size === 0;
+  const walPassed = walOpened && replayed !== null && compacted;
+  console.log(`${walPassed ? '✅' : '❌'} Write-ahead log replay and compaction: ${walPassed ? 'PASS' : 'FAIL'}`);
+  for (const file of [snapshotPath, walPath, `${walPath}.compacting`]) {
+    require('fs').rmSync(file, { force: true });
+  }
+
+  // Lookup hits are logged in batches and restored on replay, for live and snapshot solutions alike
+  const hitsPath = `${snapshotPath}.hits`;
+  const openHitsEngine = () => {
+    const hitsEngine = new BrainsMemoryEngine();
+    hitsEngine.initialize(categories);
+    hitsEngine.loadSnapshot(hitsPath);
+    return hitsEngine.openWriteAheadLog(`${hitsPath}.wal`, hitsPath) ? hitsEngine : null;
+  };
+  const liveHits = openHitsEngine();
+  liveHits?.storeSolution('Webhook retries exhausted', 'api', 'Raise the retry budget');
+  [1, 2].forEach(() => liveHits?.findSolution('Webhook retries exhausted', 'api'));
+  const liveFlushed = liveHits?.flushUseCounts() === 1 && liveHits.flushUseCounts() === 0;
+  const liveRestored = openHitsEngine()?.findSolution('Webhook retries exhausted', 'api');
+  const mappedHits = liveHits?.compact() ? openHitsEngine() : null;
+  mappedHits?.findSolution('Webhook retries exhausted', 'api');
+  const mappedFlushed = mappedHits?.flushUseCounts() === 1;
+  const mappedRestored = openHitsEngine()?.findSolution('Webhook retries exhausted', 'api');
+  const hitsPassed = liveFlushed && liveRestored?.solution.use_count === 4 &&
+                     mappedFlushed && mappedRestored?.solution.use_count === 5;
+  console.log(`${hitsPassed ? '✅' : '❌'} Use counts logged and replayed: ${hitsPassed ? 'PASS' : 'FAIL'}`);
+  for (const file of [hitsPath, `${hitsPath}.wal`, `${hitsPath}.wal.compacting`]) {
+    require('fs').rmSync(file, { force: true });
+  }
+
+  // Memory files are parsed natively, keeping created dates and use counts
+  const yamlPath = `${snapshotPath}.yaml`;
+  require('fs').writeFileSync(yamlPath, [
+    'metadata:',
+    '  total_solutions: 2',
+    'lessons_learned:',
+    '  networking:',
+    '    \'Socket hang up: upstream\':',
+    '      solution: |-',
+    '        Raise the keep-alive timeout',
+    '        above the load balancer idle timeout',
+    '      created_date: \'2021-03-04T05:06:07.000Z\'',
+    '      use_count: 7',
+    '  database: {}',
+    ''
+  ].join('\n'));
+  const fileEngine = new BrainsMemoryEngine();
+  fileEngine.initialize(categories);
+  const fileLoaded = fileEngine.loadFromFile(yamlPath);
+  const fileResult = fileEngine.findSolution('Socket hang up: upstream', 'networking'); // Counts one more use
+  const filePassed = fileLoaded === 1 && fileResult !== null &&
+                     fileResult.solution.content === 'Raise the keep-alive timeout\nabove the load balancer idle timeout' &&
+                     fileResult.solution.created_date === String(Date.UTC(2021, 2, 4, 5, 6, 7) / 1000) &&
+                     fileResult.solution.use_count === 8;
+  console.log(`${filePassed ? '✅' : '❌'} Native memory file import: ${filePassed ? 'PASS' : 'FAIL'}`);
+  require('fs').rmSync(yamlPath, { force: true });
+
+  // Reloading a loaded category swaps in new and updated problems together
+  fileEngine.loadSolutions('networking', {
+    'Socket hang up: upstream': 'Retry idempotent requests once',
+    'ECONNRESET during deploy': 'Drain connections before stopping the old instance'
+  });
+  const reloaded = fileEngine.findSolutions(['Socket hang up: upstream', 'ECONNRESET during deploy'], ['networking', 'networking']);
+  const reloadPassed = reloaded[0] !== null && reloaded[0].solution.content === 'Retry idempotent requests once' &&
+                       reloaded[1] !== null;
+  console.log(`${reloadPassed ? '✅' : '❌'} Bulk reload of a loaded category: ${reloadPassed ? 'PASS' : 'FAIL'}`);
+
+  // Lookup hits raise use_count, are kept by snapshots and keep counting on the mapped layer
+  const countPath = `${snapshotPath}.counts`;
+  const counted = fileEngine.findSolution('ECONNRESET during deploy', 'networking');
+  const countSaved = fileEngine.saveSnapshot(countPath);
+  const countEngine = new BrainsMemoryEngine();
+  countEngine.initialize(categories);
+  const countLoaded = countSaved && countEngine.loadSnapshot(countPath);
+  const mappedUses = countLoaded
+    ? [1, 2].map(() => countEngine.findSolution('ECONNRESET during deploy', 'networking')?.solution.use_count)
+    : [];
+  const countPassed = counted !== null && counted.solution.use_count === 3 && mappedUses[0] === 4 && mappedUses[1] === 5;
+  console.log(`${countPassed ? '✅' : '❌'} Use counts from lookup hits: ${countPassed ? 'PASS' : 'FAIL'}`);
+  require('fs').rmSync(countPath, { force: true });
+
+  // Conflict decisions are cached per problem and give the same answer on every lookup
+  const conflictPath = `${snapshotPath}.conflict.yaml`;
+  const writeLesson = (solution, createdDate) => require('fs').writeFileSync(conflictPath, [
+    'lessons_learned:',
+    '  database:',
+    '    Deadlock on nightly import:',
+    `      solution: ${solution}`,
+    `      created_date: '${createdDate}'`,
+    ''
+  ].join('\n'));
+  writeLesson('Retry the transaction', '2020-01-01T00:00:00Z');
+  fileEngine.loadFromFile(conflictPath, false);
+  writeLesson('Import in primary key order', '2021-01-01T00:00:00Z');
+  fileEngine.loadFromFile(conflictPath, true);
+  const decisions = [1, 2].map(() => fileEngine.findSolution('Deadlock on nightly import', 'database'));
+  const decisionPassed = decisions.every(result => result !== null && result.conflict_resolution === 'newer_solution' &&
+                                                   result.solution.content === 'Import in primary key order');
+  console.log(`${decisionPassed ? '✅' : '❌'} Cached conflict decision: ${decisionPassed ? 'PASS' : 'FAIL'}`);
+
+  // A category's conflict policy replaces the default thresholds
+  const policyEngine = new BrainsMemoryEngine();
+  policyEngine.initialize({ database: { patterns: ['deadlock'], conflictPolicy: { ageDifferenceThresholdDays: 1000 } } },
+                          { conflictPolicy: { popularityRatioThreshold: 10 } });
+  writeLesson('Retry the transaction', '2020-01-01T00:00:00Z');
+  policyEngine.loadFromFile(conflictPath, false);
+  writeLesson('Import in primary key order', '2021-01-01T00:00:00Z');
+  policyEngine.loadFromFile(conflictPath, true);
+  const policyResult = policyEngine.findSolution('Deadlock on nightly import', 'database');
+  const policyPassed = policyResult !== null && policyResult.conflict_resolution === 'default_local_preference' &&
+                       policyResult.solution.content === 'Retry the transaction';
+  console.log(`${policyPassed ? '✅' : '❌'} Per-category conflict policy: ${policyPassed ? 'PASS' : 'FAIL'}`);
+
+  // An infinite popularity ratio switches the popularity rule off; NaN keeps the default
+  const writeCounted = (solution, createdDate, useCount) => require('fs').writeFileSync(conflictPath, [
+    'lessons_learned:',
+    '  database:',
+    '    Deadlock on nightly export:',
+    `      solution: ${solution}`,
+    `      created_date: '${createdDate}'`,
+    `      use_count: ${useCount}`,
+    ''
+  ].join('\n'));
+  const resolveWithRatio = (popularityRatioThreshold) => {
+    const ratioEngine = new BrainsMemoryEngine();
+    ratioEngine.initialize({ database: { patterns: ['deadlock'], conflictPolicy: { popularityRatioThreshold } } });
+    writeCounted('Export in smaller batches', '2021-01-01T00:00:00Z', 1);
+    ratioEngine.loadFromFile(conflictPath, false);
+    writeCounted('Lower the isolation level', '2021-02-01T00:00:00Z', 20);
+    ratioEngine.loadFromFile(conflictPath, true);
+    return ratioEngine.findSolution('Deadlock on nightly export', 'database')?.conflict_resolution;
+  };
+  const ratioResolutions = [Infinity, NaN].map(resolveWithRatio);
+  const ratioPassed = ratioResolutions[0] === 'default_local_preference' && ratioResolutions[1] === 'popularity_based';
+  console.log(`${ratioPassed ? '✅' : '❌'} Popularity ratio switched off: ${ratioResolutions.join(', ')} ` +
+              '(expected: default_local_preference, popularity_based)');
+  require('fs').rmSync(conflictPath, { force: true });
+
+  // Re-initializing the JS fallback drops the previous categories' policies
+  const JSMemoryEngine = require('./fallback.js');
+  const reinitialized = new JSMemoryEngine();
+  reinitialized.initialize({ database: { patterns: ['deadlock'], conflictPolicy: { ageDifferenceThresholdDays: 1000 } } });
+  reinitialized.initialize({ database: ['deadlock'] });
+  const reinitPassed = reinitialized._policyFor('database').ageDifferenceThresholdDays === 90;
+  console.log(`${reinitPassed ? '✅' : '❌'} Fallback re-initialize resets policies: ${reinitPassed ? 'PASS' : 'FAIL'}`);
+
   // Test 7: Performance Benchmark
   console.log('\n⚡ Test 7: Performance Benchmark');
   const iterations = 1000;
@@ -0,0 +1,923 @@
+/**
+ * Domain engine, event bus, event store and write-ahead log tests
+ *
+ * Each check prints a ✅ or ❌ line like test.js; the exit status is the
+ * number of failed checks. Checks that could hang give up after a timeout.
+ *
+ * Usage: domain_test
+ */
+
+#include "../domain_engine.h"
+#include "../event_store.h"
+#include <json/json.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+#include <csignal>
+#include <fstream>
+#include <stdlib.h>
+#include <sys/resource.h>
+
+using namespace brains;
+
+namespace {
+
+int failures = 0;
+
+void check(bool passed, const std::string& name) {
+    std::printf("  %s %s\n", passed ? "✅" : "❌", name.c_str());
+    if (!passed) ++failures;
+}
+
+// Runs body on its own thread; a body still running after seconds counts as hung
+template<typename Body>
+bool finishesWithin(double seconds, Body body) {
+    auto done = std::async(std::launch::async, body);
+    if (done.wait_for(std::chrono::duration<double>(seconds)) == std::future_status::ready) {
+        return true;
+    }
+    std::printf("  ❌ hung for %.0fs, giving up\n", seconds);
+    std::fflush(stdout);
+    std::_Exit(failures + 1);
+}
+
+// Fresh directory under the system temp directory, removed by the caller
+std::string temporaryDirectory() {
+    std::string path = (std::filesystem::temp_directory_path() / "domain_test_XXXXXX").string();
+    return ::mkdtemp(path.data()) ? path : std::string();
+}
+
+const std::unordered_map<std::string, std::vector<std::string>> CATEGORIES = {
+    {"database", {"sql.*error", "deadlock"}},
+    {"networking", {"timeout", "connection.*refused"}}
+};
+
+Json::Value statistics(const EventBus& bus) {
+    Json::Value stats;
+    Json::Reader().parse(bus.getStatistics(), stats);
+    return stats;
+}
+
+// Holds the worker inside a handler so the ring behind it can be filled
+class Gate {
+public:
+    void hold() {
+        std::unique_lock<std::mutex> lock(mutex);
+        entered = true;
+        cv.notify_all();
+        cv.wait(lock, [&] { return opened; });
+    }
+    void waitHeld() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return entered; });
+    }
+    void open() {
+        std::lock_guard<std::mutex> lock(mutex);
+        opened = true;
+        cv.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool entered = false;
+    bool opened = false;
+};
+
+// Records the labels of delivered events, holding the worker on "hold"
+struct Recorder {
+    Gate gate;
+    std::mutex mutex;
+    std::vector<std::string> labels;
+
+    void subscribe(EventBus& bus, const std::string& event_type = "BusTest") {
+        bus.subscribe(event_type, [this](const DomainEvent& event) {
+            const std::string& label = std::get<std::string>(event.payload);
+            if (label == "hold") gate.hold();
+            std::lock_guard<std::mutex> lock(mutex);
+            labels.push_back(label);
+        });
+    }
+
+    std::string delivered(size_t expected) {
+        for (int i = 0; i < 1000; ++i) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (labels.size() >= expected) break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        std::string joined;
+        for (const auto& label : labels) joined += (joined.empty() ? "" : " ") + label;
+        return joined;
+    }
+};
+
+bool publish(EventBus& bus, const std::string& aggregate_id, const std::string& label,
+             const std::string& event_type = "BusTest") {
+    return bus.publish(DomainEvent(aggregate_id, event_type, label));
+}
+
+// One worker with a ring of capacity, held inside the handler of its first event
+std::unique_ptr<EventBus> heldBus(OverflowPolicy policy, size_t capacity, Recorder& recorder) {
+    EventBusConfig config;
+    config.worker_count = 1;
+    config.queue_capacity = capacity;
+    config.overflow_policy = policy;
+    auto bus = std::make_unique<EventBus>(config);
+    recorder.subscribe(*bus);
+    bus->start();
+    publish(*bus, "held", "hold");
+    recorder.gate.waitHeld();
+    return bus;
+}
+
+// A held bus whose ring of 4 is filled with events 1 to 4
+std::unique_ptr<EventBus> filledBus(OverflowPolicy policy, Recorder& recorder) {
+    auto bus = heldBus(policy, 4, recorder);
+    for (int i = 1; i <= 4; ++i) {
+        publish(*bus, "a" + std::to_string(i), std::to_string(i));
+    }
+    return bus;
+}
+
+void testOverflowPolicies() {
+    std::printf("\nOverflow policies\n");
+
+    {
+        Recorder recorder;
+        auto bus = filledBus(OverflowPolicy::BLOCK, recorder);
+        Json::Value full = statistics(*bus);
+        check(full["high_watermark"].asUInt64() == 3 && full["high_watermark_hits"].asUInt64() == 1 &&
+              full["saturated_workers"].asInt() == 1 && full["peak_queue_size"].asUInt64() == 4,
+              "high watermark reached once while the ring fills");
+
+        auto blocked = std::async(std::launch::async, [&] { return publish(*bus, "a5", "5"); });
+        bool waited = blocked.wait_for(std::chrono::milliseconds(50)) == std::future_status::timeout;
+        recorder.gate.open();
+        check(waited && blocked.get(), "block waits for room, then publishes");
+        check(recorder.delivered(6) == "hold 1 2 3 4 5", "block delivers every event in order");
+        Json::Value drained = statistics(*bus);
+        for (int i = 0; i < 1000 && drained["processed"].asUInt64() < 6; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            drained = statistics(*bus);
+        }
+        check(drained["saturated_workers"].asInt() == 0 && drained["processed"].asUInt64() == 6,
+              "worker recovers below the low watermark");
+    }
+
+    {
+        Recorder recorder;
+        auto bus = filledBus(OverflowPolicy::DROP_NEWEST, recorder);
+        bool rejected = !publish(*bus, "a5", "5");
+        recorder.gate.open();
+        check(rejected && statistics(*bus)["dropped"].asUInt64() == 1, "drop newest rejects and counts the event");
+        check(recorder.delivered(5) == "hold 1 2 3 4", "drop newest keeps the queued events");
+    }
+
+    {
+        Recorder recorder;
+        auto bus = filledBus(OverflowPolicy::DROP_OLDEST, recorder);
+        bool accepted = publish(*bus, "a5", "5") && publish(*bus, "a6", "6");
+        recorder.gate.open();
+        check(accepted && statistics(*bus)["evicted"].asUInt64() == 2, "drop oldest accepts and counts evictions");
+        check(recorder.delivered(5) == "hold 3 4 5 6", "drop oldest evicts from the front");
+    }
+
+    {
+        Recorder recorder;
+        auto bus = filledBus(OverflowPolicy::COALESCE_BY_AGGREGATE, recorder);
+        bool accepted = publish(*bus, "x", "5") && publish(*bus, "y", "6") && publish(*bus, "x", "7");
+        Json::Value pending = statistics(*bus);
+        recorder.gate.open();
+        check(accepted && pending["coalesced"].asUInt64() == 1 && pending["queue_size"].asInt() == 6,
+              "coalescing replaces the pending event of the same aggregate");
+        check(recorder.delivered(7) == "hold 1 2 3 4 7 6", "coalesced events keep their place in line");
+    }
+
+    {
+        // Events published while stopped wait for start(); a full ring rejects instead of blocking
+        Recorder recorder;
+        auto bus = filledBus(OverflowPolicy::BLOCK, recorder);
+        recorder.gate.open();
+        recorder.delivered(5);
+        bus->stop();
+        bool queued = true;
+        for (int i = 5; i <= 8; ++i) {
+            queued = publish(*bus, "a" + std::to_string(i), std::to_string(i)) && queued;
+        }
+        bool rejected = false;
+        finishesWithin(10, [&] { rejected = !publish(*bus, "a9", "9"); });
+        rejected = rejected && statistics(*bus)["dropped"].asUInt64() == 1;
+        check(queued && rejected, "stopped bus queues while there is room and rejects once full");
+    }
+}
+
+void testDispatch() {
+    std::printf("\nDispatch\n");
+
+    {
+        // Events queued behind the held one are dispatched as one run per type
+        Recorder recorder;
+        auto bus = heldBus(OverflowPolicy::BLOCK, 16, recorder);
+        recorder.subscribe(*bus, "RunA");
+        recorder.subscribe(*bus, "RunB");
+        std::vector<std::string> batches;
+        bus->subscribeBatch("RunA", [&](const DomainEvent* events, size_t count) {
+            std::string labels;
+            for (size_t i = 0; i < count; ++i) {
+                labels += (labels.empty() ? "" : " ") + std::get<std::string>(events[i].payload);
+            }
+            std::lock_guard<std::mutex> lock(recorder.mutex);
+            batches.push_back(labels);
+        });
+        publish(*bus, "a", "A1", "RunA");
+        publish(*bus, "b", "B1", "RunB");
+        publish(*bus, "a", "A2", "RunA");
+        publish(*bus, "b", "B2", "RunB");
+        publish(*bus, "a", "A3", "RunA");
+        recorder.gate.open();
+        check(recorder.delivered(6) == "hold A1 A2 A3 B1 B2", "each type runs in publish order, types by first appearance");
+        std::lock_guard<std::mutex> lock(recorder.mutex);
+        check(batches.size() == 1 && batches[0] == "A1 A2 A3", "batch handler gets the whole run at once");
+    }
+
+    {
+        // Types spread over workers still see their own events in publish order
+        EventBusConfig config;
+        config.worker_count = 4;
+        config.queue_capacity = 64;
+        EventBus bus(config);
+        constexpr int TYPES = 4;
+        constexpr int EVENTS = 2000;
+        std::atomic<int> delivered{0};
+        std::atomic<bool> ordered{true};
+        std::vector<int> last(TYPES, -1);
+        for (int type = 0; type < TYPES; ++type) {
+            bus.subscribe("Order" + std::to_string(type), [&, type](const DomainEvent& event) {
+                int sequence = std::stoi(std::get<std::string>(event.payload));
+                if (sequence != last[type] + 1) ordered = false;
+                last[type] = sequence;
+                delivered++;
+            });
+        }
+        bus.start();
+        finishesWithin(10, [&] {
+            for (int i = 0; i < EVENTS; ++i) {
+                for (int type = 0; type < TYPES; ++type) {
+                    publish(bus, "o" + std::to_string(i % 7), std::to_string(i), "Order" + std::to_string(type));
+                }
+            }
+        });
+        for (int i = 0; i < 1000 && delivered < TYPES * EVENTS; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        bus.stop();
+        check(delivered == TYPES * EVENTS && ordered, "every type delivered in publish order across workers");
+    }
+
+    {
+        // Subscribing copies the table: it never waits on dispatch, and a
+        // batch already dispatching keeps the handlers it started with
+        Recorder recorder;
+        auto bus = heldBus(OverflowPolicy::BLOCK, 16, recorder);
+        check(finishesWithin(10, [&] { recorder.subscribe(*bus, "Late"); }),
+              "subscribe while a handler is running does not wait for it");
+
+        std::vector<std::string> nested;
+        std::atomic<bool> added{false};
+        bus->subscribe("Nested", [&](const DomainEvent&) {
+            if (added.exchange(true)) return;
+            bus->subscribe("Nested", [&](const DomainEvent& event) {
+                std::lock_guard<std::mutex> lock(recorder.mutex);
+                nested.push_back(std::get<std::string>(event.payload));
+            });
+        });
+        publish(*bus, "n", "N1", "Nested");
+        publish(*bus, "n", "N2", "Nested");
+        publish(*bus, "l", "L1", "Late");
+        recorder.gate.open();
+        recorder.delivered(2);
+        publish(*bus, "n", "N3", "Nested");
+        publish(*bus, "l", "L2", "Late");
+        check(recorder.delivered(3) == "hold L1 L2", "handler subscribed mid-dispatch sees later events");
+        std::lock_guard<std::mutex> lock(recorder.mutex);
+        check(nested.size() == 1 && nested[0] == "N3", "handler subscribed by a handler starts with the next batch");
+    }
+}
+
+std::string fieldNames(const DomainEvent& event) {
+    Json::Value data;
+    if (!Json::Reader().parse(event.dataJson(), data) || !data.isObject()) {
+        return "<not an object>";
+    }
+    std::vector<std::string> names = data.getMemberNames();
+    std::sort(names.begin(), names.end());
+    std::string joined;
+    for (const auto& name : names) joined += (joined.empty() ? "" : " ") + name;
+    return joined;
+}
+
+void testPayloadJson() {
+    std::printf("\nPayload JSON\n");
+
+    // The field names the aggregates wrote as JSON text before payloads were typed
+    const std::vector<std::pair<DomainEvent, std::string>> expected = {
+        {DomainEvent("m", events::MemoryEntryCreated{}), "category problem solution"},
+        {DomainEvent("m", events::MemoryEntryUpdated{}), "new_solution old_solution reason"},
+        {DomainEvent("m", events::ConflictDetected{}), "conflict_id strategy total_conflicts"},
+        {DomainEvent("m", events::ConfidenceUpdated{}), "new_confidence old_confidence"},
+        {DomainEvent("s", events::SearchSessionStarted{}), "query started_at"},
+        {DomainEvent("s", events::LayerAdded{}), "layer_order layer_type"},
+        {DomainEvent("s", events::ResultAdded{}), "confidence result_id total_results"},
+        {DomainEvent("s", events::SearchSessionCompleted{}), "duration_ms final_confidence layers_used results_found"},
+        {DomainEvent("s", events::SearchSessionFailed{}), "duration_ms reason"}
+    };
+    for (const auto& [event, names] : expected) {
+        check(fieldNames(event) == names, std::string(event.event_type) + " fields: " + names);
+    }
+
+    Json::Value created;
+    Json::Reader().parse(DomainEvent("m", events::MemoryEntryCreated{"SQL error", "Quote it", "database"}).dataJson(),
+                         created);
+    Json::Value completed;
+    Json::Reader().parse(DomainEvent("s", events::SearchSessionCompleted{0.75, 12, 3, 2}).dataJson(), completed);
+    check(created["problem"].asString() == "SQL error" && created["category"].asString() == "database" &&
+          completed["final_confidence"].asDouble() == 0.75 && completed["duration_ms"].asInt64() == 12 &&
+          completed["layers_used"].asInt() == 3 && completed["results_found"].asInt() == 2,
+          "field values keep their JSON types");
+
+    const std::string text = "{\"custom\":1}";
+    check(DomainEvent("x", "Custom", text).dataJson() == text, "JSON text payloads pass through unchanged");
+}
+
+void testCommandsPublishOutsideEngineLock() {
+    std::printf("\nCommands and handlers\n");
+
+    // A one-slot-per-event ring fills at once, so publishing waits on a handler that reads the engine
+    EventBusConfig config;
+    config.worker_count = 1;
+    config.queue_capacity = 2;
+    DomainMemoryEngine engine(config);
+    engine.initializeDomain(CATEGORIES);
+
+    std::atomic<int> seen{0};
+    engine.subscribeToEvents("MemoryEntryCreated", [&](const DomainEvent& event) {
+        if (engine.getMemoryEntry(event.aggregate_id)) seen++;
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    });
+
+    finishesWithin(10, [&] {
+        for (int i = 0; i < 50; ++i) {
+            engine.createMemoryEntry("SQL error " + std::to_string(i), "Quote the column", "database");
+        }
+    });
+    for (int i = 0; i < 1000 && seen < 50; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    check(seen == 50, "handler reading the engine while commands wait for queue room (" +
+                      std::to_string(seen.load()) + "/50 seen)");
+
+    // Handlers may issue commands too; their events queue behind the ones being published
+    engine.subscribeToEvents("SearchSessionStarted", [&](const DomainEvent& event) {
+        engine.addSearchLayer(event.aggregate_id, "exact");
+    });
+    check(finishesWithin(10, [&] {
+        for (int i = 0; i < 20; ++i) {
+            engine.startSearchSession("deadlock " + std::to_string(i));
+        }
+    }), "handler issuing commands while commands wait for queue room");
+}
+
+std::string segmentPath(const std::string& directory, int segment) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "/events-%06d.log", segment);
+    return directory + name;
+}
+
+// Aggregate id and layer type of each visited event, in visiting order
+std::string visitedLayers(const EventStore& store, const std::string& aggregate_id = "") {
+    std::string visited;
+    auto visit = [&](const DomainEvent& event) {
+        const auto* layer = std::get_if<events::LayerAdded>(&event.payload);
+        visited += (visited.empty() ? "" : " ") + event.aggregate_id + ":" + (layer ? layer->layer_type : "?");
+    };
+    if (aggregate_id.empty()) {
+        store.replayAll(visit);
+    } else {
+        store.replay(aggregate_id, visit);
+    }
+    return visited;
+}
+
+// Appends the next event of the aggregate's stream, or the given version
+bool appendLayer(EventStore& store, const std::string& aggregate_id, const std::string& layer_type, int version = 0) {
+    DomainEvent event(aggregate_id, events::LayerAdded{layer_type, 1});
+    event.version = version ? version : static_cast<int>(store.replay(aggregate_id, [](const DomainEvent&) {})) + 1;
+    return store.append(&event, 1);
+}
+
+void overwrite(const std::string& path, std::streamoff offset, const std::string& bytes) {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(offset);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+void testEventStore() {
+    std::printf("\nEvent store\n");
+
+    std::string directory = temporaryDirectory();
+    {
+        EventStore store;
+        store.open(directory);
+        appendLayer(store, "a", "exact");
+        appendLayer(store, "b", "fuzzy");
+        appendLayer(store, "a", "semantic");
+        check(visitedLayers(store) == "a:exact b:fuzzy a:semantic", "replayAll visits every event in append order");
+        check(visitedLayers(store, "a") == "a:exact a:semantic" && visitedLayers(store, "c").empty(),
+              "replay visits one aggregate's events through the index");
+        check(!store.open(directory), "open refuses while the store is open");
+    }
+
+    // A record cut off mid-write is dropped on open and overwritten by the next append
+    uint64_t valid_size = std::filesystem::file_size(segmentPath(directory, 1));
+    {
+        std::ofstream torn(segmentPath(directory, 1), std::ios::binary | std::ios::app);
+        torn.write("\x40\0\0\0\x12\x34", 6);
+    }
+    {
+        EventStore store;
+        bool opened = store.open(directory);
+        check(opened && store.eventCount() == 3 && std::filesystem::file_size(segmentPath(directory, 1)) == valid_size,
+              "open truncates a torn tail");
+        appendLayer(store, "b", "exact");
+        check(visitedLayers(store) == "a:exact b:fuzzy a:semantic b:exact", "appends follow the last whole record");
+    }
+
+    // A flipped payload byte fails the CRC; the segment ends before that record
+    overwrite(segmentPath(directory, 1), static_cast<std::streamoff>(valid_size) - 2, "\xff");
+    {
+        EventStore store;
+        store.open(directory);
+        check(store.eventCount() == 2 && visitedLayers(store) == "a:exact b:fuzzy" &&
+              visitedLayers(store, "a") == "a:exact",
+              "a record failing its CRC is not replayed");
+    }
+    std::filesystem::remove_all(directory);
+
+    directory = temporaryDirectory();
+    size_t segments = 0;
+    {
+        EventStoreOptions options;
+        options.segment_bytes = 256;
+        EventStore store(options);
+        store.open(directory);
+        for (int i = 0; i < 12; ++i) {
+            appendLayer(store, i % 2 ? "odd" : "even", "layer" + std::to_string(i));
+        }
+        std::vector<DomainEvent> batch;
+        for (int i = 0; i < 4; ++i) {
+            batch.emplace_back("batch", events::LayerAdded{"batched" + std::to_string(i), i + 1});
+            batch.back().version = i + 1;
+        }
+        size_t before = store.segmentCount();
+        store.append(batch.data(), batch.size());
+        check(before > 2 && store.segmentCount() == before + 1, "appends roll over to new segments");
+        check(std::filesystem::file_size(segmentPath(directory, static_cast<int>(store.segmentCount()))) > 256,
+              "one append's events share a segment");
+    }
+    {
+        EventStoreOptions options;
+        options.segment_bytes = 256;
+        EventStore store(options);
+        store.open(directory);
+        segments = store.segmentCount();
+        std::string all;
+        std::string odd;
+        for (int i = 0; i < 12; ++i) {
+            std::string visited = std::string(i % 2 ? "odd" : "even") + ":layer" + std::to_string(i);
+            all += (all.empty() ? "" : " ") + visited;
+            if (i % 2) odd += (odd.empty() ? "" : " ") + visited;
+        }
+        std::string batched = "batch:batched0 batch:batched1 batch:batched2 batch:batched3";
+        check(store.eventCount() == 16 && visitedLayers(store) == all + " " + batched &&
+              visitedLayers(store, "odd") == odd && visitedLayers(store, "batch") == batched,
+              "replay and replayAll read across segments after reopening");
+    }
+
+    // A segment whose header never made it to disk is started again
+    std::ofstream(segmentPath(directory, static_cast<int>(segments) + 1), std::ios::binary).write("MNEM", 4);
+    {
+        EventStore store;
+        bool opened = store.open(directory);
+        opened = opened && appendLayer(store, "late", "exact");
+        check(opened && store.eventCount() == 17 && visitedLayers(store, "late") == "late:exact",
+              "open restarts a segment cut off inside its header");
+    }
+
+    overwrite(segmentPath(directory, 1), 0, "XXXX");
+    {
+        EventStore store;
+        check(!store.open(directory), "open rejects a segment without the magic");
+    }
+    overwrite(segmentPath(directory, 1), 0, "MNEM");
+    overwrite(segmentPath(directory, 1), 8, std::string("\x02\0\0\0", 4));
+    {
+        EventStore store;
+        check(!store.open(directory), "open rejects a segment of another format version");
+    }
+    std::filesystem::remove_all(directory);
+
+    // Versions number each aggregate's stream from 1, so two aggregates sharing an id cannot interleave
+    directory = temporaryDirectory();
+    {
+        EventStore store;
+        store.open(directory);
+        appendLayer(store, "a", "exact");
+        bool gap = appendLayer(store, "a", "gap", 3);
+        bool repeat = appendLayer(store, "a", "repeat", 1);
+        bool fresh = appendLayer(store, "b", "late", 2);
+        check(!gap && !repeat && !fresh && store.eventCount() == 1,
+              "appends that do not continue their aggregate's stream are rejected");
+
+        DomainEvent batch[] = {DomainEvent("c", events::LayerAdded{"first", 1}),
+                               DomainEvent("c", events::LayerAdded{"second", 2})};
+        bool repeated = store.append(batch, 2);
+        batch[1].version = 3;
+        bool skipped = store.append(batch, 2);
+        batch[1].version = 2;
+        check(!repeated && !skipped && store.append(batch, 2) && store.eventCount() == 3,
+              "a batch continues streams within itself, and a rejected one leaves the store writable");
+    }
+    {
+        EventStore store;
+        store.open(directory);
+        check(!appendLayer(store, "c", "stale", 2) && appendLayer(store, "c", "third", 3),
+              "open restores each stream's last version");
+    }
+    std::filesystem::remove_all(directory);
+
+    // A write that fails leaves the store refusing appends until it is reopened
+    directory = temporaryDirectory();
+    {
+        EventStore store;
+        store.open(directory);
+        appendLayer(store, "a", "exact");
+        uint64_t size = std::filesystem::file_size(segmentPath(directory, 1));
+
+        struct rlimit limit;
+        ::getrlimit(RLIMIT_FSIZE, &limit);
+        struct rlimit capped = limit;
+        capped.rlim_cur = size + 64;
+        auto previous = std::signal(SIGXFSZ, SIG_IGN);
+        ::setrlimit(RLIMIT_FSIZE, &capped);
+        bool failed = !appendLayer(store, "a", std::string(256, 'x'));
+        ::setrlimit(RLIMIT_FSIZE, &limit);
+        std::signal(SIGXFSZ, previous);
+
+        bool refused = !appendLayer(store, "a", "fuzzy");
+        check(failed && refused, "a failed append makes the store refuse appends");
+        bool reopened = store.reopen();
+        check(reopened && appendLayer(store, "a", "fuzzy") && visitedLayers(store) == "a:exact a:fuzzy",
+              "reopen drops the partial write and resumes appends");
+        store.close();
+        check(store.open(directory) && store.eventCount() == 2, "open works again after close");
+    }
+    std::filesystem::remove_all(directory);
+}
+
+void testEventSourcing() {
+    std::printf("\nEvent sourcing\n");
+
+    {
+        // Sessions started in the same millisecond each get a stream of their own
+        std::string directory = temporaryDirectory();
+        std::vector<std::string> sessions;
+        {
+            DomainMemoryEngine engine;
+            engine.initializeDomain(CATEGORIES);
+            engine.openEventStore(directory);
+            for (int i = 0; i < 50; ++i) {
+                sessions.push_back(engine.startSearchSession("timeout " + std::to_string(i)));
+                engine.addSearchLayer(sessions.back(), "layer" + std::to_string(i));
+            }
+        }
+        DomainMemoryEngine engine;
+        engine.initializeDomain(CATEGORIES);
+        engine.openEventStore(directory);
+        int intact = 0;
+        for (int i = 0; i < 50; ++i) {
+            const SearchSessionAggregate* session = engine.getSearchSession(sessions[i]);
+            if (session && session->getQuery() == "timeout " + std::to_string(i) &&
+                session->getLayersUsed() == std::vector<std::string>{"layer" + std::to_string(i)}) {
+                intact++;
+            }
+        }
+        check(intact == 50, "sessions created back to back replay separately (" + std::to_string(intact) + "/50)");
+        std::filesystem::remove_all(directory);
+    }
+
+    std::string directory = temporaryDirectory();
+    std::string session_id;
+    std::string entry_id;
+    std::vector<std::string> live_layers;
+    {
+        DomainMemoryEngine engine;
+        engine.initializeDomain(CATEGORIES);
+        engine.openEventStore(directory);
+        session_id = engine.startSearchSession("deadlock detected");
+        engine.addSearchLayer(session_id, "exact");
+        engine.addSearchLayer(session_id, "exact");
+        engine.completeSearchSession(session_id, 0.5);
+        entry_id = engine.createMemoryEntry("SQL error near FROM", "Quote the column", "database");
+        engine.updateMemoryEntry(entry_id, "Rename the column", "reserved word");
+        engine.createMemoryEntry("npm ERR peer dep", "Use --legacy-peer-deps", "npm");
+        live_layers = engine.getSearchSession(session_id)->getLayersUsed();
+        auto found = engine.findSolution("SQL error near FROM", "database");
+        check(found && found->solution.content == "Rename the column", "updated entry answers findSolution");
+    }
+    check(live_layers.size() == 2, "every raised event is applied, repeats included");
+
+    {
+        DomainMemoryEngine engine;
+        engine.initializeDomain(CATEGORIES);
+        engine.openEventStore(directory);
+        const SearchSessionAggregate* session = engine.getSearchSession(session_id);
+        const MemoryEntryAggregate* entry = engine.getMemoryEntry(entry_id);
+        check(session && session->getLayersUsed() == live_layers && session->getStatus() == "completed" &&
+              session->getFinalConfidence() == 0.5 && session->getVersion() == 4,
+              "replayed session matches the live one");
+        check(entry && entry->getProblem() == "SQL error near FROM" && entry->getSolution() == "Rename the column" &&
+              entry->getCategory() == "database" && entry->getVersion() == 2,
+              "replayed entry matches the live one");
+
+        auto updated = engine.findSolution("SQL error near FROM", "database");
+        auto created = engine.findSolution("npm ERR peer dep", "npm");
+        check(updated && updated->solution.content == "Rename the column" &&
+              created && created->solution.content == "Use --legacy-peer-deps",
+              "replayed entries answer findSolution");
+    }
+    std::filesystem::remove_all(directory);
+
+    // A command whose write fails leaves its entry unchanged, and the next command stores again
+    directory = temporaryDirectory();
+    {
+        DomainMemoryEngine engine;
+        engine.initializeDomain(CATEGORIES);
+        engine.openEventStore(directory);
+        entry_id = engine.createMemoryEntry("connection refused on 5432", "Start postgres", "networking");
+        uint64_t size = std::filesystem::file_size(segmentPath(directory, 1));
+
+        struct rlimit limit;
+        ::getrlimit(RLIMIT_FSIZE, &limit);
+        struct rlimit capped = limit;
+        capped.rlim_cur = size + 64;
+        auto previous = std::signal(SIGXFSZ, SIG_IGN);
+        ::setrlimit(RLIMIT_FSIZE, &capped);
+        bool failed = !engine.updateMemoryEntry(entry_id, std::string(256, 'x'), "too long");
+        ::setrlimit(RLIMIT_FSIZE, &limit);
+        std::signal(SIGXFSZ, previous);
+
+        const MemoryEntryAggregate* entry = engine.getMemoryEntry(entry_id);
+        check(failed && entry->getSolution() == "Start postgres" && entry->getVersion() == 1,
+              "a command whose events cannot be stored fails without changing its entry");
+        check(engine.updateMemoryEntry(entry_id, "Open the port", "firewall") && entry->getVersion() == 2,
+              "the engine reopens a failed store for the next command");
+    }
+    {
+        DomainMemoryEngine engine;
+        engine.initializeDomain(CATEGORIES);
+        engine.openEventStore(directory);
+        const MemoryEntryAggregate* entry = engine.getMemoryEntry(entry_id);
+        check(entry && entry->getSolution() == "Open the port" && entry->getVersion() == 2,
+              "commands after the failure replay without the failed one");
+    }
+    std::filesystem::remove_all(directory);
+}
+
+void testCommandsWithReaders() {
+    std::printf("\nCommands and readers\n");
+
+    // Commands store their events with a disk sync each while readers search the same entry
+    std::string directory = temporaryDirectory();
+    constexpr int WRITERS = 2;
+    constexpr int UPDATES = 40;
+    std::string entry_id;
+    std::string final_solution;
+    std::atomic<int> searches{0};
+    std::atomic<bool> consistent{true};
+    {
+        DomainMemoryEngine engine;
+        engine.initializeDomain(CATEGORIES);
+        engine.openEventStore(directory);
+        entry_id = engine.createMemoryEntry("deadlock on orders table", "Retry", "database");
+
+        std::atomic<int> writing{WRITERS};
+        std::vector<std::thread> threads;
+        for (int w = 0; w < WRITERS; ++w) {
+            threads.emplace_back([&, w] {
+                for (int i = 0; i < UPDATES; ++i) {
+                    engine.updateMemoryEntry(entry_id, "Retry " + std::to_string(w) + "." + std::to_string(i), "tuning");
+                }
+                writing--;
+            });
+        }
+        threads.emplace_back([&] {
+            while (writing > 0) {
+                Json::Value result;
+                Json::Reader().parse(engine.searchWithContext("deadlock orders", "database", 1), result);
+                const std::string solution = result["suggestions"][0]["solution"].asString();
+                if (solution.rfind("Retry", 0) != 0) consistent = false;
+                searches++;
+            }
+        });
+        finishesWithin(60, [&] {
+            for (auto& thread : threads) thread.join();
+        });
+        const MemoryEntryAggregate* entry = engine.getMemoryEntry(entry_id);
+        consistent = consistent && entry->getVersion() == 1 + WRITERS * UPDATES;
+        final_solution = entry->getSolution();
+    }
+    check(consistent && searches > 0, "readers search while commands store their events (" +
+                                      std::to_string(searches.load()) + " searches)");
+
+    DomainMemoryEngine engine;
+    engine.initializeDomain(CATEGORIES);
+    engine.openEventStore(directory);
+    const MemoryEntryAggregate* entry = engine.getMemoryEntry(entry_id);
+    check(entry && entry->getVersion() == 1 + WRITERS * UPDATES && entry->getSolution() == final_solution,
+          "concurrent commands replay to the live state");
+    std::filesystem::remove_all(directory);
+}
+
+void testUseCountFlushes() {
+    std::printf("\nUse count flushes\n");
+
+    StringInterner strings;
+    SolutionCache cache(strings);
+    cache.addSolution("deadlock on orders table", Solution("Retry"));
+    cache.findSolution("deadlock on orders table");
+
+    // Collected counts that never reach the log are collected again by the next flush
+    auto collect = [&](SolutionCache::UseCountBatch& batch) {
+        std::vector<uint32_t> counts;
+        cache.collectUseCounts([&](std::string_view, const Solution& solution) {
+            counts.push_back(solution.use_count);
+        }, batch);
+        return counts;
+    };
+    EpochGuard guard;
+    SolutionCache::UseCountBatch failed;
+    bool collected = collect(failed) == std::vector<uint32_t>{2};
+    cache.finishUseCounts(failed, false);
+    SolutionCache::UseCountBatch retried;
+    check(collected && collect(retried) == std::vector<uint32_t>{2}, "a failed flush leaves its counts unlogged");
+    cache.finishUseCounts(retried, true);
+    SolutionCache::UseCountBatch settled;
+    check(collect(settled).empty(), "a logged flush marks its counts logged");
+
+    // Racing hits at the limit must not wrap the count to zero
+    Solution counted;
+    counted.use_count = UINT32_MAX - 4;
+    std::vector<std::thread> hitters;
+    for (int t = 0; t < 4; ++t) {
+        hitters.emplace_back([&] {
+            for (int i = 0; i < 1000; ++i) counted.use_count.increment();
+        });
+    }
+    for (auto& hitter : hitters) hitter.join();
+    check(counted.use_count == UINT32_MAX && counted.use_count.increment() == UINT32_MAX,
+          "concurrent hits stop at UINT32_MAX");
+}
+
+// Mappings of path in this process, counted from /proc/self/maps
+int mappingCount(const std::string& path) {
+    std::ifstream maps("/proc/self/maps");
+    int count = 0;
+    for (std::string line; std::getline(maps, line);) {
+        if (line.find(path) != std::string::npos) count++;
+    }
+    return count;
+}
+
+void testSnapshotMappingsReleased() {
+    std::printf("\nSnapshot mappings\n");
+
+    std::string directory = temporaryDirectory();
+    std::string snapshot_path = directory + "/memory.snap";
+    {
+        MemoryEngine engine;
+        engine.initialize(CATEGORIES);
+        engine.storeSolution("deadlock on orders table", "database", "Retry", false);
+        engine.saveSnapshot(snapshot_path);
+    }
+
+    // Each load replaces the last one, and an entry shadowing the snapshot copies its text
+    EnhancedMemoryEngine engine;
+    engine.initialize(CATEGORIES);
+    for (int i = 0; i < 20; ++i) {
+        engine.loadSnapshot(snapshot_path);
+    }
+    engine.storeSolution("deadlock on orders table", "database", "Retry later", false);
+    engine.loadSnapshot(snapshot_path);
+    EpochManager::instance().reclaim();
+    check(mappingCount(snapshot_path) == 1, "replaced snapshots are unmapped (" +
+                                            std::to_string(mappingCount(snapshot_path)) + " mapped)");
+
+    EpochGuard guard;
+    auto ranked = engine.findRankedSolutions("deadlock on orders table", "database", 5);
+    bool seeded = ranked.size() == 2 && std::any_of(ranked.begin(), ranked.end(), [](const auto& solution) {
+        return solution.first.solution.content == "Retry";
+    });
+    check(seeded, "an entry seeded from a snapshot keeps its text");
+    std::filesystem::remove_all(directory);
+}
+
+void testCompactionKeepsStores() {
+    std::printf("\nWrite-ahead log compaction\n");
+
+    std::string directory = temporaryDirectory();
+    std::string log_path = directory + "/memory.wal";
+    std::string snapshot_path = directory + "/memory.snap";
+    constexpr int THREADS = 32;
+    constexpr int STORES = 60;
+
+    // With sync_commit a store waits on the log until a rotation makes its record durable,
+    // then applies it while the snapshot is being written
+    WalOptions options;
+    options.compact_bytes = 0;
+    int compactions = 0;
+    {
+        MemoryEngine engine;
+        engine.initialize(CATEGORIES);
+        engine.openWriteAheadLog(log_path, snapshot_path, options);
+        // A full cache keeps each snapshot walk long enough for stores to land behind it
+        std::unordered_map<std::string, std::string> existing;
+        for (int i = 0; i < 5000; ++i) {
+            existing.emplace("SQL error " + std::to_string(i), "Quote column " + std::to_string(i));
+        }
+        engine.loadSolutions("database", existing, false);
+
+        // Every store is acknowledged while compactions rotate the log underneath it
+        std::atomic<int> running{THREADS};
+        std::vector<std::thread> writers;
+        for (int t = 0; t < THREADS; ++t) {
+            writers.emplace_back([&, t] {
+                for (int i = 0; i < STORES; ++i) {
+                    std::string id = std::to_string(t) + "_" + std::to_string(i);
+                    engine.storeSolution("deadlock in job " + id, "database", "Retry job " + id, false);
+                }
+                running--;
+            });
+        }
+        while (running > 0) {
+            if (engine.compact()) compactions++;
+        }
+        for (auto& writer : writers) writer.join();
+    }
+
+    MemoryEngine reopened;
+    reopened.initialize(CATEGORIES);
+    bool loaded = reopened.loadSnapshot(snapshot_path) && reopened.openWriteAheadLog(log_path, snapshot_path, options);
+    int found = 0;
+    for (int t = 0; t < THREADS; ++t) {
+        for (int i = 0; i < STORES; ++i) {
+            std::string id = std::to_string(t) + "_" + std::to_string(i);
+            auto result = reopened.findSolution("deadlock in job " + id, "database");
+            if (result && result->solution.content == "Retry job " + id) found++;
+        }
+    }
+    check(loaded && compactions > 0 && found == THREADS * STORES,
+          "stores made during compaction survive a reopen (" + std::to_string(found) + "/" +
+          std::to_string(THREADS * STORES) + " after " + std::to_string(compactions) + " compactions)");
+    std::filesystem::remove_all(directory);
+}
+
+} // namespace
+
+int main() {
+    std::printf("Domain engine tests\n");
+
+    testOverflowPolicies();
+    testDispatch();
+    testPayloadJson();
+    testCommandsPublishOutsideEngineLock();
+    testEventStore();
+    testEventSourcing();
+    testCommandsWithReaders();
+    testUseCountFlushes();
+    testSnapshotMappingsReleased();
+    testCompactionKeepsStores();
+
+    std::printf("\n%s\n", failures ? "FAIL" : "PASS");
+    return failures;
+}
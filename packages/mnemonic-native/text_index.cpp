@@ -0,0 +1,292 @@
+#include "text_index.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <queue>
+
+namespace brains {
+
+namespace {
+
+std::vector<std::string> uniqueTokens(const std::string& text, size_t min_length) {
+    auto tokens = tokenizeText(text, min_length);
+    std::sort(tokens.begin(), tokens.end());
+    tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+    return tokens;
+}
+
+// Lowercased alphanumeric words joined by single spaces and padded at both
+// ends, so word boundaries contribute their own trigrams
+std::vector<uint32_t> trigrams(const std::string& text) {
+    std::string normalised = " ";
+    for (const auto& token : tokenizeText(text)) {
+        normalised += token;
+        normalised += ' ';
+    }
+
+    std::vector<uint32_t> result;
+    for (size_t i = 0; i + 3 <= normalised.size(); ++i) {
+        result.push_back((static_cast<uint32_t>(static_cast<unsigned char>(normalised[i])) << 16) |
+                         (static_cast<uint32_t>(static_cast<unsigned char>(normalised[i + 1])) << 8) |
+                         static_cast<uint32_t>(static_cast<unsigned char>(normalised[i + 2])));
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+template<typename T>
+double diceCoefficient(const std::vector<T>& a, const std::vector<T>& b) {
+    if (a.empty() || b.empty()) {
+        return 0.0;
+    }
+    size_t shared = 0;
+    auto ia = a.begin();
+    auto ib = b.begin();
+    while (ia != a.end() && ib != b.end()) {
+        if (*ia < *ib) {
+            ++ia;
+        } else if (*ib < *ia) {
+            ++ib;
+        } else {
+            ++shared; ++ia; ++ib;
+        }
+    }
+    return 2.0 * shared / (a.size() + b.size());
+}
+
+} // anonymous namespace
+
+std::vector<std::string> tokenizeText(const std::string& text, size_t min_length) {
+    std::vector<std::string> tokens;
+    std::string current;
+
+    for (unsigned char c : text) {
+        if (std::isalnum(c) || c >= 0x80) {
+            current.push_back(static_cast<char>(std::tolower(c)));
+        } else if (!current.empty()) {
+            if (current.size() >= min_length) tokens.push_back(current);
+            current.clear();
+        }
+    }
+    if (!current.empty() && current.size() >= min_length) {
+        tokens.push_back(current);
+    }
+
+    return tokens;
+}
+
+// ProblemMatchIndex Implementation
+void ProblemMatchIndex::add(const std::string& problem) {
+    if (problem_ids.find(problem) != problem_ids.end()) {
+        return;
+    }
+
+    uint32_t id = static_cast<uint32_t>(problems.size());
+    problems.push_back(problem);
+    problem_ids.emplace(problem, id);
+    problem_trigrams.push_back(trigrams(problem));
+    problem_tokens.push_back(uniqueTokens(problem, MIN_TOKEN_LENGTH));
+
+    for (const auto& token : problem_tokens.back()) {
+        token_postings[token].push_back(id);
+    }
+}
+
+std::vector<ProblemMatchIndex::Match> ProblemMatchIndex::findMatches(const std::string& query,
+                                                                     double min_score,
+                                                                     size_t max_matches) const {
+    std::vector<Match> matches;
+    auto query_tokens = uniqueTokens(query, MIN_TOKEN_LENGTH);
+    if (query_tokens.empty() || max_matches == 0) {
+        return matches;
+    }
+
+    // Candidates share at least one token; rank them by shared token count
+    std::unordered_map<uint32_t, uint32_t> shared_counts;
+    for (const auto& token : query_tokens) {
+        auto it = token_postings.find(token);
+        if (it == token_postings.end()) continue;
+        for (uint32_t id : it->second) {
+            shared_counts[id]++;
+        }
+    }
+    if (shared_counts.empty()) {
+        return matches;
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> candidates(shared_counts.begin(), shared_counts.end());
+    if (candidates.size() > MAX_SCORED_CANDIDATES) {
+        std::nth_element(candidates.begin(), candidates.begin() + MAX_SCORED_CANDIDATES, candidates.end(),
+                         [](const auto& a, const auto& b) { return a.second > b.second; });
+        candidates.resize(MAX_SCORED_CANDIDATES);
+    }
+
+    // Score = token overlap blended with trigram similarity
+    auto query_trigrams = trigrams(query);
+    for (const auto& [id, shared] : candidates) {
+        double token_score = 2.0 * shared / (query_tokens.size() + problem_tokens[id].size());
+        double trigram_score = diceCoefficient(query_trigrams, problem_trigrams[id]);
+        double score = query_trigrams == problem_trigrams[id] ? 1.0 : 0.4 * token_score + 0.6 * trigram_score;
+        if (score >= min_score) {
+            matches.push_back({problems[id], score});
+        }
+    }
+
+    std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+        return a.score != b.score ? a.score > b.score : a.problem < b.problem;
+    });
+    if (matches.size() > max_matches) {
+        matches.resize(max_matches);
+    }
+    return matches;
+}
+
+void ProblemMatchIndex::clear() {
+    problems.clear();
+    problem_trigrams.clear();
+    problem_tokens.clear();
+    problem_ids.clear();
+    token_postings.clear();
+}
+
+// FullTextIndex Implementation
+void FullTextIndex::addDocument(const std::string& doc_id, const std::string& title,
+                                const std::string& body, const std::string& tag) {
+    removeDocument(doc_id);
+
+    std::unordered_map<std::string, uint32_t> frequencies;
+    uint32_t length = 0;
+    for (const auto& token : tokenizeText(title, 2)) {
+        frequencies[token] += TITLE_WEIGHT;
+        length += TITLE_WEIGHT;
+    }
+    for (const auto& token : tokenizeText(body, 2)) {
+        frequencies[token]++;
+        length++;
+    }
+
+    uint32_t slot;
+    if (!free_slots.empty()) {
+        slot = free_slots.back();
+        free_slots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(documents.size());
+        documents.emplace_back();
+    }
+
+    Document& document = documents[slot];
+    document.id = doc_id;
+    document.tag = tag;
+    document.length = length;
+    document.live = true;
+    document.terms.clear();
+    document.terms.reserve(frequencies.size());
+
+    for (const auto& [term, frequency] : frequencies) {
+        auto& list = postings[term];
+        // Reused slots can be lower than existing postings; keep the list sorted
+        auto pos = std::lower_bound(list.begin(), list.end(), slot,
+                                    [](const Posting& p, uint32_t doc) { return p.doc < doc; });
+        list.insert(pos, Posting{slot, frequency});
+        document.terms.push_back(term);
+    }
+
+    doc_index.emplace(doc_id, slot);
+    total_length += length;
+}
+
+bool FullTextIndex::removeDocument(const std::string& doc_id) {
+    auto it = doc_index.find(doc_id);
+    if (it == doc_index.end()) {
+        return false;
+    }
+
+    uint32_t slot = it->second;
+    Document& document = documents[slot];
+    for (const auto& term : document.terms) {
+        auto list_it = postings.find(term);
+        if (list_it == postings.end()) continue;
+        auto& list = list_it->second;
+        auto pos = std::lower_bound(list.begin(), list.end(), slot,
+                                    [](const Posting& p, uint32_t doc) { return p.doc < doc; });
+        if (pos != list.end() && pos->doc == slot) {
+            list.erase(pos);
+        }
+        if (list.empty()) {
+            postings.erase(list_it);
+        }
+    }
+
+    total_length -= document.length;
+    document = Document();
+    free_slots.push_back(slot);
+    doc_index.erase(it);
+    return true;
+}
+
+std::vector<FullTextIndex::Hit> FullTextIndex::search(const std::string& query, size_t max_results,
+                                                      const std::string& tag) const {
+    std::vector<Hit> hits;
+    if (max_results == 0 || doc_index.empty()) {
+        return hits;
+    }
+
+    auto terms = uniqueTokens(query, 2);
+    double doc_count = static_cast<double>(doc_index.size());
+    double avg_length = static_cast<double>(total_length) / doc_count;
+
+    // Term-at-a-time accumulation into per-slot scores
+    std::vector<double> scores(documents.size(), 0.0);
+    std::vector<uint32_t> touched;
+    for (const auto& term : terms) {
+        auto it = postings.find(term);
+        if (it == postings.end()) continue;
+
+        double df = static_cast<double>(it->second.size());
+        double idf = std::log(1.0 + (doc_count - df + 0.5) / (df + 0.5));
+
+        for (const auto& posting : it->second) {
+            const Document& document = documents[posting.doc];
+            if (!tag.empty() && document.tag != tag) continue;
+
+            double tf = posting.frequency;
+            double norm = K1 * (1.0 - B + B * document.length / avg_length);
+            if (scores[posting.doc] == 0.0) {
+                touched.push_back(posting.doc);
+            }
+            scores[posting.doc] += idf * tf * (K1 + 1.0) / (tf + norm);
+        }
+    }
+
+    // Bounded min-heap keeps the best max_results documents
+    auto better = [&](uint32_t a, uint32_t b) {
+        return scores[a] != scores[b] ? scores[a] > scores[b] : documents[a].id < documents[b].id;
+    };
+    std::priority_queue<uint32_t, std::vector<uint32_t>, decltype(better)> heap(better);
+    for (uint32_t slot : touched) {
+        if (heap.size() < max_results) {
+            heap.push(slot);
+        } else if (better(slot, heap.top())) {
+            heap.pop();
+            heap.push(slot);
+        }
+    }
+
+    hits.resize(heap.size());
+    for (size_t i = hits.size(); i-- > 0; heap.pop()) {
+        const Document& document = documents[heap.top()];
+        hits[i] = Hit{document.id, document.tag, scores[heap.top()]};
+    }
+    return hits;
+}
+
+void FullTextIndex::clear() {
+    documents.clear();
+    free_slots.clear();
+    doc_index.clear();
+    postings.clear();
+    total_length = 0;
+}
+
+} // namespace brains
@@ -0,0 +1,140 @@
+#ifndef TEXT_INDEX_H
+#define TEXT_INDEX_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace brains {
+
+/**
+ * @brief Split text into lowercase alphanumeric tokens
+ * @param text Text to tokenize
+ * @param min_length Tokens shorter than this are dropped
+ * @return Tokens in text order (duplicates preserved)
+ */
+std::vector<std::string> tokenizeText(const std::string& text, size_t min_length = 1);
+
+/**
+ * @brief Approximate-match index over stored problem strings
+ *
+ * A token inverted index narrows the search to problems sharing at least one
+ * meaningful word with the query; candidates are then scored by a blend of
+ * token overlap and character trigram similarity.
+ */
+class ProblemMatchIndex {
+public:
+    /**
+     * @brief Scored approximate match
+     */
+    struct Match {
+        std::string problem;
+        double score; // 1.0 for normalised-identical problems
+    };
+
+    /**
+     * @brief Index a problem; re-adding an indexed problem is a no-op
+     */
+    void add(const std::string& problem);
+
+    /**
+     * @brief Find the best-scoring indexed problems for a query
+     * @param query Problem text to match
+     * @param min_score Minimum similarity in [0, 1]
+     * @param max_matches Maximum number of matches to return
+     * @return Matches ordered by descending score
+     */
+    std::vector<Match> findMatches(const std::string& query, double min_score, size_t max_matches = 1) const;
+
+    void clear();
+    size_t size() const { return problems.size(); }
+
+private:
+    static constexpr size_t MIN_TOKEN_LENGTH = 3;
+    static constexpr size_t MAX_SCORED_CANDIDATES = 64;
+
+    std::vector<std::string> problems;
+    std::vector<std::vector<uint32_t>> problem_trigrams;  // Sorted, unique
+    std::vector<std::vector<std::string>> problem_tokens; // Sorted, unique
+    std::unordered_map<std::string, uint32_t> problem_ids;
+    std::unordered_map<std::string, std::vector<uint32_t>> token_postings;
+};
+
+/**
+ * @brief BM25-ranked inverted index over title/body documents
+ *
+ * Postings are kept per term in ascending document order. Title terms count
+ * TITLE_WEIGHT times towards a document's term frequency, so problem text
+ * outranks incidental matches in solution text. Documents may be replaced
+ * or removed; their postings are updated in place.
+ */
+class FullTextIndex {
+public:
+    /**
+     * @brief Ranked search result
+     */
+    struct Hit {
+        std::string doc_id;
+        std::string tag;
+        double score;
+    };
+
+    /**
+     * @brief Index a document, replacing any document with the same id
+     * @param doc_id Caller-defined document identifier
+     * @param title Heavily weighted text (e.g. the problem)
+     * @param body Regular text (e.g. the solution)
+     * @param tag Optional filter tag (e.g. the category)
+     */
+    void addDocument(const std::string& doc_id, const std::string& title,
+                     const std::string& body, const std::string& tag = "");
+
+    /**
+     * @brief Remove a document
+     * @return true if the document was indexed
+     */
+    bool removeDocument(const std::string& doc_id);
+
+    /**
+     * @brief Rank documents against a free-text query
+     * @param query Query text
+     * @param max_results Number of hits to return
+     * @param tag Restrict results to documents with this tag (empty for all)
+     * @return Hits ordered by descending BM25 score
+     */
+    std::vector<Hit> search(const std::string& query, size_t max_results,
+                            const std::string& tag = "") const;
+
+    void clear();
+    size_t size() const { return doc_index.size(); }
+    size_t termCount() const { return postings.size(); }
+
+private:
+    static constexpr uint32_t TITLE_WEIGHT = 2;
+    static constexpr double K1 = 1.2;
+    static constexpr double B = 0.75;
+
+    struct Posting {
+        uint32_t doc;
+        uint32_t frequency;
+    };
+
+    struct Document {
+        std::string id;
+        std::string tag;
+        uint32_t length = 0;
+        bool live = false;
+        std::vector<std::string> terms; // Unique terms, for removal
+    };
+
+    std::vector<Document> documents; // Slots of removed documents are reused
+    std::vector<uint32_t> free_slots;
+    std::unordered_map<std::string, uint32_t> doc_index;
+    std::unordered_map<std::string, std::vector<Posting>> postings;
+    uint64_t total_length = 0;
+};
+
+} // namespace brains
+
+#endif // TEXT_INDEX_H
@@ -0,0 +1,410 @@
+#include "wal.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace brains {
+
+namespace {
+
+constexpr size_t FRAME_HEADER_SIZE = 8;
+constexpr uint32_t MAX_RECORD_SIZE = 64u << 20;
+
+// Slicing-by-8 tables: table[k][b] is the CRC of byte b followed by k zero bytes
+using CrcTables = uint32_t[8][256];
+
+const CrcTables& crcTables() {
+    static const CrcTables& tables = []() -> const CrcTables& {
+        static CrcTables entries;
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                value = (value & 1) ? (value >> 1) ^ 0xEDB88320u : value >> 1;
+            }
+            entries[0][i] = value;
+        }
+        for (uint32_t i = 0; i < 256; ++i) {
+            for (int k = 1; k < 8; ++k) {
+                entries[k][i] = (entries[k - 1][i] >> 8) ^ entries[0][entries[k - 1][i] & 0xFF];
+            }
+        }
+        return entries;
+    }();
+    return tables;
+}
+
+template<typename T>
+void putInt(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void putString(std::string& out, const std::string& value) {
+    putInt(out, static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+
+template<typename T>
+bool getInt(const char*& cursor, const char* end, T& value) {
+    if (static_cast<size_t>(end - cursor) < sizeof(value)) return false;
+    std::memcpy(&value, cursor, sizeof(value));
+    cursor += sizeof(value);
+    return true;
+}
+
+bool getString(const char*& cursor, const char* end, std::string& value) {
+    uint32_t length;
+    if (!getInt(cursor, end, length) || static_cast<size_t>(end - cursor) < length) return false;
+    value.assign(cursor, length);
+    cursor += length;
+    return true;
+}
+
+void encode(const WalRecord& record, std::string& out) {
+    std::string payload;
+    putInt(payload, static_cast<uint8_t>(record.type));
+    putInt(payload, static_cast<uint8_t>(record.is_global ? 1 : 0));
+    putInt(payload, static_cast<uint16_t>(0));
+    putInt(payload, record.use_count);
+    putInt(payload, record.created);
+    putString(payload, record.category);
+    putString(payload, record.problem);
+    putString(payload, record.content);
+
+    putInt(out, static_cast<uint32_t>(payload.size()));
+    putInt(out, crc32(payload.data(), payload.size()));
+    out.append(payload);
+}
+
+bool decode(const char* cursor, const char* end, WalRecord& record) {
+    uint8_t type, flags;
+    uint16_t reserved;
+    if (!getInt(cursor, end, type) || !getInt(cursor, end, flags) || !getInt(cursor, end, reserved) ||
+        !getInt(cursor, end, record.use_count) || !getInt(cursor, end, record.created) ||
+        !getString(cursor, end, record.category) || !getString(cursor, end, record.problem) ||
+        !getString(cursor, end, record.content)) {
+        return false;
+    }
+    if (type != static_cast<uint8_t>(WalRecord::Type::STORE_SOLUTION) &&
+        type != static_cast<uint8_t>(WalRecord::Type::USE_COUNT)) {
+        return false;
+    }
+    record.type = static_cast<WalRecord::Type>(type);
+    record.is_global = (flags & 1) != 0;
+    return cursor == end;
+}
+
+int openForAppend(const std::string& path) {
+#ifdef _WIN32
+    return ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#endif
+}
+
+bool syncFile(int fd) {
+#ifdef _WIN32
+    return ::_commit(fd) == 0;
+#elif defined(__linux__)
+    return ::fdatasync(fd) == 0;
+#else
+    return ::fsync(fd) == 0;
+#endif
+}
+
+void closeFile(int fd) {
+#ifdef _WIN32
+    ::_close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+bool truncateFile(int fd, uint64_t length) {
+#ifdef _WIN32
+    return ::_chsize_s(fd, static_cast<__int64>(length)) == 0;
+#else
+    return ::ftruncate(fd, static_cast<off_t>(length)) == 0;
+#endif
+}
+
+// Makes a newly created or renamed log entry itself durable
+void syncParentDirectory(const std::string& path) {
+#ifndef _WIN32
+    size_t slash = path.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int dir_fd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (dir_fd >= 0) {
+        ::fsync(dir_fd);
+        ::close(dir_fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+} // namespace
+
+uint32_t crc32(const char* data, size_t length) {
+    const CrcTables& table = crcTables();
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    uint32_t crc = 0xFFFFFFFFu;
+
+    // Eight bytes per step; the words are assembled bytewise, so any byte order works
+    for (; length >= 8; bytes += 8, length -= 8) {
+        uint32_t low = crc ^ (uint32_t(bytes[0]) | uint32_t(bytes[1]) << 8 |
+                              uint32_t(bytes[2]) << 16 | uint32_t(bytes[3]) << 24);
+        crc = table[7][low & 0xFF] ^ table[6][(low >> 8) & 0xFF] ^
+              table[5][(low >> 16) & 0xFF] ^ table[4][low >> 24] ^
+              table[3][bytes[4]] ^ table[2][bytes[5]] ^ table[1][bytes[6]] ^ table[0][bytes[7]];
+    }
+    for (; length > 0; ++bytes, --length) {
+        crc = table[0][(crc ^ *bytes) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// WriteAheadLog Implementation
+WriteAheadLog::WriteAheadLog(const WalOptions& options) : options(options) {}
+
+WriteAheadLog::~WriteAheadLog() {
+    close();
+    if (compactor.joinable()) {
+        compactor.join();
+    }
+}
+
+bool WriteAheadLog::open(const std::string& log_path) {
+    if (fd >= 0) return false;
+
+    uint64_t valid_length = replay(log_path, [](const WalRecord&) {});
+
+    fd = openForAppend(log_path);
+    if (fd < 0) return false;
+
+    // Drop a torn tail so new records are not hidden behind it
+    if (!truncateFile(fd, valid_length) || !syncFile(fd)) {
+        closeFile(fd);
+        fd = -1;
+        return false;
+    }
+    syncParentDirectory(log_path);
+
+    path = log_path;
+    log_bytes = valid_length;
+    stopping = false;
+    failed = false;
+    flusher = std::thread(&WriteAheadLog::flushLoop, this);
+    return true;
+}
+
+bool WriteAheadLog::append(const WalRecord& record) {
+    return append(&record, 1);
+}
+
+bool WriteAheadLog::append(const WalRecord* records, size_t count) {
+    std::string frames;
+    for (size_t i = 0; i < count; ++i) {
+        encode(records[i], frames);
+    }
+
+    std::unique_lock<std::mutex> lock(buffer_mutex);
+    if (fd < 0 || stopping || failed) return false;
+
+    pending += frames;
+    uint64_t seq = ++appended_seq;
+    log_bytes += frames.size();
+    work_cv.notify_one();
+
+    if (options.sync_commit) {
+        durable_cv.wait(lock, [&] { return durable_seq >= seq || failed; });
+        return durable_seq >= seq;
+    }
+    return true;
+}
+
+bool WriteAheadLog::flush() {
+    std::unique_lock<std::mutex> lock(buffer_mutex);
+    if (fd < 0) return false;
+
+    uint64_t seq = appended_seq;
+    work_cv.notify_one();
+    durable_cv.wait(lock, [&] { return durable_seq >= seq || failed; });
+    return durable_seq >= seq;
+}
+
+void WriteAheadLog::flushLoop() {
+    for (;;) {
+        bool wrote = false;
+        {
+            // io_mutex is held while waiting so a rotation never interleaves
+            // with a buffer that has been taken but not yet written
+            std::unique_lock<std::mutex> io_lock(io_mutex);
+            std::unique_lock<std::mutex> lock(buffer_mutex);
+            work_cv.wait_for(lock, std::chrono::milliseconds(options.flush_interval_ms),
+                             [this] { return !pending.empty() || stopping; });
+
+            if (pending.empty()) {
+                if (stopping) return;
+                continue;
+            }
+
+            std::string batch;
+            batch.swap(pending);
+            uint64_t target = appended_seq;
+            lock.unlock();
+
+            bool ok = writeAndSync(batch);
+
+            lock.lock();
+            if (ok) {
+                durable_seq = target;
+            } else {
+                failed = true;
+            }
+            durable_cv.notify_all();
+            wrote = ok;
+        }
+
+        if (wrote) {
+            maybeCompact();
+        }
+    }
+}
+
+// Caller must hold io_mutex
+bool WriteAheadLog::writeAndSync(const std::string& data) {
+    const char* cursor = data.data();
+    size_t remaining = data.size();
+    while (remaining > 0) {
+#ifdef _WIN32
+        int written = ::_write(fd, cursor, static_cast<unsigned int>(remaining));
+#else
+        ssize_t written = ::write(fd, cursor, remaining);
+#endif
+        if (written <= 0) return false;
+        cursor += written;
+        remaining -= static_cast<size_t>(written);
+    }
+    return syncFile(fd);
+}
+
+bool WriteAheadLog::rotate(const std::string& rotated_path) {
+    std::lock_guard<std::mutex> io_lock(io_mutex);
+    std::unique_lock<std::mutex> lock(buffer_mutex);
+    if (fd < 0 || failed) return false;
+
+    std::string batch;
+    batch.swap(pending);
+    uint64_t target = appended_seq;
+    lock.unlock();
+
+    bool ok = batch.empty() || writeAndSync(batch);
+    if (ok) {
+        closeFile(fd);
+        fd = -1;
+#ifdef _WIN32
+        std::remove(rotated_path.c_str());
+#endif
+        ok = std::rename(path.c_str(), rotated_path.c_str()) == 0;
+        fd = openForAppend(path);
+        ok = ok && fd >= 0;
+        syncParentDirectory(path);
+    }
+
+    lock.lock();
+    if (ok) {
+        durable_seq = target;
+        log_bytes = 0;
+    } else {
+        failed = true;
+    }
+    durable_cv.notify_all();
+    return ok;
+}
+
+void WriteAheadLog::setCompactionHandler(std::function<void()> handler) {
+    std::lock_guard<std::mutex> lock(buffer_mutex);
+    compaction_handler = std::move(handler);
+}
+
+void WriteAheadLog::maybeCompact() {
+    if (options.compact_bytes == 0 || size() < options.compact_bytes) return;
+
+    std::function<void()> handler;
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex);
+        if (!compaction_handler || stopping) return;
+        handler = compaction_handler;
+    }
+
+    // Only the flusher starts compactions, so the previous thread is ours to join
+    if (compacting.exchange(true)) return;
+    if (compactor.joinable()) {
+        compactor.join();
+    }
+    compactor = std::thread([this, handler] {
+        handler();
+        compacting = false;
+    });
+}
+
+void WriteAheadLog::close() {
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex);
+        if (fd < 0 && !flusher.joinable()) return;
+        stopping = true;
+    }
+    work_cv.notify_all();
+
+    // The flusher writes out whatever is still pending before it exits
+    if (flusher.joinable()) {
+        flusher.join();
+    }
+
+    std::lock_guard<std::mutex> io_lock(io_mutex);
+    std::lock_guard<std::mutex> lock(buffer_mutex);
+    if (fd >= 0) {
+        closeFile(fd);
+        fd = -1;
+    }
+    durable_cv.notify_all();
+}
+
+uint64_t WriteAheadLog::replay(const std::string& log_path, const std::function<void(const WalRecord&)>& visit) {
+    std::ifstream in(log_path, std::ios::binary);
+    if (!in) return 0;
+
+    std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const char* begin = data.data();
+    const char* end = begin + data.size();
+    const char* cursor = begin;
+
+    WalRecord record;
+    while (static_cast<size_t>(end - cursor) >= FRAME_HEADER_SIZE) {
+        uint32_t length, checksum;
+        std::memcpy(&length, cursor, sizeof(length));
+        std::memcpy(&checksum, cursor + sizeof(length), sizeof(checksum));
+
+        const char* payload = cursor + FRAME_HEADER_SIZE;
+        if (length > MAX_RECORD_SIZE || static_cast<size_t>(end - payload) < length) break;
+        if (crc32(payload, length) != checksum || !decode(payload, payload + length, record)) break;
+
+        visit(record);
+        cursor = payload + length;
+    }
+
+    return static_cast<uint64_t>(cursor - begin);
+}
+
+} // namespace brains
@@ -0,0 +1,140 @@
+#ifndef WAL_H
+#define WAL_H
+
+#include <string>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+namespace brains {
+
+/**
+ * @brief CRC-32 (IEEE 802.3) of a byte range
+ */
+uint32_t crc32(const char* data, size_t length);
+
+/**
+ * @brief One logged engine mutation
+ */
+struct WalRecord {
+    enum class Type : uint8_t {
+        STORE_SOLUTION = 1,
+        USE_COUNT = 2 // Raises a stored solution's use_count; replaying it again is harmless
+    };
+
+    Type type = Type::STORE_SOLUTION;
+    bool is_global = false;
+    int64_t created = 0;    // Seconds since the Unix epoch
+    uint32_t use_count = 1; // Absolute, also for USE_COUNT
+    std::string category;
+    std::string problem;
+    std::string content;
+};
+
+/**
+ * @brief Write-ahead log tuning
+ */
+struct WalOptions {
+    bool sync_commit = true;           // append() returns only once the record is on disk
+    uint32_t flush_interval_ms = 5;    // Upper bound on how long a record waits for a group flush
+    uint64_t compact_bytes = 64 << 20; // Log size that triggers the compaction handler; 0 disables
+};
+
+/**
+ * @brief Append-only, CRC-checked log with group commit
+ *
+ * Appenders serialize into a shared buffer; a single flusher thread writes
+ * and fsyncs everything buffered so far in one go, so concurrent writers
+ * share each sync. Each record is framed as
+ * [u32 payload length][u32 CRC-32 of payload][payload]; a torn or corrupt
+ * tail is discarded on replay and truncated when the log is reopened.
+ */
+class WriteAheadLog {
+public:
+    explicit WriteAheadLog(const WalOptions& options = WalOptions());
+    ~WriteAheadLog();
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    /**
+     * @brief Open a log for appending, truncating any invalid tail
+     * @param path Log file; created if missing
+     * @return true if the log is ready for appends
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Append a record
+     * @return false if the log is closed or a write has failed
+     */
+    bool append(const WalRecord& record);
+
+    /**
+     * @brief Append records in order, waiting for one commit for all of them
+     * @return false if the log is closed or a write has failed
+     */
+    bool append(const WalRecord* records, size_t count);
+
+    /**
+     * @brief Block until every appended record is on disk
+     */
+    bool flush();
+
+    /**
+     * @brief Move the current contents to rotated_path and continue in an empty log
+     * @return true if every record appended so far is durable in rotated_path
+     */
+    bool rotate(const std::string& rotated_path);
+
+    /**
+     * @brief Run handler on a background thread whenever the log outgrows compact_bytes
+     */
+    void setCompactionHandler(std::function<void()> handler);
+
+    /**
+     * @brief Bytes in the current log file, including buffered records
+     */
+    uint64_t size() const { return log_bytes.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Read every valid record of a log file in order
+     * @param path Log file; a missing file has no records
+     * @param visit Called once per record
+     * @return Byte length of the valid prefix
+     */
+    static uint64_t replay(const std::string& path, const std::function<void(const WalRecord&)>& visit);
+
+private:
+    WalOptions options;
+    std::string path;
+    int fd = -1;
+
+    std::mutex buffer_mutex;  // Guards pending, sequence numbers and state flags
+    std::mutex io_mutex;      // Serializes file writes, syncs and rotation
+    std::condition_variable work_cv;
+    std::condition_variable durable_cv;
+    std::string pending;
+    uint64_t appended_seq = 0;
+    uint64_t durable_seq = 0;
+    bool stopping = false;
+    bool failed = false;
+    std::atomic<uint64_t> log_bytes{0};
+
+    std::thread flusher;
+    std::thread compactor;
+    std::atomic<bool> compacting{false};
+    std::function<void()> compaction_handler;
+
+    void flushLoop();
+    bool writeAndSync(const std::string& data);
+    void maybeCompact();
+    void close();
+};
+
+} // namespace brains
+
+#endif // WAL_H